@@ -22,7 +22,6 @@
     buildInputs = with pkgs; [
       glib
       wireplumber
-      # json-glib
     ];
   in {
     packages.${system} = rec {
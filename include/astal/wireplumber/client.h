@@ -0,0 +1,28 @@
+#ifndef ASTAL_WP_CLIENT_H
+#define ASTAL_WP_CLIENT_H
+
+#include <glib-object.h>
+
+#include "endpoint.h"
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_CLIENT (astal_wp_client_get_type())
+
+G_DECLARE_FINAL_TYPE(AstalWpClient, astal_wp_client, ASTAL_WP, CLIENT, GObject)
+
+guint astal_wp_client_get_id(AstalWpClient *self);
+const gchar *astal_wp_client_get_name(AstalWpClient *self);
+const gchar *astal_wp_client_get_icon(AstalWpClient *self);
+const gchar *astal_wp_client_get_binary(AstalWpClient *self);
+gint astal_wp_client_get_pid(AstalWpClient *self);
+GList *astal_wp_client_get_streams(AstalWpClient *self);
+
+gdouble astal_wp_client_get_volume(AstalWpClient *self);
+void astal_wp_client_set_volume(AstalWpClient *self, gdouble volume);
+gboolean astal_wp_client_get_mute(AstalWpClient *self);
+void astal_wp_client_set_mute(AstalWpClient *self, gboolean mute);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_CLIENT_H
@@ -1,9 +1,12 @@
 #ifndef ASTAL_WP_DEVICE_H
 #define ASTAL_WP_DEVICE_H
 
+#include <gio/gio.h>
 #include <glib-object.h>
 
+#include "port.h"
 #include "profile.h"
+#include "route.h"
 
 G_BEGIN_DECLS
 
@@ -20,9 +23,22 @@ const gchar *astal_wp_device_get_description(AstalWpDevice *self);
 const gchar *astal_wp_device_get_icon(AstalWpDevice *self);
 AstalWpProfile *astal_wp_device_get_profile(AstalWpDevice *self, gint id);
 GList *astal_wp_device_get_profiles(AstalWpDevice *self);
+AstalWpAvailability astal_wp_device_get_profile_available(AstalWpDevice *self, gint id);
+GList *astal_wp_device_get_available_profiles(AstalWpDevice *self);
+AstalWpProfile *astal_wp_device_get_best_profile(AstalWpDevice *self);
 void astal_wp_device_set_active_profile(AstalWpDevice *self, int profile_id);
+void astal_wp_device_set_active_profile_async(AstalWpDevice *self, gint profile_id,
+                                              GCancellable *cancellable,
+                                              GAsyncReadyCallback callback, gpointer user_data);
+gboolean astal_wp_device_set_active_profile_finish(AstalWpDevice *self, GAsyncResult *result,
+                                                   gint64 *round_trip, GError **error);
 gint astal_wp_device_get_active_profile(AstalWpDevice *self);
 AstalWpDeviceType astal_wp_device_get_device_type(AstalWpDevice *self);
+AstalWpRoute *astal_wp_device_get_route(AstalWpDevice *self, gint index);
+GList *astal_wp_device_get_routes(AstalWpDevice *self);
+AstalWpRoute *astal_wp_device_get_active_route(AstalWpDevice *self, AstalWpDirection direction);
+void astal_wp_device_set_active_route(AstalWpDevice *self, AstalWpRoute *route);
+GList *astal_wp_device_get_endpoints(AstalWpDevice *self);
 
 G_END_DECLS
 
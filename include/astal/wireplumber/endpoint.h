@@ -1,8 +1,14 @@
 #ifndef ASTAL_WP_ENDPOINT_H
 #define ASTAL_WP_ENDPOINT_H
 
+#include <gio/gio.h>
 #include <glib-object.h>
 
+#include "device.h"
+#include "link.h"
+#include "port.h"
+#include "scale.h"
+
 G_BEGIN_DECLS
 
 #define ASTAL_WP_TYPE_ENDPOINT (astal_wp_endpoint_get_type())
@@ -22,12 +28,70 @@ typedef enum {
     ASTAL_WP_MEDIA_CLASS_VIDEO_STREAM,
 } AstalWpMediaClass;
 
+#define ASTAL_WP_TYPE_RAMP_CURVE (astal_wp_ramp_curve_get_type())
+
+/**
+ * AstalWpRampCurve:
+ * @ASTAL_WP_RAMP_CURVE_LINEAR: change the volume at a constant rate
+ * @ASTAL_WP_RAMP_CURVE_EASE_IN: start slow and speed up
+ * @ASTAL_WP_RAMP_CURVE_EASE_OUT: start fast and slow down
+ * @ASTAL_WP_RAMP_CURVE_EASE_IN_OUT: start and end slow
+ */
+typedef enum {
+    ASTAL_WP_RAMP_CURVE_LINEAR,
+    ASTAL_WP_RAMP_CURVE_EASE_IN,
+    ASTAL_WP_RAMP_CURVE_EASE_OUT,
+    ASTAL_WP_RAMP_CURVE_EASE_IN_OUT,
+} AstalWpRampCurve;
+
 void astal_wp_endpoint_set_volume(AstalWpEndpoint *self, gdouble volume);
+void astal_wp_endpoint_set_volume_async(AstalWpEndpoint *self, gdouble volume,
+                                        GCancellable *cancellable, GAsyncReadyCallback callback,
+                                        gpointer user_data);
+gboolean astal_wp_endpoint_set_volume_finish(AstalWpEndpoint *self, GAsyncResult *result,
+                                             gint64 *round_trip, GError **error);
+void astal_wp_endpoint_ramp_volume(AstalWpEndpoint *self, gdouble volume, guint duration_ms,
+                                   AstalWpRampCurve curve);
+guint astal_wp_endpoint_get_n_channels(AstalWpEndpoint *self);
+const gchar *const *astal_wp_endpoint_get_channel_map(AstalWpEndpoint *self);
+const gdouble *astal_wp_endpoint_get_channel_volumes(AstalWpEndpoint *self, guint *n_channels);
+guint astal_wp_endpoint_get_channel_volumes_float(AstalWpEndpoint *self, gfloat *volumes,
+                                                  guint n_channels);
+gdouble astal_wp_endpoint_get_channel_volume(AstalWpEndpoint *self, guint channel);
+void astal_wp_endpoint_set_channel_volumes(AstalWpEndpoint *self, const gdouble *volumes,
+                                           guint n_channels);
+void astal_wp_endpoint_set_channel_volumes_float(AstalWpEndpoint *self, const gfloat *volumes,
+                                                 guint n_channels);
+void astal_wp_endpoint_set_channel_volume(AstalWpEndpoint *self, guint channel, gdouble volume);
+guint astal_wp_endpoint_get_channel_volumes_in_scale(AstalWpEndpoint *self, AstalWpScale scale,
+                                                     gdouble *volumes, guint n_channels);
+
+gdouble astal_wp_endpoint_get_volume_in_scale(AstalWpEndpoint *self, AstalWpScale scale);
+void astal_wp_endpoint_set_volume_in_scale(AstalWpEndpoint *self, AstalWpScale scale,
+                                           gdouble volume);
+AstalWpScale astal_wp_endpoint_get_scale(AstalWpEndpoint *self);
+void astal_wp_endpoint_set_scale(AstalWpEndpoint *self, AstalWpScale scale);
+void astal_wp_endpoint_set_scale_func(AstalWpEndpoint *self, AstalWpScaleFunc func, gpointer data,
+                                      GDestroyNotify destroy);
+void astal_wp_endpoint_unset_scale(AstalWpEndpoint *self);
 void astal_wp_endpoint_set_mute(AstalWpEndpoint *self, gboolean mute);
+void astal_wp_endpoint_set_mute_async(AstalWpEndpoint *self, gboolean mute,
+                                      GCancellable *cancellable, GAsyncReadyCallback callback,
+                                      gpointer user_data);
+gboolean astal_wp_endpoint_set_mute_finish(AstalWpEndpoint *self, GAsyncResult *result,
+                                           gint64 *round_trip, GError **error);
 gboolean astal_wp_endpoint_get_is_default(AstalWpEndpoint *self);
 void astal_wp_endpoint_set_is_default(AstalWpEndpoint *self, gboolean is_default);
+void astal_wp_endpoint_set_is_default_async(AstalWpEndpoint *self, GCancellable *cancellable,
+                                            GAsyncReadyCallback callback, gpointer user_data);
+gboolean astal_wp_endpoint_set_is_default_finish(AstalWpEndpoint *self, GAsyncResult *result,
+                                                 gint64 *round_trip, GError **error);
 gboolean astal_wp_endpoint_get_lock_channels(AstalWpEndpoint *self);
 void astal_wp_endpoint_set_lock_channels(AstalWpEndpoint *self, gboolean lock_channels);
+AstalWpEndpoint *astal_wp_endpoint_get_target(AstalWpEndpoint *self);
+void astal_wp_endpoint_set_target(AstalWpEndpoint *self, AstalWpEndpoint *target);
+const gchar *astal_wp_endpoint_get_requested_latency(AstalWpEndpoint *self);
+void astal_wp_endpoint_set_requested_latency(AstalWpEndpoint *self, const gchar *latency);
 
 AstalWpMediaClass astal_wp_endpoint_get_media_class(AstalWpEndpoint *self);
 guint astal_wp_endpoint_get_id(AstalWpEndpoint *self);
@@ -37,6 +101,13 @@ const gchar *astal_wp_endpoint_get_description(AstalWpEndpoint *self);
 const gchar *astal_wp_endpoint_get_name(AstalWpEndpoint *self);
 const gchar *astal_wp_endpoint_get_icon(AstalWpEndpoint *self);
 const gchar *astal_wp_endpoint_get_volume_icon(AstalWpEndpoint *self);
+AstalWpDevice *astal_wp_endpoint_get_device(AstalWpEndpoint *self);
+
+GList *astal_wp_endpoint_get_input_links(AstalWpEndpoint *self);
+GList *astal_wp_endpoint_get_output_links(AstalWpEndpoint *self);
+GList *astal_wp_endpoint_get_upstream(AstalWpEndpoint *self);
+GList *astal_wp_endpoint_get_downstream(AstalWpEndpoint *self);
+GList *astal_wp_endpoint_get_ports(AstalWpEndpoint *self);
 
 G_END_DECLS
 
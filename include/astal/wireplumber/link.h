@@ -0,0 +1,33 @@
+#ifndef ASTAL_WP_LINK_H
+#define ASTAL_WP_LINK_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_LINK (astal_wp_link_get_type())
+
+G_DECLARE_FINAL_TYPE(AstalWpLink, astal_wp_link, ASTAL_WP, LINK, GObject)
+
+#define ASTAL_WP_TYPE_LINK_STATE (astal_wp_link_state_get_type())
+
+typedef enum {
+    ASTAL_WP_LINK_STATE_ERROR = -2,
+    ASTAL_WP_LINK_STATE_UNLINKED = -1,
+    ASTAL_WP_LINK_STATE_INIT = 0,
+    ASTAL_WP_LINK_STATE_NEGOTIATING = 1,
+    ASTAL_WP_LINK_STATE_ALLOCATING = 2,
+    ASTAL_WP_LINK_STATE_PAUSED = 3,
+    ASTAL_WP_LINK_STATE_ACTIVE = 4,
+} AstalWpLinkState;
+
+guint astal_wp_link_get_id(AstalWpLink *self);
+guint astal_wp_link_get_output_node(AstalWpLink *self);
+guint astal_wp_link_get_output_port(AstalWpLink *self);
+guint astal_wp_link_get_input_node(AstalWpLink *self);
+guint astal_wp_link_get_input_port(AstalWpLink *self);
+AstalWpLinkState astal_wp_link_get_state(AstalWpLink *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_LINK_H
@@ -0,0 +1,29 @@
+#ifndef ASTAL_WP_PORT_H
+#define ASTAL_WP_PORT_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_PORT (astal_wp_port_get_type())
+
+G_DECLARE_FINAL_TYPE(AstalWpPort, astal_wp_port, ASTAL_WP, PORT, GObject)
+
+#define ASTAL_WP_TYPE_DIRECTION (astal_wp_direction_get_type())
+
+typedef enum {
+    ASTAL_WP_DIRECTION_INPUT,
+    ASTAL_WP_DIRECTION_OUTPUT,
+} AstalWpDirection;
+
+guint astal_wp_port_get_id(AstalWpPort *self);
+guint astal_wp_port_get_node_id(AstalWpPort *self);
+const gchar *astal_wp_port_get_name(AstalWpPort *self);
+const gchar *astal_wp_port_get_channel(AstalWpPort *self);
+AstalWpDirection astal_wp_port_get_direction(AstalWpPort *self);
+gboolean astal_wp_port_get_is_physical(AstalWpPort *self);
+gboolean astal_wp_port_get_is_monitor(AstalWpPort *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_PORT_H
@@ -11,6 +11,10 @@ G_DECLARE_FINAL_TYPE(AstalWpProfile, astal_wp_profile, ASTAL_WP, PROFILE, GObjec
 
 gint astal_wp_profile_get_index(AstalWpProfile *self);
 const gchar *astal_wp_profile_get_description(AstalWpProfile *self);
+const gchar *astal_wp_profile_get_name(AstalWpProfile *self);
+gint astal_wp_profile_get_priority(AstalWpProfile *self);
+const gchar *const *astal_wp_profile_get_classes(AstalWpProfile *self);
+guint astal_wp_profile_get_n_nodes(AstalWpProfile *self, const gchar *media_class);
 
 G_END_DECLS
 
@@ -0,0 +1,38 @@
+#ifndef ASTAL_WP_PROFILER_H
+#define ASTAL_WP_PROFILER_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_DRIVER_STATS (astal_wp_driver_stats_get_type())
+
+/**
+ * AstalWpDriverStats:
+ * @id: the node id of the driver
+ * @timestamp: the monotonic time in microseconds this sample was taken at
+ * @quantum: the number of samples processed per cycle
+ * @rate: the sample rate of the driver
+ * @dsp_load: the fraction of the cycle spent processing the graph
+ * @cpu_load: the cpu load of the PipeWire daemon
+ * @xruns: the number of xruns of this driver
+ *
+ * A sample of the statistics PipeWire reports for a driver.
+ */
+typedef struct {
+    guint id;
+    gint64 timestamp;
+    guint quantum;
+    guint rate;
+    gdouble dsp_load;
+    gdouble cpu_load;
+    guint xruns;
+} AstalWpDriverStats;
+
+GType astal_wp_driver_stats_get_type(void);
+AstalWpDriverStats *astal_wp_driver_stats_copy(const AstalWpDriverStats *self);
+void astal_wp_driver_stats_free(AstalWpDriverStats *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_PROFILER_H
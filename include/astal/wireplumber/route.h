@@ -0,0 +1,41 @@
+#ifndef ASTAL_WP_ROUTE_H
+#define ASTAL_WP_ROUTE_H
+
+#include <glib-object.h>
+
+#include "port.h"
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_ROUTE (astal_wp_route_get_type())
+
+G_DECLARE_FINAL_TYPE(AstalWpRoute, astal_wp_route, ASTAL_WP, ROUTE, GObject)
+
+#define ASTAL_WP_TYPE_AVAILABILITY (astal_wp_availability_get_type())
+
+/**
+ * AstalWpAvailability:
+ * @ASTAL_WP_AVAILABILITY_UNKNOWN: the device can not tell, for example a line out without jack
+ * detection
+ * @ASTAL_WP_AVAILABILITY_NO: nothing is plugged in
+ * @ASTAL_WP_AVAILABILITY_YES: something is plugged in
+ */
+typedef enum {
+    ASTAL_WP_AVAILABILITY_UNKNOWN,
+    ASTAL_WP_AVAILABILITY_NO,
+    ASTAL_WP_AVAILABILITY_YES,
+} AstalWpAvailability;
+
+gint astal_wp_route_get_index(AstalWpRoute *self);
+const gchar *astal_wp_route_get_name(AstalWpRoute *self);
+const gchar *astal_wp_route_get_description(AstalWpRoute *self);
+AstalWpDirection astal_wp_route_get_direction(AstalWpRoute *self);
+guint astal_wp_route_get_priority(AstalWpRoute *self);
+AstalWpAvailability astal_wp_route_get_available(AstalWpRoute *self);
+gboolean astal_wp_route_get_active(AstalWpRoute *self);
+gint astal_wp_route_get_device(AstalWpRoute *self);
+gboolean astal_wp_route_get_hardware_volume(AstalWpRoute *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_ROUTE_H
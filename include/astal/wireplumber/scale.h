@@ -0,0 +1,53 @@
+#ifndef ASTAL_WP_SCALE_H
+#define ASTAL_WP_SCALE_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_SCALE (astal_wp_scale_get_type())
+
+/**
+ * AstalWpScale:
+ * @ASTAL_WP_SCALE_LINEAR: the amplitude factor PipeWire applies
+ * @ASTAL_WP_SCALE_CUBIC: the cube root of the linear volume, close to perceived loudness
+ * @ASTAL_WP_SCALE_DECIBEL: the linear volume in decibels
+ * @ASTAL_WP_SCALE_CUSTOM: a curve given by an #AstalWpScaleFunc
+ */
+typedef enum {
+    ASTAL_WP_SCALE_LINEAR,
+    ASTAL_WP_SCALE_CUBIC,
+    ASTAL_WP_SCALE_DECIBEL,
+    ASTAL_WP_SCALE_CUSTOM,
+} AstalWpScale;
+
+/**
+ * ASTAL_WP_SCALE_DECIBEL_MIN:
+ *
+ * The decibel value silence is reported as. Anything at or below it is converted to silence.
+ */
+#define ASTAL_WP_SCALE_DECIBEL_MIN -120.0
+
+/**
+ * AstalWpScaleFunc:
+ * @volume: the volume to convert
+ * @to_linear: whether @volume is in the custom scale and has to be converted to linear, or the
+ * other way round
+ * @user_data: the data passed when the function was set
+ *
+ * Converts between the linear volume and a custom scale.
+ *
+ * Returns: the converted volume
+ */
+typedef gdouble (*AstalWpScaleFunc)(gdouble volume, gboolean to_linear, gpointer user_data);
+
+gdouble astal_wp_scale_from_linear(AstalWpScale scale, gdouble volume);
+gdouble astal_wp_scale_to_linear(AstalWpScale scale, gdouble volume);
+void astal_wp_scale_from_linear_array(AstalWpScale scale, const gdouble *volumes, gdouble *out,
+                                      guint n_volumes);
+void astal_wp_scale_to_linear_array(AstalWpScale scale, const gdouble *volumes, gdouble *out,
+                                    guint n_volumes);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_SCALE_H
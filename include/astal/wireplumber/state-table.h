@@ -0,0 +1,128 @@
+#ifndef ASTAL_WP_STATE_TABLE_H
+#define ASTAL_WP_STATE_TABLE_H
+
+// Reader for the state table AstalWpWp publishes while its shared-state property is enabled.
+//
+// This header is plain C and does not depend on GLib or on the library itself. Mapping the table
+// costs a few syscalls once, after that every read is a copy out of shared memory guarded by a
+// seqlock.
+//
+//     const AstalWpStateTable *table = astal_wp_state_table_open();
+//     AstalWpStateTable state;
+//     if (table != NULL && astal_wp_state_table_read(table, &state) == 0) {
+//         const AstalWpStateEntry *speaker =
+//             astal_wp_state_table_find(&state, state.default_speaker);
+//     }
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ASTAL_WP_STATE_TABLE_FILE "astal-wireplumber.state"
+#define ASTAL_WP_STATE_TABLE_MAGIC 0x53505741u  // "AWPS"
+#define ASTAL_WP_STATE_TABLE_VERSION 2u
+#define ASTAL_WP_STATE_TABLE_MAX_ENTRIES 128
+
+// the writer cleared this flag when it stopped publishing, the contents are stale
+#define ASTAL_WP_STATE_TABLE_ALIVE (1u << 0)
+// there were more endpoints than entries
+#define ASTAL_WP_STATE_TABLE_TRUNCATED (1u << 1)
+
+// media_class holds the value of AstalWpMediaClass. volume is linear, like the amplitude factor
+// PipeWire applies, regardless of the scale the writer uses for its endpoints
+typedef struct {
+    uint32_t id;
+    uint32_t media_class;
+    double volume;
+    uint32_t mute;
+    uint32_t reserved;
+} AstalWpStateEntry;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    // odd while the writer is updating the table
+    uint32_t sequence;
+    uint32_t flags;
+    uint32_t default_speaker;
+    uint32_t default_microphone;
+    uint32_t n_entries;
+    uint32_t reserved;
+    AstalWpStateEntry entries[ASTAL_WP_STATE_TABLE_MAX_ENTRIES];
+} AstalWpStateTable;
+
+// maps the table read only, returns NULL if no process publishes it. The writer holds an exclusive
+// lock on the file for as long as it lives, so a table left behind by a crashed writer, which still
+// has the alive flag set, is told apart by being able to take a shared lock.
+static inline const AstalWpStateTable *astal_wp_state_table_open(void) {
+    const char *dir = getenv("XDG_RUNTIME_DIR");
+    char path[4096];
+    if (dir == NULL) return NULL;
+    if (snprintf(path, sizeof(path), "%s/%s", dir, ASTAL_WP_STATE_TABLE_FILE) >= (int)sizeof(path))
+        return NULL;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    if (flock(fd, LOCK_SH | LOCK_NB) == 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *table = mmap(NULL, sizeof(AstalWpStateTable), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (table == MAP_FAILED) return NULL;
+
+    const AstalWpStateTable *t = (const AstalWpStateTable *)table;
+    if (t->magic != ASTAL_WP_STATE_TABLE_MAGIC || t->version != ASTAL_WP_STATE_TABLE_VERSION) {
+        munmap(table, sizeof(AstalWpStateTable));
+        return NULL;
+    }
+    return t;
+}
+
+static inline void astal_wp_state_table_close(const AstalWpStateTable *table) {
+    if (table != NULL) munmap((void *)table, sizeof(AstalWpStateTable));
+}
+
+// copies a consistent snapshot of the table into state. Returns 0 on success, -1 if the writer
+// stopped publishing, in which case the table has to be opened again.
+static inline int astal_wp_state_table_read(const AstalWpStateTable *table,
+                                            AstalWpStateTable *state) {
+    uint32_t begin, end;
+
+    do {
+        begin = __atomic_load_n(&table->sequence, __ATOMIC_ACQUIRE);
+        if (begin & 1) continue;
+
+        memcpy(state, (const void *)table, sizeof(AstalWpStateTable));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        end = __atomic_load_n(&table->sequence, __ATOMIC_RELAXED);
+    } while ((begin & 1) || begin != end);
+
+    return (state->flags & ASTAL_WP_STATE_TABLE_ALIVE) ? 0 : -1;
+}
+
+static inline const AstalWpStateEntry *astal_wp_state_table_find(const AstalWpStateTable *state,
+                                                                 uint32_t id) {
+    for (uint32_t i = 0; i < state->n_entries && i < ASTAL_WP_STATE_TABLE_MAX_ENTRIES; i++) {
+        if (state->entries[i].id == id) return &state->entries[i];
+    }
+    return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // !ASTAL_WP_STATE_TABLE_H
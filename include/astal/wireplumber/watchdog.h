@@ -0,0 +1,36 @@
+#ifndef ASTAL_WP_WATCHDOG_H
+#define ASTAL_WP_WATCHDOG_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_TYPE_STALL (astal_wp_stall_get_type())
+
+/**
+ * AstalWpStall:
+ * @call: the synchronous PipeWire or WirePlumber call, like `wp_core_connect`
+ * @location: the file and line the call was made from
+ * @function: the function the call was made from
+ * @id: the id of the object the call was made for, 0 if there is none
+ * @timestamp: the monotonic time in microseconds the call started at
+ * @duration: how long the call blocked in milliseconds
+ *
+ * A synchronous call which blocked the calling thread for longer than AstalWpWp:stall-threshold.
+ */
+typedef struct {
+    const gchar *call;
+    const gchar *location;
+    const gchar *function;
+    guint id;
+    gint64 timestamp;
+    gdouble duration;
+} AstalWpStall;
+
+GType astal_wp_stall_get_type(void);
+AstalWpStall *astal_wp_stall_copy(const AstalWpStall *self);
+void astal_wp_stall_free(AstalWpStall *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_WATCHDOG_H
@@ -4,18 +4,94 @@
 #include <glib-object.h>
 
 #include "audio.h"
+#include "client.h"
 #include "device.h"
 #include "endpoint.h"
+#include "link.h"
+#include "port.h"
+#include "profiler.h"
+#include "scale.h"
 #include "video.h"
+#include "watchdog.h"
 
 G_BEGIN_DECLS
 
-#define ASTAL_WP_TYPE_SCALE (astal_wp_scale_get_type())
+#define ASTAL_WP_TYPE_BACKEND (astal_wp_backend_get_type())
 
+/**
+ * AstalWpBackend:
+ * @ASTAL_WP_BACKEND_PIPEWIRE: connect to PipeWire directly
+ * @ASTAL_WP_BACKEND_DBUS: mirror an instance exported with astal_wp_wp_export
+ * @ASTAL_WP_BACKEND_REPLAY: replay a journal written by astal_wp_wp_start_recording
+ * @ASTAL_WP_BACKEND_THREADED: connect to PipeWire on a worker thread and mirror its state into
+ * the main context of this instance in batches, setters are queued to the worker
+ */
 typedef enum {
-    ASTAL_WP_SCALE_LINEAR,
-    ASTAL_WP_SCALE_CUBIC,
-} AstalWpScale;
+    ASTAL_WP_BACKEND_PIPEWIRE,
+    ASTAL_WP_BACKEND_DBUS,
+    ASTAL_WP_BACKEND_REPLAY,
+    ASTAL_WP_BACKEND_THREADED,
+} AstalWpBackend;
+
+#define ASTAL_WP_TYPE_SUBSYSTEMS (astal_wp_subsystems_get_type())
+
+/**
+ * AstalWpSubsystems:
+ * @ASTAL_WP_SUBSYSTEM_NONE: nothing is tracked
+ * @ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS: speakers and microphones, the audio sinks and sources
+ * @ASTAL_WP_SUBSYSTEM_AUDIO_STREAMS: audio streams of applications and recorders
+ * @ASTAL_WP_SUBSYSTEM_VIDEO: video sinks, sources and streams
+ * @ASTAL_WP_SUBSYSTEM_DEVICES: the devices of the selected audio and video endpoints
+ * @ASTAL_WP_SUBSYSTEM_MIXER: volume and mute state, without it endpoints have no volume
+ * @ASTAL_WP_SUBSYSTEM_DEFAULTS: the default speaker and microphone and the is-default state
+ * @ASTAL_WP_SUBSYSTEM_GRAPH: clients, links and ports
+ * @ASTAL_WP_SUBSYSTEM_ALL: everything
+ *
+ * The parts of the graph an instance tracks, see AstalWpWp:subsystems.
+ */
+typedef enum {
+    ASTAL_WP_SUBSYSTEM_NONE = 0,
+    ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS = 1 << 0,
+    ASTAL_WP_SUBSYSTEM_AUDIO_STREAMS = 1 << 1,
+    ASTAL_WP_SUBSYSTEM_VIDEO = 1 << 2,
+    ASTAL_WP_SUBSYSTEM_DEVICES = 1 << 3,
+    ASTAL_WP_SUBSYSTEM_MIXER = 1 << 4,
+    ASTAL_WP_SUBSYSTEM_DEFAULTS = 1 << 5,
+    ASTAL_WP_SUBSYSTEM_GRAPH = 1 << 6,
+    ASTAL_WP_SUBSYSTEM_ALL = (1 << 7) - 1,
+} AstalWpSubsystems;
+
+#define ASTAL_WP_TYPE_WRITE_KIND (astal_wp_write_kind_get_type())
+
+/**
+ * AstalWpWriteKind:
+ * @ASTAL_WP_WRITE_VOLUME: the volume of an endpoint
+ * @ASTAL_WP_WRITE_MUTE: the mute state of an endpoint
+ * @ASTAL_WP_WRITE_DEFAULT: making an endpoint the default
+ * @ASTAL_WP_WRITE_PROFILE: the active profile of a device
+ */
+typedef enum {
+    ASTAL_WP_WRITE_VOLUME,
+    ASTAL_WP_WRITE_MUTE,
+    ASTAL_WP_WRITE_DEFAULT,
+    ASTAL_WP_WRITE_PROFILE,
+} AstalWpWriteKind;
+
+#define ASTAL_WP_TYPE_EVENT_KIND (astal_wp_event_kind_get_type())
+
+/**
+ * AstalWpEventKind:
+ * @ASTAL_WP_EVENT_OBJECT: an object was added to or removed from the graph
+ * @ASTAL_WP_EVENT_MIXER: the volume or mute state of a node changed
+ * @ASTAL_WP_EVENT_DEFAULT: a default node changed
+ * @ASTAL_WP_EVENT_PARAMS: the params of a device, like its profiles and routes, changed
+ */
+typedef enum {
+    ASTAL_WP_EVENT_OBJECT,
+    ASTAL_WP_EVENT_MIXER,
+    ASTAL_WP_EVENT_DEFAULT,
+    ASTAL_WP_EVENT_PARAMS,
+} AstalWpEventKind;
 
 #define ASTAL_WP_TYPE_WP (astal_wp_wp_get_type())
 
@@ -23,6 +99,18 @@ G_DECLARE_FINAL_TYPE(AstalWpWp, astal_wp_wp, ASTAL_WP, WP, GObject)
 
 AstalWpWp* astal_wp_wp_get_default();
 AstalWpWp* astal_wp_get_default_wp();
+AstalWpWp* astal_wp_wp_new(AstalWpBackend backend);
+AstalWpWp* astal_wp_wp_new_for_journal(const gchar* path, gdouble speed);
+AstalWpWp* astal_wp_wp_new_for_remote(const gchar* remote, GMainContext* context);
+AstalWpWp* astal_wp_wp_new_for_subsystems(AstalWpSubsystems subsystems);
+
+AstalWpBackend astal_wp_wp_get_backend(AstalWpWp* self);
+const gchar* astal_wp_wp_get_remote(AstalWpWp* self);
+GMainContext* astal_wp_wp_get_main_context(AstalWpWp* self);
+AstalWpSubsystems astal_wp_wp_get_subsystems(AstalWpWp* self);
+void astal_wp_wp_export(AstalWpWp* self);
+gboolean astal_wp_wp_start_recording(AstalWpWp* self, const gchar* path, GError** error);
+void astal_wp_wp_stop_recording(AstalWpWp* self);
 
 AstalWpAudio* astal_wp_wp_get_audio(AstalWpWp* self);
 AstalWpVideo* astal_wp_wp_get_video(AstalWpWp* self);
@@ -33,11 +121,62 @@ GList* astal_wp_wp_get_endpoints(AstalWpWp* self);
 AstalWpDevice* astal_wp_wp_get_device(AstalWpWp* self, guint id);
 GList* astal_wp_wp_get_devices(AstalWpWp* self);
 
+AstalWpClient* astal_wp_wp_get_client(AstalWpWp* self, guint id);
+GList* astal_wp_wp_get_clients(AstalWpWp* self);
+
+AstalWpLink* astal_wp_wp_get_link(AstalWpWp* self, guint id);
+GList* astal_wp_wp_get_links(AstalWpWp* self);
+
+AstalWpPort* astal_wp_wp_get_port(AstalWpWp* self, guint id);
+GList* astal_wp_wp_get_ports(AstalWpWp* self);
+
 AstalWpEndpoint* astal_wp_wp_get_default_speaker(AstalWpWp* self);
 AstalWpEndpoint* astal_wp_wp_get_default_microphone(AstalWpWp* self);
 
+void astal_wp_wp_move_streams(AstalWpWp* self, GList* streams, AstalWpEndpoint* target);
+void astal_wp_wp_ramp_volume(AstalWpWp* self, GList* endpoints, gdouble volume,
+                             guint duration_ms, AstalWpRampCurve curve);
+
 AstalWpScale astal_wp_wp_get_scale(AstalWpWp* self);
 void astal_wp_wp_set_scale(AstalWpWp* self, AstalWpScale scale);
+void astal_wp_wp_set_scale_func(AstalWpWp* self, AstalWpScaleFunc func, gpointer data,
+                                GDestroyNotify destroy);
+
+guint astal_wp_wp_get_force_quantum(AstalWpWp* self);
+void astal_wp_wp_set_force_quantum(AstalWpWp* self, guint quantum);
+guint astal_wp_wp_get_force_rate(AstalWpWp* self);
+void astal_wp_wp_set_force_rate(AstalWpWp* self, guint rate);
+const gchar* astal_wp_wp_get_allowed_rates(AstalWpWp* self);
+void astal_wp_wp_set_allowed_rates(AstalWpWp* self, const gchar* rates);
+
+gboolean astal_wp_wp_get_shared_state(AstalWpWp* self);
+void astal_wp_wp_set_shared_state(AstalWpWp* self, gboolean shared);
+
+gboolean astal_wp_wp_get_optimistic(AstalWpWp* self);
+void astal_wp_wp_set_optimistic(AstalWpWp* self, gboolean optimistic);
+guint64 astal_wp_wp_get_confirmation_count(AstalWpWp* self, AstalWpWriteKind kind);
+gdouble astal_wp_wp_get_confirmation_latency(AstalWpWp* self, AstalWpWriteKind kind,
+                                             gdouble percentile);
+gdouble astal_wp_wp_get_confirmation_latency_max(AstalWpWp* self, AstalWpWriteKind kind);
+void astal_wp_wp_reset_confirmation_latency(AstalWpWp* self);
+guint astal_wp_wp_get_rollbacks(AstalWpWp* self, AstalWpWriteKind kind);
+
+guint64 astal_wp_wp_get_event_count(AstalWpWp* self, AstalWpEventKind kind);
+gdouble astal_wp_wp_get_event_latency(AstalWpWp* self, AstalWpEventKind kind, gdouble percentile);
+gdouble astal_wp_wp_get_event_latency_max(AstalWpWp* self, AstalWpEventKind kind);
+void astal_wp_wp_reset_event_latency(AstalWpWp* self);
+
+guint astal_wp_wp_get_stall_threshold(AstalWpWp* self);
+void astal_wp_wp_set_stall_threshold(AstalWpWp* self, guint threshold);
+AstalWpStall* astal_wp_wp_get_stalls(AstalWpWp* self, guint* n_stalls);
+void astal_wp_wp_clear_stalls(AstalWpWp* self);
+
+gboolean astal_wp_wp_get_profiler_enabled(AstalWpWp* self);
+void astal_wp_wp_set_profiler_enabled(AstalWpWp* self, gboolean enabled);
+gboolean astal_wp_wp_get_driver_stats(AstalWpWp* self, guint driver_id, AstalWpDriverStats* stats);
+AstalWpDriverStats* astal_wp_wp_get_driver_history(AstalWpWp* self, guint driver_id,
+                                                   guint* n_samples);
+guint* astal_wp_wp_get_drivers(AstalWpWp* self, guint* n_drivers);
 
 AstalWpVideo* astal_wp_video_new(AstalWpWp* wp);
 AstalWpAudio* astal_wp_audio_new(AstalWpWp* wp);
@@ -0,0 +1,18 @@
+#ifndef ASTAL_WP_AUDIO_PRIVATE_H
+#define ASTAL_WP_AUDIO_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "audio.h"
+
+G_BEGIN_DECLS
+
+void astal_wp_audio_endpoint_added(AstalWpAudio *self, AstalWpEndpoint *endpoint);
+void astal_wp_audio_endpoint_removed(AstalWpAudio *self, AstalWpEndpoint *endpoint);
+void astal_wp_audio_device_added(AstalWpAudio *self, AstalWpDevice *device);
+void astal_wp_audio_device_removed(AstalWpAudio *self, AstalWpDevice *device);
+gboolean astal_wp_audio_has_stream_handlers(AstalWpAudio *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_AUDIO_PRIVATE_H
@@ -0,0 +1,18 @@
+#ifndef ASTAL_WP_CLIENT_PRIVATE_H
+#define ASTAL_WP_CLIENT_PRIVATE_H
+
+#include <glib-object.h>
+#include <wp/wp.h>
+
+#include "client.h"
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+AstalWpClient *astal_wp_client_create(WpClient *client, AstalWpWp *wp);
+void astal_wp_client_add_stream(AstalWpClient *self, AstalWpEndpoint *stream);
+void astal_wp_client_remove_stream(AstalWpClient *self, AstalWpEndpoint *stream);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_CLIENT_PRIVATE_H
@@ -5,10 +5,19 @@
 #include <wp/wp.h>
 
 #include "device.h"
+#include "wp.h"
 
 G_BEGIN_DECLS
 
-AstalWpDevice *astal_wp_device_create(WpDevice *device);
+AstalWpDevice *astal_wp_device_create(guint id, WpDevice *device, WpProperties *properties,
+                                      AstalWpWp *wp);
+AstalWpDevice *astal_wp_device_create_remote(AstalWpWp *wp, GVariant *state);
+GVariant *astal_wp_device_serialize(AstalWpDevice *self);
+void astal_wp_device_apply(AstalWpDevice *self, GVariant *state);
+void astal_wp_device_set_endpoints(AstalWpDevice *self, GPtrArray *endpoints);
+void astal_wp_device_endpoints_changed(AstalWpDevice *self);
+void astal_wp_device_replay_params(AstalWpDevice *self, const gchar *name, GPtrArray *pods);
+void astal_wp_device_record(AstalWpDevice *self);
 
 G_END_DECLS
 
@@ -9,13 +9,36 @@
 
 G_BEGIN_DECLS
 
-AstalWpEndpoint *astal_wp_endpoint_create(WpNode *node, WpPlugin *mixer, WpPlugin *defaults,
-                                          AstalWpWp *wp);
+AstalWpEndpoint *astal_wp_endpoint_create(guint id, WpNode *node, WpProperties *properties,
+                                          WpPlugin *mixer, WpPlugin *defaults, AstalWpWp *wp);
 AstalWpEndpoint *astal_wp_endpoint_init_as_default(AstalWpEndpoint *self, WpPlugin *mixer,
                                                    WpPlugin *defaults, AstalWpMediaClass type,
                                                    AstalWpWp *wp);
+AstalWpEndpoint *astal_wp_endpoint_init_remote(AstalWpEndpoint *self, AstalWpWp *wp,
+                                               gboolean is_default_node);
+GVariant *astal_wp_endpoint_serialize(AstalWpEndpoint *self);
+void astal_wp_endpoint_apply(AstalWpEndpoint *self, GVariant *state);
 void astal_wp_endpoint_update_default(AstalWpEndpoint *self, gboolean is_default);
 void astal_wp_endpoint_update_volume(AstalWpEndpoint *self);
+void astal_wp_endpoint_set_properties(AstalWpEndpoint *self, WpProperties *properties);
+WpProperties *astal_wp_endpoint_get_node_properties(AstalWpEndpoint *self);
+void astal_wp_endpoint_write_volume(AstalWpEndpoint *self, gdouble volume);
+void astal_wp_endpoint_set_linear_volume(AstalWpEndpoint *self, gdouble volume);
+void astal_wp_endpoint_set_linear_channel_volumes(AstalWpEndpoint *self, const gdouble *volumes,
+                                                  guint n_channels);
+gdouble astal_wp_endpoint_convert_volume(AstalWpEndpoint *self, gdouble volume,
+                                         gboolean to_linear);
+gdouble astal_wp_endpoint_clamp_volume(AstalWpEndpoint *self, gdouble volume);
+void astal_wp_endpoint_update_scale(AstalWpEndpoint *self);
+void astal_wp_endpoint_update_target(AstalWpEndpoint *self, const gchar *key, const gchar *value);
+void astal_wp_endpoint_write_target(AstalWpEndpoint *self, WpMetadata *metadata,
+                                    AstalWpEndpoint *target);
+const gchar *astal_wp_endpoint_get_serial(AstalWpEndpoint *self);
+const gchar *astal_wp_endpoint_get_node_name(AstalWpEndpoint *self);
+guint astal_wp_endpoint_get_client_id(AstalWpEndpoint *self);
+guint astal_wp_endpoint_get_device_id(AstalWpEndpoint *self);
+void astal_wp_endpoint_set_device(AstalWpEndpoint *self, AstalWpDevice *device);
+AstalWpWp *astal_wp_endpoint_get_wp(AstalWpEndpoint *self);
 
 G_END_DECLS
 
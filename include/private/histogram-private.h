@@ -0,0 +1,30 @@
+#ifndef ASTAL_WP_HISTOGRAM_PRIVATE_H
+#define ASTAL_WP_HISTOGRAM_PRIVATE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// every power of two range above 2^ASTAL_WP_HISTOGRAM_SUB_BITS is split into that many linear
+// buckets, which bounds the relative error of a recorded value to 1/16
+#define ASTAL_WP_HISTOGRAM_SUB_BITS 4
+#define ASTAL_WP_HISTOGRAM_SUB_BUCKETS (1 << ASTAL_WP_HISTOGRAM_SUB_BITS)
+// values are clamped to below 2^ASTAL_WP_HISTOGRAM_MAX_BITS, a bit over an hour in microseconds
+#define ASTAL_WP_HISTOGRAM_MAX_BITS 32
+#define ASTAL_WP_HISTOGRAM_RANGES (ASTAL_WP_HISTOGRAM_MAX_BITS - ASTAL_WP_HISTOGRAM_SUB_BITS + 1)
+#define ASTAL_WP_HISTOGRAM_SIZE (ASTAL_WP_HISTOGRAM_RANGES * ASTAL_WP_HISTOGRAM_SUB_BUCKETS)
+
+// A log-linear histogram in the style of HdrHistogram, recording takes constant time and memory.
+typedef struct {
+    guint32 counts[ASTAL_WP_HISTOGRAM_SIZE];
+    guint64 total;
+    gint64 max;
+} AstalWpHistogram;
+
+void astal_wp_histogram_record(AstalWpHistogram *self, gint64 value);
+gint64 astal_wp_histogram_percentile(const AstalWpHistogram *self, gdouble percentile);
+void astal_wp_histogram_reset(AstalWpHistogram *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_HISTOGRAM_PRIVATE_H
@@ -0,0 +1,94 @@
+#ifndef ASTAL_WP_JOURNAL_PRIVATE_H
+#define ASTAL_WP_JOURNAL_PRIVATE_H
+
+#include <glib-object.h>
+#include <wp/wp.h>
+
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_JOURNAL_MAGIC 0x4a505741u  // "AWPJ"
+#define ASTAL_WP_JOURNAL_VERSION 4u
+
+// Every record is a header followed by `size` bytes of a serialized GVariant in the byte order of
+// the recording machine. The type of the variant is given by the record type.
+//
+// A journal holds the raw inputs the handlers consumed, the records from
+// ASTAL_WP_JOURNAL_PW_NODE_ADDED on. The a{sv} records before them carry the state of a core on
+// another thread, see worker.c.
+typedef enum {
+    // (a{sv}aa{sv}aa{sv}), the same as the GetState method of the service
+    ASTAL_WP_JOURNAL_STATE,
+    // a{sv}
+    ASTAL_WP_JOURNAL_DEFAULTS,
+    // a{sv}
+    ASTAL_WP_JOURNAL_ENDPOINT_ADDED,
+    // u
+    ASTAL_WP_JOURNAL_ENDPOINT_REMOVED,
+    // (ua{sv})
+    ASTAL_WP_JOURNAL_ENDPOINT_CHANGED,
+    // a{sv}
+    ASTAL_WP_JOURNAL_DEVICE_ADDED,
+    // u
+    ASTAL_WP_JOURNAL_DEVICE_REMOVED,
+    // (ua{sv})
+    ASTAL_WP_JOURNAL_DEVICE_CHANGED,
+    // (ua{ss}) the id and the properties of a node which appeared
+    ASTAL_WP_JOURNAL_PW_NODE_ADDED,
+    // u
+    ASTAL_WP_JOURNAL_PW_NODE_REMOVED,
+    // (ua{ss}) the properties a node reported since
+    ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES,
+    // (ua{ss}) the id and the properties of a device which appeared
+    ASTAL_WP_JOURNAL_PW_DEVICE_ADDED,
+    // u
+    ASTAL_WP_JOURNAL_PW_DEVICE_REMOVED,
+    // (usaay) the pods a device enumerated for a param like "EnumProfile"
+    ASTAL_WP_JOURNAL_PW_DEVICE_PARAMS,
+    // (ua{sv}) the get-volume payload of the mixer api for a node
+    ASTAL_WP_JOURNAL_MIXER_VOLUME,
+    // (su) the node the default nodes api reports for a media class
+    ASTAL_WP_JOURNAL_DEFAULT_NODE,
+    // () the object manager was installed, everything before is the initial state
+    ASTAL_WP_JOURNAL_INSTALLED,
+    ASTAL_WP_JOURNAL_N_RECORDS,
+} AstalWpJournalRecordType;
+
+typedef struct {
+    guint32 magic;
+    guint32 version;
+} AstalWpJournalHeader;
+
+typedef struct {
+    // microseconds since the recording started
+    guint64 time;
+    guint32 type;
+    guint32 size;
+} AstalWpJournalRecord;
+
+typedef struct _AstalWpJournal AstalWpJournal;
+typedef struct _AstalWpReplay AstalWpReplay;
+
+AstalWpJournal *astal_wp_journal_new(AstalWpWp *wp, const gchar *path, GError **error);
+void astal_wp_journal_free(AstalWpJournal *self);
+// records a raw input. Inputs which replace the previous state of their object are kept until
+// the main loop is idle and written once per object, additions and removals are written right away
+void astal_wp_journal_input(AstalWpJournal *self, AstalWpJournalRecordType type, GVariant *value);
+// writes the inputs kept back now
+void astal_wp_journal_flush(AstalWpJournal *self);
+// the floating (ua{ss}) of properties, which may be NULL
+GVariant *astal_wp_journal_properties(guint id, WpProperties *properties);
+// the floating (usaay) of the pods of a param
+GVariant *astal_wp_journal_params(guint id, const gchar *name, GPtrArray *pods);
+
+GVariant *astal_wp_journal_defaults(AstalWpWp *wp);
+void astal_wp_journal_apply(AstalWpWp *wp, AstalWpJournalRecordType type, GVariant *value);
+
+AstalWpReplay *astal_wp_replay_new(AstalWpWp *wp, const gchar *path, gdouble speed,
+                                   GError **error);
+void astal_wp_replay_free(AstalWpReplay *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_JOURNAL_PRIVATE_H
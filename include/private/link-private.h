@@ -0,0 +1,15 @@
+#ifndef ASTAL_WP_LINK_PRIVATE_H
+#define ASTAL_WP_LINK_PRIVATE_H
+
+#include <glib-object.h>
+#include <wp/wp.h>
+
+#include "link.h"
+
+G_BEGIN_DECLS
+
+AstalWpLink *astal_wp_link_create(WpLink *link);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_LINK_PRIVATE_H
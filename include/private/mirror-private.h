@@ -0,0 +1,19 @@
+#ifndef ASTAL_WP_MIRROR_PRIVATE_H
+#define ASTAL_WP_MIRROR_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+typedef struct _AstalWpMirror AstalWpMirror;
+
+AstalWpMirror *astal_wp_mirror_new(AstalWpWp *wp);
+void astal_wp_mirror_free(AstalWpMirror *self);
+
+void astal_wp_mirror_call(AstalWpMirror *self, const gchar *method, GVariant *args);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_MIRROR_PRIVATE_H
@@ -0,0 +1,46 @@
+#ifndef ASTAL_WP_PENDING_PRIVATE_H
+#define ASTAL_WP_PENDING_PRIVATE_H
+
+#include <gio/gio.h>
+
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_WRITE_N_KINDS (ASTAL_WP_WRITE_PROFILE + 1)
+
+// how long a write waits for PipeWire before its task fails and an optimistic value is rolled back
+#define ASTAL_WP_PENDING_TIMEOUT_MS 1000
+// writes tracked per object and kind, older ones are dropped as superseded
+#define ASTAL_WP_PENDING_MAX_WRITES 64
+
+typedef void (*AstalWpPendingRollbackFunc)(gpointer data, AstalWpWriteKind kind);
+
+// The writes of one kind on one object which PipeWire has not reported yet. Writes are tracked
+// when they were applied optimistically, see AstalWpWp:optimistic, or when a task waits for them.
+typedef struct {
+    AstalWpWp *wp;
+    AstalWpWriteKind kind;
+    // AstalWpPendingEntry in the order they were written, empty when nothing is pending
+    GQueue writes;
+    // whether the latest write was applied locally
+    gboolean optimistic;
+    guint timeout_id;
+
+    AstalWpPendingRollbackFunc rollback;
+    gpointer data;
+} AstalWpPendingWrite;
+
+void astal_wp_pending_init(AstalWpPendingWrite *self, AstalWpWriteKind kind,
+                           AstalWpPendingRollbackFunc rollback, gpointer data);
+gboolean astal_wp_pending_begin(AstalWpPendingWrite *self, AstalWpWp *wp, gdouble current,
+                                gdouble expected, gboolean optimistic, GTask *task);
+gboolean astal_wp_pending_reconcile(AstalWpPendingWrite *self, gdouble value);
+void astal_wp_pending_clear(AstalWpPendingWrite *self);
+
+gboolean astal_wp_pending_finish(gpointer source, GAsyncResult *result, gint64 *round_trip,
+                                 GError **error);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_PENDING_PRIVATE_H
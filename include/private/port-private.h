@@ -0,0 +1,15 @@
+#ifndef ASTAL_WP_PORT_PRIVATE_H
+#define ASTAL_WP_PORT_PRIVATE_H
+
+#include <glib-object.h>
+#include <wp/wp.h>
+
+#include "port.h"
+
+G_BEGIN_DECLS
+
+AstalWpPort *astal_wp_port_create(WpPort *port);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_PORT_PRIVATE_H
@@ -0,0 +1,29 @@
+#ifndef ASTAL_WP_PROFILE_PRIVATE_H
+#define ASTAL_WP_PROFILE_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "profile.h"
+
+G_BEGIN_DECLS
+
+// An immutable list of profiles. Sets are interned in a process wide catalog keyed by their
+// content, so devices which enumerate the same profiles share one set and its AstalWpProfiles.
+typedef struct _AstalWpProfileSet AstalWpProfileSet;
+
+// index, name, description, priority and the number of nodes per media class of every profile.
+// Availability changes with the plugged jacks and is kept by the device.
+#define ASTAL_WP_PROFILE_SET_TYPE "a(issia(su))"
+
+AstalWpProfileSet *astal_wp_profile_set_intern(GVariant *profiles);
+AstalWpProfileSet *astal_wp_profile_set_ref(AstalWpProfileSet *self);
+void astal_wp_profile_set_unref(AstalWpProfileSet *self);
+guint astal_wp_profile_set_get_size(AstalWpProfileSet *self);
+AstalWpProfile *astal_wp_profile_set_get(AstalWpProfileSet *self, guint position);
+gint astal_wp_profile_set_find(AstalWpProfileSet *self, gint index);
+AstalWpProfile *astal_wp_profile_set_lookup(AstalWpProfileSet *self, gint index);
+GList *astal_wp_profile_set_list(AstalWpProfileSet *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_PROFILE_PRIVATE_H
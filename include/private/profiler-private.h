@@ -0,0 +1,33 @@
+#ifndef ASTAL_WP_PROFILER_PRIVATE_H
+#define ASTAL_WP_PROFILER_PRIVATE_H
+
+#include <glib-object.h>
+#include <wp/wp.h>
+
+#include "profiler.h"
+
+G_BEGIN_DECLS
+
+// number of samples kept per driver
+#define ASTAL_WP_PROFILER_HISTORY_SIZE 128
+// interval in which samples are folded into the history and signals are emitted
+#define ASTAL_WP_PROFILER_INTERVAL_MS 250
+
+typedef struct _AstalWpProfiler AstalWpProfiler;
+
+typedef void (*AstalWpProfilerFunc)(const AstalWpDriverStats *stats, guint n_stats,
+                                    gpointer user_data);
+
+AstalWpProfiler *astal_wp_profiler_new(WpCore *core, AstalWpProfilerFunc func,
+                                       gpointer user_data);
+void astal_wp_profiler_free(AstalWpProfiler *self);
+
+gboolean astal_wp_profiler_get_stats(AstalWpProfiler *self, guint driver_id,
+                                     AstalWpDriverStats *stats);
+AstalWpDriverStats *astal_wp_profiler_get_history(AstalWpProfiler *self, guint driver_id,
+                                                  guint *n_samples);
+guint *astal_wp_profiler_get_drivers(AstalWpProfiler *self, guint *n_drivers);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_PROFILER_PRIVATE_H
@@ -0,0 +1,25 @@
+#ifndef ASTAL_WP_RAMP_PRIVATE_H
+#define ASTAL_WP_RAMP_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "endpoint.h"
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+// interval of the timer shared by every running ramp of an instance
+#define ASTAL_WP_RAMP_INTERVAL_MS 16
+
+typedef struct _AstalWpRamps AstalWpRamps;
+
+AstalWpRamps *astal_wp_ramps_new(AstalWpWp *wp);
+void astal_wp_ramps_free(AstalWpRamps *self);
+
+void astal_wp_ramp_start(AstalWpEndpoint *endpoint, gdouble volume, gint64 start,
+                         guint duration_ms, AstalWpRampCurve curve);
+void astal_wp_ramp_cancel(AstalWpEndpoint *endpoint);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_RAMP_PRIVATE_H
@@ -0,0 +1,20 @@
+#ifndef ASTAL_WP_ROUTE_PRIVATE_H
+#define ASTAL_WP_ROUTE_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "route.h"
+
+G_BEGIN_DECLS
+
+AstalWpRoute *astal_wp_route_new(gint index);
+gboolean astal_wp_route_update(AstalWpRoute *self, const gchar *name, const gchar *description,
+                               AstalWpDirection direction, guint priority,
+                               AstalWpAvailability available);
+void astal_wp_route_set_devices(AstalWpRoute *self, GArray *profiles, GArray *devices);
+gint astal_wp_route_find_device(AstalWpRoute *self, gint profile);
+gboolean astal_wp_route_set_active(AstalWpRoute *self, gint device, gboolean hardware_volume);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_ROUTE_PRIVATE_H
@@ -0,0 +1,20 @@
+#ifndef ASTAL_WP_SCALE_PRIVATE_H
+#define ASTAL_WP_SCALE_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "scale.h"
+
+G_BEGIN_DECLS
+
+// clamps volume to the range of the scale before it is written
+gdouble astal_wp_scale_clamp(AstalWpScale scale, gdouble volume);
+gdouble astal_wp_scale_convert(AstalWpScale scale, AstalWpScaleFunc func, gpointer data,
+                               gdouble volume, gboolean to_linear);
+void astal_wp_scale_convert_array(AstalWpScale scale, AstalWpScaleFunc func, gpointer data,
+                                  const gdouble *volumes, gdouble *out, guint n_volumes,
+                                  gboolean to_linear);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_SCALE_PRIVATE_H
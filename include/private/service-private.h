@@ -0,0 +1,29 @@
+#ifndef ASTAL_WP_SERVICE_PRIVATE_H
+#define ASTAL_WP_SERVICE_PRIVATE_H
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_DBUS_NAME "io.Astal.Wireplumber"
+#define ASTAL_WP_DBUS_PATH "/io/Astal/Wireplumber"
+#define ASTAL_WP_DBUS_INTERFACE "io.Astal.Wireplumber"
+#define ASTAL_WP_DBUS_ENDPOINT_PATH ASTAL_WP_DBUS_PATH "/Endpoint/"
+#define ASTAL_WP_DBUS_ENDPOINT_INTERFACE ASTAL_WP_DBUS_INTERFACE ".Endpoint"
+#define ASTAL_WP_DBUS_DEVICE_PATH ASTAL_WP_DBUS_PATH "/Device/"
+#define ASTAL_WP_DBUS_DEVICE_INTERFACE ASTAL_WP_DBUS_INTERFACE ".Device"
+
+typedef struct _AstalWpService AstalWpService;
+
+AstalWpService *astal_wp_service_new(AstalWpWp *wp);
+void astal_wp_service_free(AstalWpService *self);
+
+gboolean astal_wp_service_run_command(AstalWpWp *wp, const gchar *method, GVariant *params,
+                                      GError **error);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_SERVICE_PRIVATE_H
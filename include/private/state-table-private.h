@@ -0,0 +1,17 @@
+#ifndef ASTAL_WP_STATE_TABLE_PRIVATE_H
+#define ASTAL_WP_STATE_TABLE_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+typedef struct _AstalWpStateTableWriter AstalWpStateTableWriter;
+
+AstalWpStateTableWriter *astal_wp_state_table_writer_new(AstalWpWp *wp);
+void astal_wp_state_table_writer_free(AstalWpStateTableWriter *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_STATE_TABLE_PRIVATE_H
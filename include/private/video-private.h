@@ -0,0 +1,18 @@
+#ifndef ASTAL_WP_VIDEO_PRIVATE_H
+#define ASTAL_WP_VIDEO_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "video.h"
+
+G_BEGIN_DECLS
+
+void astal_wp_video_endpoint_added(AstalWpVideo *self, AstalWpEndpoint *endpoint);
+void astal_wp_video_endpoint_removed(AstalWpVideo *self, AstalWpEndpoint *endpoint);
+void astal_wp_video_device_added(AstalWpVideo *self, AstalWpDevice *device);
+void astal_wp_video_device_removed(AstalWpVideo *self, AstalWpDevice *device);
+gboolean astal_wp_video_has_stream_handlers(AstalWpVideo *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_VIDEO_PRIVATE_H
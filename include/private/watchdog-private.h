@@ -0,0 +1,31 @@
+#ifndef ASTAL_WP_WATCHDOG_PRIVATE_H
+#define ASTAL_WP_WATCHDOG_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "watchdog.h"
+
+G_BEGIN_DECLS
+
+// number of the longest stalls kept
+#define ASTAL_WP_WATCHDOG_SIZE 32
+// default of AstalWpWp:stall-threshold, half a frame at 60Hz
+#define ASTAL_WP_WATCHDOG_THRESHOLD_MS 8
+
+typedef struct _AstalWpWatchdog AstalWpWatchdog;
+
+AstalWpWatchdog *astal_wp_watchdog_new(void);
+void astal_wp_watchdog_free(AstalWpWatchdog *self);
+
+guint astal_wp_watchdog_get_threshold(AstalWpWatchdog *self);
+void astal_wp_watchdog_set_threshold(AstalWpWatchdog *self, guint threshold_ms);
+
+// call, location and function must be static strings, like string literals, G_STRLOC and G_STRFUNC
+void astal_wp_watchdog_report(AstalWpWatchdog *self, const gchar *call, const gchar *location,
+                              const gchar *function, guint id, gint64 start);
+AstalWpStall *astal_wp_watchdog_get_stalls(AstalWpWatchdog *self, guint *n_stalls);
+void astal_wp_watchdog_clear(AstalWpWatchdog *self);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_WATCHDOG_PRIVATE_H
@@ -0,0 +1,19 @@
+#ifndef ASTAL_WP_WORKER_PRIVATE_H
+#define ASTAL_WP_WORKER_PRIVATE_H
+
+#include <glib-object.h>
+
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+typedef struct _AstalWpWorker AstalWpWorker;
+
+AstalWpWorker *astal_wp_worker_new(AstalWpWp *wp);
+void astal_wp_worker_free(AstalWpWorker *self);
+
+void astal_wp_worker_call(AstalWpWorker *self, const gchar *method, GVariant *args);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_WORKER_PRIVATE_H
@@ -0,0 +1,85 @@
+#ifndef ASTAL_WP_WP_PRIVATE_H
+#define ASTAL_WP_WP_PRIVATE_H
+
+#include <glib-object.h>
+#include <wp/wp.h>
+
+#include "journal-private.h"
+#include "port.h"
+#include "ramp-private.h"
+#include "wp.h"
+
+G_BEGIN_DECLS
+
+#define ASTAL_WP_EVENT_N_KINDS (ASTAL_WP_EVENT_PARAMS + 1)
+
+GPtrArray *astal_wp_wp_get_node_links(AstalWpWp *self, guint node_id, AstalWpDirection direction);
+GPtrArray *astal_wp_wp_get_node_ports(AstalWpWp *self, guint node_id);
+
+// the endpoints created so far, unlike astal_wp_wp_get_endpoints this leaves pending streams
+// alone, see AstalWpWp:lazy-streams
+GList *astal_wp_wp_peek_endpoints(AstalWpWp *self);
+// creates the pending streams if anyone listens for them now, to be called by internal consumers
+// after connecting to endpoint-added so they see the streams which were deferred until then
+void astal_wp_wp_sync_lazy_streams(AstalWpWp *self);
+
+WpMetadata *astal_wp_wp_get_default_metadata(AstalWpWp *self);
+AstalWpEndpoint *astal_wp_wp_find_target(AstalWpWp *self, const gchar *target);
+
+AstalWpScaleFunc astal_wp_wp_get_scale_func(AstalWpWp *self, gpointer *data);
+AstalWpRamps *astal_wp_wp_get_ramps(AstalWpWp *self);
+
+// sources of an instance are attached to its main context, see AstalWpWp:main-context
+guint astal_wp_wp_idle_add(AstalWpWp *self, gint priority, GSourceFunc func, gpointer data);
+guint astal_wp_wp_timeout_add(AstalWpWp *self, guint interval, GSourceFunc func, gpointer data);
+void astal_wp_wp_clear_source(AstalWpWp *self, guint *id);
+
+void astal_wp_wp_notify_collection(AstalWpWp *self, GObject *object, const gchar *property);
+
+void astal_wp_wp_remote_command(AstalWpWp *self, const gchar *method, GVariant *args);
+
+void astal_wp_wp_record_confirmation(AstalWpWp *self, AstalWpWriteKind kind, gint64 latency);
+void astal_wp_wp_record_rollback(AstalWpWp *self, AstalWpWriteKind kind);
+// records the time from start, the g_get_monotonic_time at which PipeWire delivered the event, to
+// now, after every notify it caused was emitted
+void astal_wp_wp_record_event(AstalWpWp *self, AstalWpEventKind kind, gint64 start);
+
+// reports a synchronous call which started at the g_get_monotonic_time start and blocked until
+// now to the watchdog, see AstalWpWp:stall-threshold. call has to be a static string.
+#define ASTAL_WP_WP_REPORT_CALL(self, call, id, start) \
+    astal_wp_wp_report_call(self, call, G_STRLOC, G_STRFUNC, id, start)
+void astal_wp_wp_report_call(AstalWpWp *self, const gchar *call, const gchar *location,
+                             const gchar *function, guint id, gint64 start);
+
+// whether inputs are journaled, see astal_wp_wp_start_recording. Callers check it before they
+// build an input, astal_wp_wp_record_input drops the floating value otherwise
+gboolean astal_wp_wp_is_recording(AstalWpWp *self);
+void astal_wp_wp_record_input(AstalWpWp *self, AstalWpJournalRecordType type, GVariant *value);
+
+// the entry points of a replay, they take the place of the object manager and the plugins. The
+// stand-in plugins only answer the action signals with what the journal reported
+void astal_wp_wp_replay_begin(AstalWpWp *self, WpPlugin *mixer, WpPlugin *defaults);
+void astal_wp_wp_replay_installed(AstalWpWp *self);
+void astal_wp_wp_replay_node_added(AstalWpWp *self, guint id, WpProperties *properties);
+void astal_wp_wp_replay_node_removed(AstalWpWp *self, guint id);
+void astal_wp_wp_replay_node_properties(AstalWpWp *self, guint id, WpProperties *properties);
+void astal_wp_wp_replay_device_added(AstalWpWp *self, guint id, WpProperties *properties);
+void astal_wp_wp_replay_device_removed(AstalWpWp *self, guint id);
+// takes the pods
+void astal_wp_wp_replay_device_params(AstalWpWp *self, guint id, const gchar *name,
+                                      GPtrArray *pods);
+
+void astal_wp_wp_mirror_state(AstalWpWp *self, GVariant *defaults, GVariant *endpoints,
+                              GVariant *devices);
+void astal_wp_wp_mirror_clear(AstalWpWp *self);
+void astal_wp_wp_mirror_defaults(AstalWpWp *self, GVariant *state);
+void astal_wp_wp_mirror_endpoint(AstalWpWp *self, GVariant *state);
+void astal_wp_wp_mirror_endpoint_removed(AstalWpWp *self, guint id);
+void astal_wp_wp_mirror_endpoint_changed(AstalWpWp *self, guint id, GVariant *changed);
+void astal_wp_wp_mirror_device(AstalWpWp *self, GVariant *state);
+void astal_wp_wp_mirror_device_removed(AstalWpWp *self, guint id);
+void astal_wp_wp_mirror_device_changed(AstalWpWp *self, guint id, GVariant *changed);
+
+G_END_DECLS
+
+#endif  // !ASTAL_WP_WP_PRIVATE_H
@@ -0,0 +1,432 @@
+#include <glib-object.h>
+#include <glib-unix.h>
+#include <glib.h>
+#include <signal.h>
+#include <stdio.h>
+
+#include "wp.h"
+
+// Prints one snapshot of the current state followed by one json object per line for every change.
+// Property notifications arrive in bursts, so changes are collected per object and written once
+// the main loop is idle.
+
+typedef enum {
+    DIRTY_VOLUME = 1 << 0,
+    DIRTY_PROPERTIES = 1 << 1,
+} Dirty;
+
+static AstalWpWp *wp = NULL;
+static GString *buffer = NULL;
+
+// object -> Dirty flags of changes that were not written yet
+static GHashTable *dirty = NULL;
+static guint flush_id = 0;
+
+static gboolean ready = FALSE;
+
+static void json_string(const gchar *str) {
+    if (str == NULL) {
+        g_string_append(buffer, "null");
+        return;
+    }
+
+    g_string_append_c(buffer, '"');
+    for (const guchar *c = (const guchar *)str; *c != '\0'; c++) {
+        switch (*c) {
+            case '"':
+                g_string_append(buffer, "\\\"");
+                break;
+            case '\\':
+                g_string_append(buffer, "\\\\");
+                break;
+            case '\n':
+                g_string_append(buffer, "\\n");
+                break;
+            case '\r':
+                g_string_append(buffer, "\\r");
+                break;
+            case '\t':
+                g_string_append(buffer, "\\t");
+                break;
+            default:
+                if (*c < 0x20)
+                    g_string_append_printf(buffer, "\\u%04x", *c);
+                else
+                    g_string_append_c(buffer, *c);
+        }
+    }
+    g_string_append_c(buffer, '"');
+}
+
+static void json_separator() {
+    char last = buffer->len > 0 ? buffer->str[buffer->len - 1] : '\0';
+    if (last != '{' && last != '[') g_string_append_c(buffer, ',');
+}
+
+static void json_key(const gchar *key) {
+    json_separator();
+    g_string_append_c(buffer, '"');
+    g_string_append(buffer, key);
+    g_string_append(buffer, "\":");
+}
+
+static void json_uint(const gchar *key, guint value) {
+    json_key(key);
+    g_string_append_printf(buffer, "%u", value);
+}
+
+static void json_int(const gchar *key, gint value) {
+    json_key(key);
+    g_string_append_printf(buffer, "%d", value);
+}
+
+static void json_double(const gchar *key, gdouble value) {
+    gchar str[G_ASCII_DTOSTR_BUF_SIZE];
+    json_key(key);
+    g_string_append(buffer, g_ascii_formatd(str, sizeof(str), "%.4f", value));
+}
+
+static void json_bool(const gchar *key, gboolean value) {
+    json_key(key);
+    g_string_append(buffer, value ? "true" : "false");
+}
+
+static void json_str(const gchar *key, const gchar *value) {
+    json_key(key);
+    json_string(value);
+}
+
+static void json_nick(const gchar *key, GType type, gint value) {
+    GEnumClass *enum_class = g_type_class_ref(type);
+    GEnumValue *enum_value = g_enum_get_value(enum_class, value);
+    json_str(key, enum_value != NULL ? enum_value->value_nick : NULL);
+    g_type_class_unref(enum_class);
+}
+
+static void write_line() {
+    g_string_append_c(buffer, '\n');
+    fwrite(buffer->str, 1, buffer->len, stdout);
+    fflush(stdout);
+    g_string_truncate(buffer, 0);
+}
+
+static void write_endpoint(AstalWpEndpoint *endpoint) {
+    g_string_append_c(buffer, '{');
+    json_uint("id", astal_wp_endpoint_get_id(endpoint));
+    json_nick("media_class", ASTAL_WP_TYPE_MEDIA_CLASS,
+              astal_wp_endpoint_get_media_class(endpoint));
+    json_str("description", astal_wp_endpoint_get_description(endpoint));
+    json_str("name", astal_wp_endpoint_get_name(endpoint));
+    json_str("icon", astal_wp_endpoint_get_icon(endpoint));
+    json_double("volume", astal_wp_endpoint_get_volume(endpoint));
+    json_bool("mute", astal_wp_endpoint_get_mute(endpoint));
+    json_bool("is_default", astal_wp_endpoint_get_is_default(endpoint));
+    g_string_append_c(buffer, '}');
+}
+
+static void write_device(AstalWpDevice *device) {
+    g_string_append_c(buffer, '{');
+    json_uint("id", astal_wp_device_get_id(device));
+    json_nick("device_type", ASTAL_WP_TYPE_DEVICE_TYPE, astal_wp_device_get_device_type(device));
+    json_str("description", astal_wp_device_get_description(device));
+    json_str("icon", astal_wp_device_get_icon(device));
+    json_int("active_profile", astal_wp_device_get_active_profile(device));
+    g_string_append_c(buffer, '}');
+}
+
+static void write_defaults() {
+    json_uint("default_speaker", astal_wp_endpoint_get_id(astal_wp_wp_get_default_speaker(wp)));
+    json_uint("default_microphone",
+              astal_wp_endpoint_get_id(astal_wp_wp_get_default_microphone(wp)));
+}
+
+static void write_snapshot() {
+    g_string_append(buffer, "{\"event\":\"snapshot\"");
+
+    json_key("endpoints");
+    g_string_append_c(buffer, '[');
+    GList *endpoints = astal_wp_wp_get_endpoints(wp);
+    for (GList *l = endpoints; l != NULL; l = l->next) {
+        json_separator();
+        write_endpoint(l->data);
+    }
+    g_list_free(endpoints);
+    g_string_append_c(buffer, ']');
+
+    json_key("devices");
+    g_string_append_c(buffer, '[');
+    GList *devices = astal_wp_wp_get_devices(wp);
+    for (GList *l = devices; l != NULL; l = l->next) {
+        json_separator();
+        write_device(l->data);
+    }
+    g_list_free(devices);
+    g_string_append_c(buffer, ']');
+
+    write_defaults();
+    g_string_append_c(buffer, '}');
+    write_line();
+}
+
+static gboolean flush(gpointer user_data) {
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&iter, dirty);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        guint flags = GPOINTER_TO_UINT(value);
+
+        if (ASTAL_WP_IS_ENDPOINT(key)) {
+            AstalWpEndpoint *endpoint = key;
+            if (flags & DIRTY_PROPERTIES) {
+                g_string_append(buffer, "{\"event\":\"endpoint-changed\"");
+                json_key("endpoint");
+                write_endpoint(endpoint);
+                g_string_append_c(buffer, '}');
+            } else {
+                g_string_append(buffer, "{\"event\":\"volume\"");
+                json_uint("id", astal_wp_endpoint_get_id(endpoint));
+                json_double("volume", astal_wp_endpoint_get_volume(endpoint));
+                json_bool("mute", astal_wp_endpoint_get_mute(endpoint));
+                g_string_append_c(buffer, '}');
+            }
+        } else if (ASTAL_WP_IS_DEVICE(key)) {
+            g_string_append(buffer, "{\"event\":\"device-changed\"");
+            json_key("device");
+            write_device(key);
+            g_string_append_c(buffer, '}');
+        } else {
+            g_string_append(buffer, "{\"event\":\"default\"");
+            write_defaults();
+            g_string_append_c(buffer, '}');
+        }
+        write_line();
+    }
+
+    g_hash_table_remove_all(dirty);
+    flush_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void mark_dirty(gpointer object, Dirty flag) {
+    if (!ready) return;
+
+    guint flags = GPOINTER_TO_UINT(g_hash_table_lookup(dirty, object));
+    // the table owns a reference to every key, inserting an existing key drops the new one
+    g_hash_table_insert(dirty, g_object_ref(object), GUINT_TO_POINTER(flags | flag));
+
+    if (flush_id == 0) flush_id = g_idle_add(flush, NULL);
+}
+
+static void endpoint_volume_changed(AstalWpEndpoint *endpoint) {
+    mark_dirty(endpoint, DIRTY_VOLUME);
+}
+
+static void endpoint_properties_changed(AstalWpEndpoint *endpoint) {
+    mark_dirty(endpoint, DIRTY_PROPERTIES);
+}
+
+static void device_changed(AstalWpDevice *device) { mark_dirty(device, DIRTY_PROPERTIES); }
+
+static void default_changed() { mark_dirty(wp, DIRTY_PROPERTIES); }
+
+static void watch_endpoint(AstalWpEndpoint *endpoint) {
+    g_signal_connect(endpoint, "notify::volume", G_CALLBACK(endpoint_volume_changed), NULL);
+    g_signal_connect(endpoint, "notify::mute", G_CALLBACK(endpoint_volume_changed), NULL);
+    g_signal_connect(endpoint, "notify::description", G_CALLBACK(endpoint_properties_changed),
+                     NULL);
+    g_signal_connect(endpoint, "notify::name", G_CALLBACK(endpoint_properties_changed), NULL);
+    g_signal_connect(endpoint, "notify::icon", G_CALLBACK(endpoint_properties_changed), NULL);
+    g_signal_connect(endpoint, "notify::is-default", G_CALLBACK(endpoint_properties_changed),
+                     NULL);
+}
+
+static void watch_device(AstalWpDevice *device) {
+    g_signal_connect(device, "notify::description", G_CALLBACK(device_changed), NULL);
+    g_signal_connect(device, "notify::icon", G_CALLBACK(device_changed), NULL);
+    g_signal_connect(device, "notify::active-profile-id", G_CALLBACK(device_changed), NULL);
+}
+
+static void unwatch(gpointer object) {
+    g_signal_handlers_disconnect_by_func(object, endpoint_volume_changed, NULL);
+    g_signal_handlers_disconnect_by_func(object, endpoint_properties_changed, NULL);
+    g_signal_handlers_disconnect_by_func(object, device_changed, NULL);
+    g_hash_table_remove(dirty, object);
+}
+
+static void endpoint_added(AstalWpWp *wp, AstalWpEndpoint *endpoint) {
+    watch_endpoint(endpoint);
+    if (!ready) return;
+
+    g_string_append(buffer, "{\"event\":\"endpoint-added\"");
+    json_key("endpoint");
+    write_endpoint(endpoint);
+    g_string_append_c(buffer, '}');
+    write_line();
+}
+
+static void endpoint_removed(AstalWpWp *wp, AstalWpEndpoint *endpoint) {
+    unwatch(endpoint);
+    if (!ready) return;
+
+    g_string_append(buffer, "{\"event\":\"endpoint-removed\"");
+    json_uint("id", astal_wp_endpoint_get_id(endpoint));
+    g_string_append_c(buffer, '}');
+    write_line();
+}
+
+static void device_added(AstalWpWp *wp, AstalWpDevice *device) {
+    watch_device(device);
+    if (!ready) return;
+
+    g_string_append(buffer, "{\"event\":\"device-added\"");
+    json_key("device");
+    write_device(device);
+    g_string_append_c(buffer, '}');
+    write_line();
+}
+
+static void device_removed(AstalWpWp *wp, AstalWpDevice *device) {
+    unwatch(device);
+    if (!ready) return;
+
+    g_string_append(buffer, "{\"event\":\"device-removed\"");
+    json_uint("id", astal_wp_device_get_id(device));
+    g_string_append_c(buffer, '}');
+    write_line();
+}
+
+static void wp_ready() {
+    write_snapshot();
+    ready = TRUE;
+
+    g_signal_connect(astal_wp_wp_get_default_speaker(wp), "notify::id",
+                     G_CALLBACK(default_changed), NULL);
+    g_signal_connect(astal_wp_wp_get_default_microphone(wp), "notify::id",
+                     G_CALLBACK(default_changed), NULL);
+}
+
+static void write_event_latency(AstalWpEventKind kind) {
+    static const gdouble percentiles[] = {50, 90, 99, 99.9};
+    static const gchar *keys[] = {"p50", "p90", "p99", "p999"};
+
+    GEnumClass *enum_class = g_type_class_ref(ASTAL_WP_TYPE_EVENT_KIND);
+    json_key(g_enum_get_value(enum_class, kind)->value_nick);
+    g_type_class_unref(enum_class);
+
+    g_string_append_c(buffer, '{');
+    json_key("count");
+    g_string_append_printf(buffer, "%" G_GUINT64_FORMAT, astal_wp_wp_get_event_count(wp, kind));
+    for (guint i = 0; i < G_N_ELEMENTS(percentiles); i++)
+        json_double(keys[i], astal_wp_wp_get_event_latency(wp, kind, percentiles[i]));
+    json_double("max", astal_wp_wp_get_event_latency_max(wp, kind));
+    g_string_append_c(buffer, '}');
+}
+
+// latencies are in milliseconds and cover every event since the previous line
+static gboolean write_latency(gpointer user_data) {
+    g_string_append(buffer, "{\"event\":\"latency\"");
+    write_event_latency(ASTAL_WP_EVENT_OBJECT);
+    write_event_latency(ASTAL_WP_EVENT_MIXER);
+    write_event_latency(ASTAL_WP_EVENT_DEFAULT);
+    write_event_latency(ASTAL_WP_EVENT_PARAMS);
+    g_string_append_c(buffer, '}');
+    write_line();
+
+    astal_wp_wp_reset_event_latency(wp);
+    return G_SOURCE_CONTINUE;
+}
+
+static void replay_finished(GMainLoop *loop) {
+    if (flush_id != 0) {
+        g_source_remove(flush_id);
+        flush(NULL);
+    }
+    g_main_loop_quit(loop);
+}
+
+// leaves the main loop on SIGINT or SIGTERM so main can close an active recording
+static gboolean quit(gpointer user_data) {
+    g_main_loop_quit(user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean service = FALSE;
+static gboolean shared_state = FALSE;
+static gchar *record = NULL;
+static gchar *replay = NULL;
+static gdouble replay_speed = 1;
+static gint latency_interval = 0;
+
+static GOptionEntry entries[] = {
+    {"service", 's', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &service,
+     "Export the graph on the session bus for other processes to mirror", NULL},
+    {"shared-state", 'm', G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE, &shared_state,
+     "Publish the endpoint state in a shared memory table", NULL},
+    {"record", 'r', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &record,
+     "Record every event into a journal", "FILE"},
+    {"replay", 'p', G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME, &replay,
+     "Replay a journal instead of connecting to PipeWire", "FILE"},
+    {"speed", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_DOUBLE, &replay_speed,
+     "Scale the timing of the replayed journal, 0 replays as fast as possible", "FACTOR"},
+    {"latency", 'l', G_OPTION_FLAG_NONE, G_OPTION_ARG_INT, &latency_interval,
+     "Print the event latency histograms every SECONDS", "SECONDS"},
+    {NULL},
+};
+
+int main(int argc, char **argv) {
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new("- monitor PipeWire through wireplumber");
+    g_option_context_add_main_entries(context, entries, NULL);
+
+    if (!g_option_context_parse(context, &argc, &argv, &error)) {
+        g_printerr("%s\n", error->message);
+        g_error_free(error);
+        g_option_context_free(context);
+        return 1;
+    }
+    g_option_context_free(context);
+
+    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+
+    buffer = g_string_sized_new(4096);
+    dirty = g_hash_table_new_full(g_direct_hash, g_direct_equal, g_object_unref, NULL);
+
+    wp = replay != NULL ? astal_wp_wp_new_for_journal(replay, replay_speed)
+                        : astal_wp_wp_get_default();
+    if (wp == NULL) {
+        g_printerr("could not connect to wireplumber\n");
+        return 1;
+    }
+
+    g_signal_connect(wp, "endpoint-added", G_CALLBACK(endpoint_added), NULL);
+    g_signal_connect(wp, "endpoint-removed", G_CALLBACK(endpoint_removed), NULL);
+    g_signal_connect(wp, "device-added", G_CALLBACK(device_added), NULL);
+    g_signal_connect(wp, "device-removed", G_CALLBACK(device_removed), NULL);
+    g_signal_connect(wp, "ready", G_CALLBACK(wp_ready), NULL);
+
+    if (service) astal_wp_wp_export(wp);
+    if (shared_state) astal_wp_wp_set_shared_state(wp, TRUE);
+    if (replay != NULL)
+        g_signal_connect_swapped(wp, "replay-finished", G_CALLBACK(replay_finished), loop);
+    if (latency_interval > 0) g_timeout_add_seconds(latency_interval, write_latency, NULL);
+
+    if (record != NULL && !astal_wp_wp_start_recording(wp, record, &error)) {
+        g_printerr("%s\n", error->message);
+        g_error_free(error);
+        return 1;
+    }
+
+    g_unix_signal_add(SIGINT, quit, loop);
+    g_unix_signal_add(SIGTERM, quit, loop);
+    g_main_loop_run(loop);
+
+    // the objects in dirty belong to the instance, so they are released before it
+    g_hash_table_destroy(dirty);
+    if (record != NULL) astal_wp_wp_stop_recording(wp);
+    // the default instance is owned by the library, only a replay instance belongs to main
+    if (replay != NULL) g_object_unref(wp);
+    g_main_loop_unref(loop);
+    g_string_free(buffer, TRUE);
+    return 0;
+}
@@ -7,6 +7,9 @@
 #include "glib-object.h"
 #include "wp.h"
 
+#include "audio-private.h"
+#include "wp-private.h"
+
 struct _AstalWpAudio {
     GObject parent_instance;
 };
@@ -147,7 +150,7 @@ AstalWpDevice *astal_wp_audio_get_device(AstalWpAudio *self, guint id) {
  */
 GList *astal_wp_audio_get_microphones(AstalWpAudio *self) {
     AstalWpAudioPrivate *priv = astal_wp_audio_get_instance_private(self);
-    GList *eps = astal_wp_wp_get_endpoints(priv->wp);
+    GList *eps = astal_wp_wp_peek_endpoints(priv->wp);
     GList *mics = NULL;
 
     for (GList *l = eps; l != NULL; l = l->next) {
@@ -169,7 +172,7 @@ GList *astal_wp_audio_get_microphones(AstalWpAudio *self) {
  */
 GList *astal_wp_audio_get_speakers(AstalWpAudio *self) {
     AstalWpAudioPrivate *priv = astal_wp_audio_get_instance_private(self);
-    GList *eps = astal_wp_wp_get_endpoints(priv->wp);
+    GList *eps = astal_wp_wp_peek_endpoints(priv->wp);
     GList *speakers = NULL;
 
     for (GList *l = eps; l != NULL; l = l->next) {
@@ -319,84 +322,99 @@ static void astal_wp_audio_get_property(GObject *object, guint property_id, GVal
     }
 }
 
-static void astal_wp_audio_device_added(AstalWpAudio *self, gpointer object) {
-    AstalWpDevice *device = ASTAL_WP_DEVICE(object);
+// collection notifies are held back while the instance is in a batch
+static void astal_wp_audio_notify_collection(AstalWpAudio *self, const gchar *property) {
+    AstalWpAudioPrivate *priv = astal_wp_audio_get_instance_private(self);
+    astal_wp_wp_notify_collection(priv->wp, G_OBJECT(self), property);
+}
+
+void astal_wp_audio_device_added(AstalWpAudio *self, AstalWpDevice *device) {
     if (astal_wp_device_get_device_type(device) == ASTAL_WP_DEVICE_TYPE_AUDIO) {
         g_signal_emit_by_name(self, "device-added", device);
-        g_object_notify(G_OBJECT(self), "devices");
+        astal_wp_audio_notify_collection(self, "devices");
     }
 }
 
-static void astal_wp_audio_device_removed(AstalWpAudio *self, gpointer object) {
-    AstalWpDevice *device = ASTAL_WP_DEVICE(object);
+void astal_wp_audio_device_removed(AstalWpAudio *self, AstalWpDevice *device) {
     if (astal_wp_device_get_device_type(device) == ASTAL_WP_DEVICE_TYPE_AUDIO) {
         g_signal_emit_by_name(self, "device-removed", device);
-        g_object_notify(G_OBJECT(self), "devices");
+        astal_wp_audio_notify_collection(self, "devices");
     }
 }
 
-static void astal_wp_audio_object_added(AstalWpAudio *self, gpointer object) {
-    AstalWpEndpoint *endpoint = ASTAL_WP_ENDPOINT(object);
+void astal_wp_audio_endpoint_added(AstalWpAudio *self, AstalWpEndpoint *endpoint) {
     switch (astal_wp_endpoint_get_media_class(endpoint)) {
         case ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE:
             g_signal_emit_by_name(self, "microphone-added", endpoint);
-            g_object_notify(G_OBJECT(self), "microphones");
+            astal_wp_audio_notify_collection(self, "microphones");
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER:
             g_signal_emit_by_name(self, "speaker-added", endpoint);
-            g_object_notify(G_OBJECT(self), "speakers");
+            astal_wp_audio_notify_collection(self, "speakers");
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_STREAM:
             g_signal_emit_by_name(self, "stream-added", endpoint);
-            g_object_notify(G_OBJECT(self), "streams");
+            astal_wp_audio_notify_collection(self, "streams");
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_RECORDER:
             g_signal_emit_by_name(self, "recorder-added", endpoint);
-            g_object_notify(G_OBJECT(self), "recorders");
+            astal_wp_audio_notify_collection(self, "recorders");
             break;
         default:
             break;
     }
 }
 
-static void astal_wp_audio_object_removed(AstalWpAudio *self, gpointer object) {
-    AstalWpEndpoint *endpoint = ASTAL_WP_ENDPOINT(object);
+void astal_wp_audio_endpoint_removed(AstalWpAudio *self, AstalWpEndpoint *endpoint) {
     switch (astal_wp_endpoint_get_media_class(endpoint)) {
         case ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE:
             g_signal_emit_by_name(self, "microphone-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "microphones");
+            astal_wp_audio_notify_collection(self, "microphones");
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER:
             g_signal_emit_by_name(self, "speaker-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "speakers");
+            astal_wp_audio_notify_collection(self, "speakers");
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_STREAM:
             g_signal_emit_by_name(self, "stream-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "streams");
+            astal_wp_audio_notify_collection(self, "streams");
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_RECORDER:
             g_signal_emit_by_name(self, "recorder-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "recorders");
+            astal_wp_audio_notify_collection(self, "recorders");
             break;
         default:
             break;
     }
 }
 
+// whether anyone listens for streams or recorders being added or removed, or for the streams
+// and recorders properties to change
+gboolean astal_wp_audio_has_stream_handlers(AstalWpAudio *self) {
+    static const guint signals[] = {
+        ASTAL_WP_AUDIO_SIGNAL_STREAM_ADDED,
+        ASTAL_WP_AUDIO_SIGNAL_STREAM_REMOVED,
+        ASTAL_WP_AUDIO_SIGNAL_RECORDER_ADDED,
+        ASTAL_WP_AUDIO_SIGNAL_RECORDER_REMOVED,
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(signals); i++) {
+        if (g_signal_has_handler_pending(self, astal_wp_audio_signals[signals[i]], 0, FALSE))
+            return TRUE;
+    }
+
+    guint notify = g_signal_lookup("notify", G_TYPE_OBJECT);
+    return g_signal_has_handler_pending(self, notify, g_quark_from_static_string("streams"),
+                                        FALSE) ||
+           g_signal_has_handler_pending(self, notify, g_quark_from_static_string("recorders"),
+                                        FALSE);
+}
+
 AstalWpAudio *astal_wp_audio_new(AstalWpWp *wp) {
     AstalWpAudio *self = g_object_new(ASTAL_WP_TYPE_AUDIO, NULL);
     AstalWpAudioPrivate *priv = astal_wp_audio_get_instance_private(self);
     priv->wp = g_object_ref(wp);
 
-    g_signal_connect_swapped(priv->wp, "endpoint-added", G_CALLBACK(astal_wp_audio_object_added),
-                             self);
-    g_signal_connect_swapped(priv->wp, "endpoint-removed",
-                             G_CALLBACK(astal_wp_audio_object_removed), self);
-    g_signal_connect_swapped(priv->wp, "device-added", G_CALLBACK(astal_wp_audio_device_added),
-                             self);
-    g_signal_connect_swapped(priv->wp, "device-removed", G_CALLBACK(astal_wp_audio_device_removed),
-                             self);
-
     return self;
 }
 
@@ -0,0 +1,428 @@
+#include "client.h"
+
+#include <wp/wp.h>
+
+#include "client-private.h"
+#include "endpoint-private.h"
+#include "endpoint.h"
+#include "wp-private.h"
+
+struct _AstalWpClient {
+    GObject parent_instance;
+
+    guint id;
+    gchar *name;
+    gchar *icon;
+    gchar *binary;
+    gint pid;
+
+    gdouble volume;
+    gboolean mute;
+};
+
+typedef struct {
+    WpClient *client;
+    AstalWpWp *wp;
+    GPtrArray *streams;
+    // changes of the streams are coalesced, the aggregate is recomputed once per main loop
+    // iteration
+    guint update_id;
+} AstalWpClientPrivate;
+
+G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpClient, astal_wp_client, G_TYPE_OBJECT);
+
+typedef enum {
+    ASTAL_WP_CLIENT_PROP_ID = 1,
+    ASTAL_WP_CLIENT_PROP_NAME,
+    ASTAL_WP_CLIENT_PROP_ICON,
+    ASTAL_WP_CLIENT_PROP_BINARY,
+    ASTAL_WP_CLIENT_PROP_PID,
+    ASTAL_WP_CLIENT_PROP_STREAMS,
+    ASTAL_WP_CLIENT_PROP_VOLUME,
+    ASTAL_WP_CLIENT_PROP_MUTE,
+    ASTAL_WP_CLIENT_N_PROPERTIES,
+} AstalWpClientProperties;
+
+static GParamSpec *astal_wp_client_properties[ASTAL_WP_CLIENT_N_PROPERTIES] = {
+    NULL,
+};
+
+/**
+ * astal_wp_client_get_id
+ * @self: the AstalWpClient object
+ *
+ * gets the id of this client
+ *
+ */
+guint astal_wp_client_get_id(AstalWpClient *self) { return self->id; }
+
+/**
+ * astal_wp_client_get_name
+ * @self: the AstalWpClient object
+ *
+ * gets the application name of this client
+ *
+ */
+const gchar *astal_wp_client_get_name(AstalWpClient *self) { return self->name; }
+
+/**
+ * astal_wp_client_get_icon
+ * @self: the AstalWpClient object
+ *
+ * gets the icon name of this client
+ *
+ */
+const gchar *astal_wp_client_get_icon(AstalWpClient *self) { return self->icon; }
+
+/**
+ * astal_wp_client_get_binary
+ * @self: the AstalWpClient object
+ *
+ * gets the name of the binary of this client
+ *
+ */
+const gchar *astal_wp_client_get_binary(AstalWpClient *self) { return self->binary; }
+
+/**
+ * astal_wp_client_get_pid
+ * @self: the AstalWpClient object
+ *
+ * gets the process id of this client, or 0 if it is unknown
+ *
+ */
+gint astal_wp_client_get_pid(AstalWpClient *self) { return self->pid; }
+
+/**
+ * astal_wp_client_get_streams
+ * @self: the AstalWpClient object
+ *
+ * gets the audio streams and recorders of this client
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpEndpoint))
+ */
+GList *astal_wp_client_get_streams(AstalWpClient *self) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    GList *list = NULL;
+    for (guint i = priv->streams->len; i > 0; i--)
+        list = g_list_prepend(list, priv->streams->pdata[i - 1]);
+    return list;
+}
+
+/**
+ * astal_wp_client_get_volume
+ * @self: the AstalWpClient object
+ *
+ * gets the volume of the loudest stream of this client
+ *
+ */
+gdouble astal_wp_client_get_volume(AstalWpClient *self) { return self->volume; }
+
+/**
+ * astal_wp_client_set_volume
+ * @self: the AstalWpClient object
+ * @volume: The new volume level to set.
+ *
+ * Sets the volume of all streams of this client. The balance between the streams is kept, so the
+ * loudest stream ends up at the given volume.
+ */
+void astal_wp_client_set_volume(AstalWpClient *self, gdouble volume) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    // the balance is kept on linear volumes, the streams may be in a logarithmic scale
+    gdouble loudest = 0;
+    for (guint i = 0; i < priv->streams->len; i++) {
+        gdouble linear =
+            astal_wp_endpoint_get_volume_in_scale(priv->streams->pdata[i], ASTAL_WP_SCALE_LINEAR);
+        if (linear > loudest) loudest = linear;
+    }
+
+    for (guint i = 0; i < priv->streams->len; i++) {
+        AstalWpEndpoint *stream = priv->streams->pdata[i];
+        gdouble target = astal_wp_endpoint_convert_volume(stream, volume, TRUE);
+        gdouble linear = astal_wp_endpoint_get_volume_in_scale(stream, ASTAL_WP_SCALE_LINEAR);
+        if (loudest != 0) target = linear * target / loudest;
+        astal_wp_endpoint_set_volume(stream,
+                                     astal_wp_endpoint_convert_volume(stream, target, FALSE));
+    }
+}
+
+/**
+ * astal_wp_client_get_mute
+ * @self: the AstalWpClient object
+ *
+ * whether all streams of this client are muted
+ *
+ */
+gboolean astal_wp_client_get_mute(AstalWpClient *self) { return self->mute; }
+
+/**
+ * astal_wp_client_set_mute
+ * @self: the AstalWpClient object
+ * @mute: A boolean indicating whether to mute the client.
+ *
+ * Sets the mute status of all streams of this client.
+ */
+void astal_wp_client_set_mute(AstalWpClient *self, gboolean mute) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    for (guint i = 0; i < priv->streams->len; i++) {
+        astal_wp_endpoint_set_mute(priv->streams->pdata[i], mute);
+    }
+}
+
+static gboolean astal_wp_client_update_aggregate(AstalWpClient *self) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+    priv->update_id = 0;
+
+    gdouble volume = 0;
+    gdouble loudest = -1;
+    gboolean mute = priv->streams->len > 0;
+
+    for (guint i = 0; i < priv->streams->len; i++) {
+        AstalWpEndpoint *stream = priv->streams->pdata[i];
+        gdouble linear = astal_wp_endpoint_get_volume_in_scale(stream, ASTAL_WP_SCALE_LINEAR);
+        if (linear > loudest) {
+            loudest = linear;
+            volume = astal_wp_endpoint_get_volume(stream);
+        }
+        if (!astal_wp_endpoint_get_mute(stream)) mute = FALSE;
+    }
+
+    if (mute != self->mute) {
+        self->mute = mute;
+        g_object_notify(G_OBJECT(self), "mute");
+    }
+
+    if (volume != self->volume) {
+        self->volume = volume;
+        g_object_notify(G_OBJECT(self), "volume");
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void astal_wp_client_queue_update(AstalWpClient *self) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    if (priv->update_id == 0)
+        priv->update_id = astal_wp_wp_idle_add(priv->wp, G_PRIORITY_DEFAULT_IDLE,
+                                               (GSourceFunc)astal_wp_client_update_aggregate, self);
+}
+
+void astal_wp_client_add_stream(AstalWpClient *self, AstalWpEndpoint *stream) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    g_ptr_array_add(priv->streams, g_object_ref(stream));
+    g_signal_connect_swapped(stream, "notify::volume", G_CALLBACK(astal_wp_client_queue_update),
+                             self);
+    g_signal_connect_swapped(stream, "notify::mute", G_CALLBACK(astal_wp_client_queue_update),
+                             self);
+
+    astal_wp_client_queue_update(self);
+    g_object_notify(G_OBJECT(self), "streams");
+}
+
+void astal_wp_client_remove_stream(AstalWpClient *self, AstalWpEndpoint *stream) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    g_signal_handlers_disconnect_by_data(stream, self);
+    if (!g_ptr_array_remove_fast(priv->streams, stream)) return;
+
+    astal_wp_client_queue_update(self);
+    g_object_notify(G_OBJECT(self), "streams");
+}
+
+static void astal_wp_client_get_property(GObject *object, guint property_id, GValue *value,
+                                         GParamSpec *pspec) {
+    AstalWpClient *self = ASTAL_WP_CLIENT(object);
+
+    switch (property_id) {
+        case ASTAL_WP_CLIENT_PROP_ID:
+            g_value_set_uint(value, self->id);
+            break;
+        case ASTAL_WP_CLIENT_PROP_NAME:
+            g_value_set_string(value, self->name);
+            break;
+        case ASTAL_WP_CLIENT_PROP_ICON:
+            g_value_set_string(value, self->icon);
+            break;
+        case ASTAL_WP_CLIENT_PROP_BINARY:
+            g_value_set_string(value, self->binary);
+            break;
+        case ASTAL_WP_CLIENT_PROP_PID:
+            g_value_set_int(value, self->pid);
+            break;
+        case ASTAL_WP_CLIENT_PROP_STREAMS:
+            g_value_set_pointer(value, astal_wp_client_get_streams(self));
+            break;
+        case ASTAL_WP_CLIENT_PROP_VOLUME:
+            g_value_set_double(value, self->volume);
+            break;
+        case ASTAL_WP_CLIENT_PROP_MUTE:
+            g_value_set_boolean(value, self->mute);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+static void astal_wp_client_set_property(GObject *object, guint property_id, const GValue *value,
+                                         GParamSpec *pspec) {
+    AstalWpClient *self = ASTAL_WP_CLIENT(object);
+
+    switch (property_id) {
+        case ASTAL_WP_CLIENT_PROP_VOLUME:
+            astal_wp_client_set_volume(self, g_value_get_double(value));
+            break;
+        case ASTAL_WP_CLIENT_PROP_MUTE:
+            astal_wp_client_set_mute(self, g_value_get_boolean(value));
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+static void astal_wp_client_update_properties(AstalWpClient *self) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+    if (priv->client == NULL) return;
+    self->id = wp_proxy_get_bound_id(WP_PROXY(priv->client));
+
+    const gchar *binary = wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->client),
+                                                          "application.process.binary");
+    g_free(self->binary);
+    self->binary = g_strdup(binary);
+
+    const gchar *name =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->client), "application.name");
+    if (name == NULL) name = binary;
+    g_free(self->name);
+    self->name = g_strdup(name);
+
+    const gchar *icon =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->client), "application.icon-name");
+    if (icon == NULL) icon = "application-x-executable-symbolic";
+    g_free(self->icon);
+    self->icon = g_strdup(icon);
+
+    const gchar *pid =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->client), "application.process.id");
+    self->pid = pid != NULL ? g_ascii_strtoll(pid, NULL, 10) : 0;
+}
+
+AstalWpClient *astal_wp_client_create(WpClient *client, AstalWpWp *wp) {
+    AstalWpClient *self = g_object_new(ASTAL_WP_TYPE_CLIENT, NULL);
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    priv->client = g_object_ref(client);
+    priv->wp = wp;
+
+    astal_wp_client_update_properties(self);
+    return self;
+}
+
+static void astal_wp_client_init(AstalWpClient *self) {
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+    priv->client = NULL;
+    priv->wp = NULL;
+    priv->streams = g_ptr_array_new_with_free_func(g_object_unref);
+
+    self->name = NULL;
+    self->icon = NULL;
+    self->binary = NULL;
+    self->volume = 0;
+    self->mute = FALSE;
+}
+
+static void astal_wp_client_dispose(GObject *object) {
+    AstalWpClient *self = ASTAL_WP_CLIENT(object);
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    for (guint i = 0; i < priv->streams->len; i++) {
+        g_signal_handlers_disconnect_by_data(priv->streams->pdata[i], self);
+    }
+    g_ptr_array_set_size(priv->streams, 0);
+
+    if (priv->wp != NULL) astal_wp_wp_clear_source(priv->wp, &priv->update_id);
+    g_clear_object(&priv->client);
+}
+
+static void astal_wp_client_finalize(GObject *object) {
+    AstalWpClient *self = ASTAL_WP_CLIENT(object);
+    AstalWpClientPrivate *priv = astal_wp_client_get_instance_private(self);
+
+    g_ptr_array_unref(priv->streams);
+    g_free(self->name);
+    g_free(self->icon);
+    g_free(self->binary);
+}
+
+static void astal_wp_client_class_init(AstalWpClientClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->dispose = astal_wp_client_dispose;
+    object_class->finalize = astal_wp_client_finalize;
+    object_class->get_property = astal_wp_client_get_property;
+    object_class->set_property = astal_wp_client_set_property;
+
+    /**
+     * AstalWpClient:id
+     *
+     * The id of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_ID] =
+        g_param_spec_uint("id", "id", "id", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpClient:name
+     *
+     * The application name of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_NAME] =
+        g_param_spec_string("name", "name", "name", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpClient:icon
+     *
+     * The icon name of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_ICON] =
+        g_param_spec_string("icon", "icon", "icon", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpClient:binary
+     *
+     * The name of the binary of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_BINARY] =
+        g_param_spec_string("binary", "binary", "binary", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpClient:pid
+     *
+     * The process id of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_PID] =
+        g_param_spec_int("pid", "pid", "pid", 0, G_MAXINT, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpClient:streams: (type GList(AstalWpEndpoint)) (transfer container)
+     *
+     * The audio streams and recorders of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_STREAMS] =
+        g_param_spec_pointer("streams", "streams", "streams", G_PARAM_READABLE);
+    /**
+     * AstalWpClient:volume
+     *
+     * The volume of the loudest stream of this client.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_VOLUME] =
+        g_param_spec_double("volume", "volume", "volume", ASTAL_WP_SCALE_DECIBEL_MIN, G_MAXFLOAT, 0,
+                            G_PARAM_READWRITE);
+    /**
+     * AstalWpClient:mute
+     *
+     * Whether all streams of this client are muted.
+     */
+    astal_wp_client_properties[ASTAL_WP_CLIENT_PROP_MUTE] =
+        g_param_spec_boolean("mute", "mute", "mute", FALSE, G_PARAM_READWRITE);
+
+    g_object_class_install_properties(object_class, ASTAL_WP_CLIENT_N_PROPERTIES,
+                                      astal_wp_client_properties);
+}
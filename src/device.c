@@ -1,7 +1,11 @@
+#include <string.h>
 #include <wp/wp.h>
 
 #include "device-private.h"
-#include "profile.h"
+#include "pending-private.h"
+#include "profile-private.h"
+#include "route-private.h"
+#include "wp-private.h"
 
 struct _AstalWpDevice {
     GObject parent_instance;
@@ -14,8 +18,29 @@ struct _AstalWpDevice {
 };
 
 typedef struct {
+    // NULL for devices created by a replay, which only know the properties and params
     WpDevice *device;
-    GHashTable *profiles;
+    WpProperties *properties;
+    // param name -> GPtrArray of the WpSpaPods a replay reported, NULL until then
+    GHashTable *params;
+    // shared with the devices which enumerate the same profiles, NULL until they are known
+    AstalWpProfileSet *profiles;
+    // AstalWpAvailability of each profile, in the order of the set
+    GArray *profile_available;
+    // the profiles which are not unavailable, highest priority first. Rebuilt with the profiles
+    GPtrArray *available_profiles;
+    // index -> AstalWpRoute, updated in place when the routes change
+    GHashTable *routes;
+    // the endpoints of this device, shared with the index of the AstalWpWp
+    GPtrArray *endpoints;
+
+    // set for devices mirrored from another process, not owned
+    AstalWpWp *remote;
+    // the instance a device bound to PipeWire belongs to, not owned
+    AstalWpWp *wp;
+
+    // an optimistic profile change waiting for PipeWire, see AstalWpWp:optimistic
+    AstalWpPendingWrite pending_profile;
 } AstalWpDevicePrivate;
 
 G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpDevice, astal_wp_device, G_TYPE_OBJECT);
@@ -31,6 +56,8 @@ typedef enum {
     ASTAL_WP_DEVICE_PROP_PROFILES,
     ASTAL_WP_DEVICE_PROP_ACTIVE_PROFILE,
     ASTAL_WP_DEVICE_PROP_DEVICE_TYPE,
+    ASTAL_WP_DEVICE_PROP_ROUTES,
+    ASTAL_WP_DEVICE_PROP_ENDPOINTS,
     ASTAL_WP_DEVICE_N_PROPERTIES,
 } AstalWpDeviceProperties;
 
@@ -86,6 +113,40 @@ AstalWpDeviceType astal_wp_device_get_device_type(AstalWpDevice *self) { return
  */
 gint astal_wp_device_get_active_profile(AstalWpDevice *self) { return self->active_profile; }
 
+static void astal_wp_device_write_profile(AstalWpDevice *self, gint profile_id, GTask *task) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    if (priv->remote != NULL) {
+        astal_wp_wp_remote_command(priv->remote, "SetProfile",
+                                   g_variant_new("(ui)", self->id, profile_id));
+        astal_wp_pending_begin(&priv->pending_profile, priv->remote, self->active_profile,
+                               profile_id, FALSE, task);
+        return;
+    }
+    if (priv->device == NULL) {
+        if (task != NULL)
+            g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                                    "device %u is replayed from a journal", self->id);
+        return;
+    }
+
+    WpSpaPodBuilder *builder =
+        wp_spa_pod_builder_new_object("Spa:Pod:Object:Param:Profile", "Profile");
+    wp_spa_pod_builder_add_property(builder, "index");
+    wp_spa_pod_builder_add_int(builder, profile_id);
+    WpSpaPod *pod = wp_spa_pod_builder_end(builder);
+    wp_pipewire_object_set_param(WP_PIPEWIRE_OBJECT(priv->device), "Profile", 0, pod);
+
+    wp_spa_pod_builder_unref(builder);
+
+    gboolean optimistic = priv->wp != NULL && astal_wp_wp_get_optimistic(priv->wp);
+    if (!astal_wp_pending_begin(&priv->pending_profile, priv->wp, self->active_profile,
+                                profile_id, optimistic, task))
+        return;
+    self->active_profile = profile_id;
+    g_object_notify(G_OBJECT(self), "active-profile-id");
+}
+
 /**
  * astal_wp_device_set_active_profile
  * @self: the AstalWpDevice object
@@ -95,16 +156,44 @@ gint astal_wp_device_get_active_profile(AstalWpDevice *self) { return self->acti
  *
  */
 void astal_wp_device_set_active_profile(AstalWpDevice *self, int profile_id) {
-    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    astal_wp_device_write_profile(self, profile_id, NULL);
+}
 
-    WpSpaPodBuilder *builder =
-        wp_spa_pod_builder_new_object("Spa:Pod:Object:Param:Profile", "Profile");
-    wp_spa_pod_builder_add_property(builder, "index");
-    wp_spa_pod_builder_add_int(builder, profile_id);
-    WpSpaPod *pod = wp_spa_pod_builder_end(builder);
-    wp_pipewire_object_set_param(WP_PIPEWIRE_OBJECT(priv->device), "Profile", 0, pod);
+/**
+ * astal_wp_device_set_active_profile_async:
+ * @self: the AstalWpDevice object
+ * @profile_id: the id of the profile
+ * @cancellable: (nullable): a GCancellable
+ * @callback: (scope async): called once PipeWire reported the profile as active
+ * @user_data: data passed to @callback
+ *
+ * Like astal_wp_device_set_active_profile, but completes once PipeWire reports the profile as
+ * the active one. The write fails with G_IO_ERROR_TIMED_OUT when it is not reported within a
+ * second.
+ */
+void astal_wp_device_set_active_profile_async(AstalWpDevice *self, gint profile_id,
+                                              GCancellable *cancellable,
+                                              GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = g_task_new(self, cancellable, callback, user_data);
+    g_task_set_source_tag(task, astal_wp_device_set_active_profile_async);
+    astal_wp_device_write_profile(self, profile_id, task);
+    g_object_unref(task);
+}
 
-    wp_spa_pod_builder_unref(builder);
+/**
+ * astal_wp_device_set_active_profile_finish:
+ * @self: the AstalWpDevice object
+ * @result: the GAsyncResult passed to the callback
+ * @round_trip: (out) (optional): the time in microseconds between the write and its report
+ * @error: return location for an error
+ *
+ * Finishes astal_wp_device_set_active_profile_async.
+ *
+ * Returns: whether the profile was reported as active
+ */
+gboolean astal_wp_device_set_active_profile_finish(AstalWpDevice *self, GAsyncResult *result,
+                                                   gint64 *round_trip, GError **error) {
+    return astal_wp_pending_finish(self, result, round_trip, error);
 }
 
 /**
@@ -119,7 +208,8 @@ void astal_wp_device_set_active_profile(AstalWpDevice *self, int profile_id) {
 AstalWpProfile *astal_wp_device_get_profile(AstalWpDevice *self, gint id) {
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
 
-    return g_hash_table_lookup(priv->profiles, GINT_TO_POINTER(id));
+    if (priv->profiles == NULL) return NULL;
+    return astal_wp_profile_set_lookup(priv->profiles, id);
 }
 
 /**
@@ -132,7 +222,178 @@ AstalWpProfile *astal_wp_device_get_profile(AstalWpDevice *self, gint id) {
  */
 GList *astal_wp_device_get_profiles(AstalWpDevice *self) {
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
-    return g_hash_table_get_values(priv->profiles);
+    if (priv->profiles == NULL) return NULL;
+    return astal_wp_profile_set_list(priv->profiles);
+}
+
+/**
+ * astal_wp_device_get_profile_available:
+ * @self: the AstalWpDevice object
+ * @id: the id of the profile
+ *
+ * gets whether the profile with the given id can currently be used, for example whether the
+ * jacks it needs are plugged in
+ */
+AstalWpAvailability astal_wp_device_get_profile_available(AstalWpDevice *self, gint id) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    gint position = priv->profiles != NULL ? astal_wp_profile_set_find(priv->profiles, id) : -1;
+    if (position < 0) return ASTAL_WP_AVAILABILITY_UNKNOWN;
+    return g_array_index(priv->profile_available, guint32, position);
+}
+
+/**
+ * astal_wp_device_get_available_profiles:
+ * @self: the AstalWpDevice object
+ *
+ * gets the profiles which are not unavailable, sorted by their priority with the highest first
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpProfile))
+ */
+GList *astal_wp_device_get_available_profiles(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    GList *list = NULL;
+    for (guint i = priv->available_profiles->len; i > 0; i--)
+        list = g_list_prepend(list, priv->available_profiles->pdata[i - 1]);
+    return list;
+}
+
+/**
+ * astal_wp_device_get_best_profile:
+ * @self: the AstalWpDevice object
+ *
+ * gets the available profile with the highest priority
+ *
+ * Returns: (transfer none) (nullable)
+ */
+AstalWpProfile *astal_wp_device_get_best_profile(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    if (priv->available_profiles->len == 0) return NULL;
+    return priv->available_profiles->pdata[0];
+}
+
+/**
+ * astal_wp_device_get_route:
+ * @self: the AstalWpDevice object
+ * @index: the index of the route
+ *
+ * gets the route with the given index
+ *
+ * Returns: (transfer none) (nullable)
+ */
+AstalWpRoute *astal_wp_device_get_route(AstalWpDevice *self, gint index) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    return g_hash_table_lookup(priv->routes, GINT_TO_POINTER(index));
+}
+
+/**
+ * astal_wp_device_get_routes:
+ * @self: the AstalWpDevice object
+ *
+ * gets a GList containing the routes, for example the speakers and the headphones of a card
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpRoute))
+ */
+GList *astal_wp_device_get_routes(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    return g_hash_table_get_values(priv->routes);
+}
+
+/**
+ * astal_wp_device_get_active_route:
+ * @self: the AstalWpDevice object
+ * @direction: the direction of the route
+ *
+ * gets the active route in the given direction
+ *
+ * Returns: (transfer none) (nullable)
+ */
+AstalWpRoute *astal_wp_device_get_active_route(AstalWpDevice *self, AstalWpDirection direction) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    GHashTableIter iter;
+    gpointer route;
+
+    g_hash_table_iter_init(&iter, priv->routes);
+    while (g_hash_table_iter_next(&iter, NULL, &route)) {
+        if (astal_wp_route_get_active(route) && astal_wp_route_get_direction(route) == direction)
+            return route;
+    }
+    return NULL;
+}
+
+/**
+ * astal_wp_device_set_active_route:
+ * @self: the AstalWpDevice object
+ * @route: a route of this device
+ *
+ * makes @route the active route of the card device it belongs to in the active profile. The
+ * choice is saved, so it is restored the next time the device is used.
+ *
+ */
+void astal_wp_device_set_active_route(AstalWpDevice *self, AstalWpRoute *route) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    gint index = astal_wp_route_get_index(route);
+
+    if (priv->remote != NULL) {
+        astal_wp_wp_remote_command(priv->remote, "SetRoute",
+                                   g_variant_new("(ui)", self->id, index));
+        return;
+    }
+    if (priv->device == NULL) return;
+
+    gint device = astal_wp_route_find_device(route, self->active_profile);
+    if (device < 0) {
+        g_warning("route %d of device %u is not part of the active profile", index, self->id);
+        return;
+    }
+
+    WpSpaPodBuilder *builder = wp_spa_pod_builder_new_object("Spa:Pod:Object:Param:Route", "Route");
+    wp_spa_pod_builder_add_property(builder, "index");
+    wp_spa_pod_builder_add_int(builder, index);
+    wp_spa_pod_builder_add_property(builder, "device");
+    wp_spa_pod_builder_add_int(builder, device);
+    wp_spa_pod_builder_add_property(builder, "save");
+    wp_spa_pod_builder_add_boolean(builder, TRUE);
+    WpSpaPod *pod = wp_spa_pod_builder_end(builder);
+    wp_pipewire_object_set_param(WP_PIPEWIRE_OBJECT(priv->device), "Route", 0, pod);
+
+    wp_spa_pod_builder_unref(builder);
+}
+
+/**
+ * astal_wp_device_get_endpoints:
+ * @self: the AstalWpDevice object
+ *
+ * gets a GList containing the endpoints of this device, like the speakers and microphones of a
+ * sound card
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpEndpoint))
+ */
+GList *astal_wp_device_get_endpoints(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    if (priv->endpoints == NULL) return NULL;
+
+    GList *list = NULL;
+    for (guint i = priv->endpoints->len; i > 0; i--)
+        list = g_list_prepend(list, priv->endpoints->pdata[i - 1]);
+    return list;
+}
+
+// shares the array the AstalWpWp keeps the endpoints with this device id in, NULL to unlink it
+void astal_wp_device_set_endpoints(AstalWpDevice *self, GPtrArray *endpoints) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    if (endpoints != NULL) g_ptr_array_ref(endpoints);
+    if (priv->endpoints != NULL) g_ptr_array_unref(priv->endpoints);
+    priv->endpoints = endpoints;
+    g_object_notify(G_OBJECT(self), "endpoints");
+}
+
+void astal_wp_device_endpoints_changed(AstalWpDevice *self) {
+    g_object_notify(G_OBJECT(self), "endpoints");
 }
 
 static void astal_wp_device_get_property(GObject *object, guint property_id, GValue *value,
@@ -158,6 +419,12 @@ static void astal_wp_device_get_property(GObject *object, guint property_id, GVa
         case ASTAL_WP_DEVICE_PROP_ACTIVE_PROFILE:
             g_value_set_int(value, self->active_profile);
             break;
+        case ASTAL_WP_DEVICE_PROP_ROUTES:
+            g_value_set_pointer(value, astal_wp_device_get_routes(self));
+            break;
+        case ASTAL_WP_DEVICE_PROP_ENDPOINTS:
+            g_value_set_pointer(value, astal_wp_device_get_endpoints(self));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -178,76 +445,456 @@ static void astal_wp_device_set_property(GObject *object, guint property_id, con
     }
 }
 
+static gint astal_wp_device_profile_compare(gconstpointer a, gconstpointer b) {
+    AstalWpProfile *profile_a = *(AstalWpProfile **)a;
+    AstalWpProfile *profile_b = *(AstalWpProfile **)b;
+
+    gint priority_a = astal_wp_profile_get_priority(profile_a);
+    gint priority_b = astal_wp_profile_get_priority(profile_b);
+    if (priority_a != priority_b) return priority_a > priority_b ? -1 : 1;
+    return astal_wp_profile_get_index(profile_a) - astal_wp_profile_get_index(profile_b);
+}
+
+// replaces the profiles with the interned set of @profiles, an a(issiua(su)) which is the set
+// with the availability of every profile after its priority. Floating references are sunk.
+static void astal_wp_device_set_profiles(AstalWpDevice *self, GVariant *profiles) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    g_variant_ref_sink(profiles);
+
+    GVariantBuilder key = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE(ASTAL_WP_PROFILE_SET_TYPE));
+    GArray *available = g_array_new(FALSE, FALSE, sizeof(guint32));
+
+    GVariantIter iter;
+    gint index, priority;
+    const gchar *name, *description;
+    guint32 availability;
+    GVariant *classes;
+    g_variant_iter_init(&iter, profiles);
+    while (g_variant_iter_next(&iter, "(i&s&siu@a(su))", &index, &name, &description, &priority,
+                               &availability, &classes)) {
+        g_variant_builder_add(&key, "(issi@a(su))", index, name, description, priority, classes);
+        g_array_append_val(available, availability);
+        g_variant_unref(classes);
+    }
+    g_variant_unref(profiles);
+
+    AstalWpProfileSet *set = astal_wp_profile_set_intern(g_variant_builder_end(&key));
+    if (set == priv->profiles && available->len == priv->profile_available->len &&
+        memcmp(available->data, priv->profile_available->data,
+               available->len * sizeof(guint32)) == 0) {
+        astal_wp_profile_set_unref(set);
+        g_array_unref(available);
+        return;
+    }
+
+    if (priv->profiles != NULL) astal_wp_profile_set_unref(priv->profiles);
+    priv->profiles = set;
+    g_array_unref(priv->profile_available);
+    priv->profile_available = available;
+
+    g_ptr_array_set_size(priv->available_profiles, 0);
+    for (guint i = 0; i < available->len; i++) {
+        if (g_array_index(available, guint32, i) != ASTAL_WP_AVAILABILITY_NO)
+            g_ptr_array_add(priv->available_profiles, astal_wp_profile_set_get(set, i));
+    }
+    g_ptr_array_sort(priv->available_profiles, astal_wp_device_profile_compare);
+
+    g_object_notify(G_OBJECT(self), "profiles");
+}
+
+// the classes of an EnumProfile, a struct of the number of classes followed by a struct per
+// class which starts with its name and its number of nodes
+static GVariant *astal_wp_device_parse_profile_classes(WpSpaPod *pod) {
+    GVariantBuilder classes = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("a(su)"));
+    if (pod == NULL || !wp_spa_pod_is_struct(pod)) return g_variant_builder_end(&classes);
+
+    WpIterator *iter = wp_spa_pod_new_iterator(pod);
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        WpSpaPod *class = g_value_get_boxed(&item);
+        const gchar *name;
+        gint n_nodes;
+        if (wp_spa_pod_is_struct(class) &&
+            wp_spa_pod_get_struct(class, "s", &name, "i", &n_nodes, NULL))
+            g_variant_builder_add(&classes, "(su)", name, MAX(n_nodes, 0));
+        g_value_unset(&item);
+    }
+    wp_iterator_unref(iter);
+    return g_variant_builder_end(&classes);
+}
+
+// adds an EnumProfile object to an a(issiua(su)), profiles without an index are skipped
+static void astal_wp_device_parse_profile(WpSpaPod *pod, GVariantBuilder *profiles) {
+    gint index = -1, priority = 0;
+    guint32 available = ASTAL_WP_AVAILABILITY_UNKNOWN;
+    g_autofree gchar *name = NULL;
+    g_autofree gchar *description = NULL;
+    g_autoptr(WpSpaPod) classes = NULL;
+
+    WpIterator *iter = wp_spa_pod_new_iterator(pod);
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        const gchar *key;
+        g_autoptr(WpSpaPod) value = NULL;
+        const gchar *str;
+        if (wp_spa_pod_get_property(g_value_get_boxed(&item), &key, &value)) {
+            if (g_strcmp0(key, "index") == 0)
+                wp_spa_pod_get_int(value, &index);
+            else if (g_strcmp0(key, "name") == 0 && wp_spa_pod_get_string(value, &str))
+                name = g_strdup(str);
+            else if (g_strcmp0(key, "description") == 0 && wp_spa_pod_get_string(value, &str))
+                description = g_strdup(str);
+            else if (g_strcmp0(key, "priority") == 0)
+                wp_spa_pod_get_int(value, &priority);
+            else if (g_strcmp0(key, "available") == 0)
+                wp_spa_pod_get_id(value, &available);
+            else if (g_strcmp0(key, "classes") == 0)
+                classes = g_steal_pointer(&value);
+        }
+        g_value_unset(&item);
+    }
+    wp_iterator_unref(iter);
+
+    if (index < 0) return;
+    g_variant_builder_add(profiles, "(issiu@a(su))", index, name != NULL ? name : "",
+                          description != NULL ? description : "", priority, available,
+                          astal_wp_device_parse_profile_classes(classes));
+}
+
+static const gchar *astal_wp_device_lookup_property(AstalWpDevice *self, const gchar *key) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    return priv->properties != NULL ? wp_properties_get(priv->properties, key) : NULL;
+}
+
+// enumerates a param of the device, replayed devices use the pods the replay reported. The pods
+// are journaled while recording, which needs them collected first
+static WpIterator *astal_wp_device_enum_params(AstalWpDevice *self, const gchar *name) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    GPtrArray *pods;
+
+    if (priv->device == NULL) {
+        pods = priv->params != NULL ? g_hash_table_lookup(priv->params, name) : NULL;
+        return pods != NULL ? wp_iterator_new_ptr_array(g_ptr_array_ref(pods), WP_TYPE_SPA_POD)
+                            : NULL;
+    }
+
+    WpIterator *iter = wp_pipewire_object_enum_params_sync(WP_PIPEWIRE_OBJECT(priv->device), name,
+                                                           NULL);
+    if (iter == NULL || !astal_wp_wp_is_recording(priv->wp)) return iter;
+
+    pods = g_ptr_array_new_with_free_func((GDestroyNotify)wp_spa_pod_unref);
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        g_ptr_array_add(pods, wp_spa_pod_ref(g_value_get_boxed(&item)));
+        g_value_unset(&item);
+    }
+    wp_iterator_unref(iter);
+
+    astal_wp_wp_record_input(priv->wp, ASTAL_WP_JOURNAL_PW_DEVICE_PARAMS,
+                             astal_wp_journal_params(self->id, name, pods));
+    return wp_iterator_new_ptr_array(pods, WP_TYPE_SPA_POD);
+}
+
 static void astal_wp_device_update_profiles(AstalWpDevice *self) {
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
-    g_hash_table_remove_all(priv->profiles);
 
-    WpIterator *iter =
-        wp_pipewire_object_enum_params_sync(WP_PIPEWIRE_OBJECT(priv->device), "EnumProfile", NULL);
+    gint64 start = g_get_monotonic_time();
+    WpIterator *iter = astal_wp_device_enum_params(self, "EnumProfile");
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "wp_pipewire_object_enum_params_sync EnumProfile", self->id,
+                            start);
     if (iter == NULL) return;
+    GVariantBuilder profiles = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("a(issiua(su))"));
     GValue profile = G_VALUE_INIT;
     while (wp_iterator_next(iter, &profile)) {
-        WpSpaPod *pod = g_value_get_boxed(&profile);
-
-        gint index;
-        gchar *description;
-        wp_spa_pod_get_object(pod, NULL, "index", "i", &index, "description", "s", &description,
-                              NULL);
-
-        g_hash_table_insert(
-            priv->profiles, GINT_TO_POINTER(index),
-            g_object_new(ASTAL_WP_TYPE_PROFILE, "index", index, "description", description, NULL));
+        astal_wp_device_parse_profile(g_value_get_boxed(&profile), &profiles);
         g_value_unset(&profile);
     }
     wp_iterator_unref(iter);
 
-    g_object_notify(G_OBJECT(self), "profiles");
+    astal_wp_device_set_profiles(self, g_variant_builder_end(&profiles));
 }
 
 static void astal_wp_device_update_active_profile(AstalWpDevice *self) {
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
 
-    WpIterator *iter =
-        wp_pipewire_object_enum_params_sync(WP_PIPEWIRE_OBJECT(priv->device), "Profile", NULL);
+    // the profile itself is part of EnumProfile, only the index is state of this device
+    gint64 start = g_get_monotonic_time();
+    WpIterator *iter = astal_wp_device_enum_params(self, "Profile");
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "wp_pipewire_object_enum_params_sync Profile", self->id,
+                            start);
     if (iter == NULL) return;
+    gint active = self->active_profile;
     GValue profile = G_VALUE_INIT;
     while (wp_iterator_next(iter, &profile)) {
         WpSpaPod *pod = g_value_get_boxed(&profile);
 
         gint index;
-        gchar *description;
-        wp_spa_pod_get_object(pod, NULL, "index", "i", &index, "description", "s", &description,
-                              NULL);
+        wp_spa_pod_get_object(pod, NULL, "index", "i", &index, NULL);
 
-        g_hash_table_insert(
-            priv->profiles, GINT_TO_POINTER(index),
-            g_object_new(ASTAL_WP_TYPE_PROFILE, "index", index, "description", description, NULL));
-
-        self->active_profile = index;
+        active = index;
         g_value_unset(&profile);
     }
     wp_iterator_unref(iter);
 
+    // while an optimistic write is pending only the profile it selected is applied
+    if (!astal_wp_pending_reconcile(&priv->pending_profile, active)) return;
+
+    self->active_profile = active;
     g_object_notify(G_OBJECT(self), "active-profile-id");
 }
 
+// restores the reported profile after an optimistic write was not confirmed in time
+static void astal_wp_device_rollback(AstalWpDevice *self, AstalWpWriteKind kind) {
+    astal_wp_device_update_active_profile(self);
+}
+
+typedef struct {
+    gint index;
+    gint device;
+    gchar *name;
+    gchar *description;
+    guint32 direction;
+    gint priority;
+    guint32 available;
+    GArray *profiles;
+    GArray *devices;
+    gboolean hardware_volume;
+} AstalWpDeviceRouteParam;
+
+static void astal_wp_device_route_param_clear(AstalWpDeviceRouteParam *param) {
+    g_clear_pointer(&param->name, g_free);
+    g_clear_pointer(&param->description, g_free);
+    g_clear_pointer(&param->profiles, g_array_unref);
+    g_clear_pointer(&param->devices, g_array_unref);
+}
+
+// the elements of an Array pod of ints or floats
+static GArray *astal_wp_device_pod_array(WpSpaPod *pod, gboolean floats) {
+    GArray *array = g_array_new(FALSE, FALSE, floats ? sizeof(gfloat) : sizeof(gint));
+    if (!wp_spa_pod_is_array(pod)) return array;
+
+    WpIterator *iter = wp_spa_pod_new_iterator(pod);
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        g_array_append_vals(array, g_value_get_pointer(&item), 1);
+        g_value_unset(&item);
+    }
+    wp_iterator_unref(iter);
+    return array;
+}
+
+// the device applies the volume itself unless all of it is mixed in software, in which case the
+// soft volumes equal the channel volumes
+static gboolean astal_wp_device_props_hardware_volume(WpSpaPod *props) {
+    g_autoptr(GArray) volumes = NULL;
+    g_autoptr(GArray) soft_volumes = NULL;
+
+    WpIterator *iter = wp_spa_pod_new_iterator(props);
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        const gchar *key;
+        g_autoptr(WpSpaPod) value = NULL;
+        if (wp_spa_pod_get_property(g_value_get_boxed(&item), &key, &value)) {
+            if (g_strcmp0(key, "channelVolumes") == 0)
+                volumes = astal_wp_device_pod_array(value, TRUE);
+            else if (g_strcmp0(key, "softVolumes") == 0)
+                soft_volumes = astal_wp_device_pod_array(value, TRUE);
+        }
+        g_value_unset(&item);
+    }
+    wp_iterator_unref(iter);
+
+    if (volumes == NULL || volumes->len == 0) return FALSE;
+    if (soft_volumes == NULL || soft_volumes->len != volumes->len) return TRUE;
+    return memcmp(volumes->data, soft_volumes->data, volumes->len * sizeof(gfloat)) != 0;
+}
+
+// reads a Route or EnumRoute object, keys it does not carry are left untouched
+static void astal_wp_device_parse_route(WpSpaPod *pod, AstalWpDeviceRouteParam *param) {
+    WpIterator *iter = wp_spa_pod_new_iterator(pod);
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        const gchar *key;
+        g_autoptr(WpSpaPod) value = NULL;
+        if (!wp_spa_pod_get_property(g_value_get_boxed(&item), &key, &value)) {
+            g_value_unset(&item);
+            continue;
+        }
+
+        const gchar *str;
+        if (g_strcmp0(key, "index") == 0) {
+            wp_spa_pod_get_int(value, &param->index);
+        } else if (g_strcmp0(key, "device") == 0) {
+            wp_spa_pod_get_int(value, &param->device);
+        } else if (g_strcmp0(key, "direction") == 0) {
+            wp_spa_pod_get_id(value, &param->direction);
+        } else if (g_strcmp0(key, "priority") == 0) {
+            wp_spa_pod_get_int(value, &param->priority);
+        } else if (g_strcmp0(key, "available") == 0) {
+            wp_spa_pod_get_id(value, &param->available);
+        } else if (g_strcmp0(key, "name") == 0 && wp_spa_pod_get_string(value, &str)) {
+            g_free(param->name);
+            param->name = g_strdup(str);
+        } else if (g_strcmp0(key, "description") == 0 && wp_spa_pod_get_string(value, &str)) {
+            g_free(param->description);
+            param->description = g_strdup(str);
+        } else if (g_strcmp0(key, "profiles") == 0) {
+            param->profiles = astal_wp_device_pod_array(value, FALSE);
+        } else if (g_strcmp0(key, "devices") == 0) {
+            param->devices = astal_wp_device_pod_array(value, FALSE);
+        } else if (g_strcmp0(key, "props") == 0) {
+            param->hardware_volume = astal_wp_device_props_hardware_volume(value);
+        }
+        g_value_unset(&item);
+    }
+    wp_iterator_unref(iter);
+}
+
+// diffs EnumRoute against the cached routes, known routes are updated in place and routes is only
+// notified when something actually changed
+static void astal_wp_device_update_routes(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    gint64 start = g_get_monotonic_time();
+    WpIterator *iter = astal_wp_device_enum_params(self, "EnumRoute");
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "wp_pipewire_object_enum_params_sync EnumRoute", self->id,
+                            start);
+    if (iter == NULL) return;
+
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    gboolean changed = FALSE;
+
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        AstalWpDeviceRouteParam param = {.index = -1};
+        astal_wp_device_parse_route(g_value_get_boxed(&item), &param);
+        g_value_unset(&item);
+        if (param.index < 0) {
+            astal_wp_device_route_param_clear(&param);
+            continue;
+        }
+
+        AstalWpRoute *route = g_hash_table_lookup(priv->routes, GINT_TO_POINTER(param.index));
+        if (route == NULL) {
+            route = astal_wp_route_new(param.index);
+            g_hash_table_insert(priv->routes, GINT_TO_POINTER(param.index), route);
+            changed = TRUE;
+        }
+
+        changed |= astal_wp_route_update(route, param.name, param.description,
+                                         param.direction == 1 ? ASTAL_WP_DIRECTION_OUTPUT
+                                                              : ASTAL_WP_DIRECTION_INPUT,
+                                         MAX(param.priority, 0), param.available);
+        astal_wp_route_set_devices(route, g_steal_pointer(&param.profiles),
+                                   g_steal_pointer(&param.devices));
+        g_hash_table_add(seen, GINT_TO_POINTER(param.index));
+        astal_wp_device_route_param_clear(&param);
+    }
+    wp_iterator_unref(iter);
+
+    GHashTableIter routes;
+    gpointer index;
+    g_hash_table_iter_init(&routes, priv->routes);
+    while (g_hash_table_iter_next(&routes, &index, NULL)) {
+        if (!g_hash_table_contains(seen, index)) {
+            g_hash_table_iter_remove(&routes);
+            changed = TRUE;
+        }
+    }
+    g_hash_table_destroy(seen);
+
+    if (changed) g_object_notify(G_OBJECT(self), "routes");
+}
+
+// marks the routes reported by Route active on their card device and every other one inactive
+static void astal_wp_device_update_active_routes(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    gint64 start = g_get_monotonic_time();
+    WpIterator *iter = astal_wp_device_enum_params(self, "Route");
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "wp_pipewire_object_enum_params_sync Route", self->id,
+                            start);
+    if (iter == NULL) return;
+
+    // index -> AstalWpDeviceRouteParam
+    GHashTable *active = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+    GValue item = G_VALUE_INIT;
+    while (wp_iterator_next(iter, &item)) {
+        AstalWpDeviceRouteParam *param = g_new0(AstalWpDeviceRouteParam, 1);
+        param->index = param->device = -1;
+        astal_wp_device_parse_route(g_value_get_boxed(&item), param);
+        g_value_unset(&item);
+
+        astal_wp_device_route_param_clear(param);
+        g_hash_table_insert(active, GINT_TO_POINTER(param->index), param);
+    }
+    wp_iterator_unref(iter);
+
+    GHashTableIter routes;
+    gpointer index, route;
+    gboolean changed = FALSE;
+    g_hash_table_iter_init(&routes, priv->routes);
+    while (g_hash_table_iter_next(&routes, &index, &route)) {
+        AstalWpDeviceRouteParam *param = g_hash_table_lookup(active, index);
+        if (param != NULL)
+            changed |= astal_wp_route_set_active(route, param->device, param->hardware_volume);
+        else
+            changed |= astal_wp_route_set_active(route, -1, FALSE);
+    }
+    g_hash_table_destroy(active);
+
+    if (changed) g_object_notify(G_OBJECT(self), "routes");
+}
+
 static void astal_wp_device_params_changed(AstalWpDevice *self, const gchar *prop) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    gint64 start = g_get_monotonic_time();
+
     if (g_strcmp0(prop, "EnumProfile") == 0) {
         astal_wp_device_update_profiles(self);
     } else if (g_strcmp0(prop, "Profile") == 0) {
         astal_wp_device_update_active_profile(self);
+    } else if (g_strcmp0(prop, "EnumRoute") == 0) {
+        astal_wp_device_update_routes(self);
+        astal_wp_device_update_active_routes(self);
+    } else if (g_strcmp0(prop, "Route") == 0) {
+        astal_wp_device_update_active_routes(self);
+    }
+
+    if (priv->wp != NULL) astal_wp_wp_record_event(priv->wp, ASTAL_WP_EVENT_PARAMS, start);
+}
+
+// takes the pods a replayed device enumerated for a param and handles them like a change of it
+void astal_wp_device_replay_params(AstalWpDevice *self, const gchar *name, GPtrArray *pods) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    if (priv->params == NULL)
+        priv->params = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                             (GDestroyNotify)g_ptr_array_unref);
+    g_hash_table_insert(priv->params, g_strdup(name), pods);
+    astal_wp_device_params_changed(self, name);
+}
+
+// journals the device with the params it has now, for a recording started after it appeared
+void astal_wp_device_record(AstalWpDevice *self) {
+    static const gchar *names[] = {"EnumProfile", "Profile", "EnumRoute", "Route"};
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    astal_wp_wp_record_input(priv->wp, ASTAL_WP_JOURNAL_PW_DEVICE_ADDED,
+                             astal_wp_journal_properties(self->id, priv->properties));
+    for (guint i = 0; i < G_N_ELEMENTS(names); i++) {
+        WpIterator *iter = astal_wp_device_enum_params(self, names[i]);
+        if (iter != NULL) wp_iterator_unref(iter);
     }
 }
 
 static void astal_wp_device_update_properties(AstalWpDevice *self) {
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
-    if (priv->device == NULL) return;
-    self->id = wp_proxy_get_bound_id(WP_PROXY(priv->device));
-    const gchar *description =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->device), "device.description");
+    if (priv->properties == NULL) return;
+    const gchar *description = astal_wp_device_lookup_property(self, "device.description");
     if (description == NULL) {
-        description =
-            wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->device), "device.name");
+        description = astal_wp_device_lookup_property(self, "device.name");
     }
     if (description == NULL) {
         description = "unknown";
@@ -255,16 +902,14 @@ static void astal_wp_device_update_properties(AstalWpDevice *self) {
     g_free(self->description);
     self->description = g_strdup(description);
 
-    const gchar *icon =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->device), "device.icon-name");
+    const gchar *icon = astal_wp_device_lookup_property(self, "device.icon-name");
     if (icon == NULL) {
         icon = "audio-card-symbolic";
     }
     g_free(self->icon);
     self->icon = g_strdup(icon);
 
-    const gchar *type =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->device), "media.class");
+    const gchar *type = astal_wp_device_lookup_property(self, "media.class");
     GEnumClass *enum_class = g_type_class_ref(ASTAL_WP_TYPE_DEVICE_TYPE);
     if (g_enum_get_value_by_nick(enum_class, type) != NULL)
         self->type = g_enum_get_value_by_nick(enum_class, type)->value;
@@ -272,6 +917,8 @@ static void astal_wp_device_update_properties(AstalWpDevice *self) {
 
     astal_wp_device_update_profiles(self);
     astal_wp_device_update_active_profile(self);
+    astal_wp_device_update_routes(self);
+    astal_wp_device_update_active_routes(self);
 
     g_object_notify(G_OBJECT(self), "id");
     g_object_notify(G_OBJECT(self), "device-type");
@@ -279,14 +926,184 @@ static void astal_wp_device_update_properties(AstalWpDevice *self) {
     g_object_notify(G_OBJECT(self), "description");
 }
 
-AstalWpDevice *astal_wp_device_create(WpDevice *device) {
+// the state of this device as a floating a{sv}, the keys match the D-Bus properties
+GVariant *astal_wp_device_serialize(AstalWpDevice *self) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+    GVariantBuilder profiles = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("a(issiua(su))"));
+    GVariantBuilder routes = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("a(issuuuib)"));
+
+    GHashTableIter iter;
+    gpointer key, value;
+
+    guint n_profiles = priv->profiles != NULL ? astal_wp_profile_set_get_size(priv->profiles) : 0;
+    for (guint i = 0; i < n_profiles; i++) {
+        AstalWpProfile *profile = astal_wp_profile_set_get(priv->profiles, i);
+        const gchar *name = astal_wp_profile_get_name(profile);
+        const gchar *description = astal_wp_profile_get_description(profile);
+        const gchar *const *classes = astal_wp_profile_get_classes(profile);
+
+        GVariantBuilder nodes = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("a(su)"));
+        for (guint j = 0; classes[j] != NULL; j++)
+            g_variant_builder_add(&nodes, "(su)", classes[j],
+                                  astal_wp_profile_get_n_nodes(profile, classes[j]));
+
+        g_variant_builder_add(&profiles, "(issiua(su))", astal_wp_profile_get_index(profile),
+                              name != NULL ? name : "", description != NULL ? description : "",
+                              astal_wp_profile_get_priority(profile),
+                              g_array_index(priv->profile_available, guint32, i), &nodes);
+    }
+
+    g_hash_table_iter_init(&iter, priv->routes);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const gchar *name = astal_wp_route_get_name(value);
+        const gchar *description = astal_wp_route_get_description(value);
+        g_variant_builder_add(&routes, "(issuuuib)", astal_wp_route_get_index(value),
+                              name != NULL ? name : "", description != NULL ? description : "",
+                              astal_wp_route_get_direction(value),
+                              astal_wp_route_get_priority(value),
+                              astal_wp_route_get_available(value),
+                              astal_wp_route_get_device(value),
+                              astal_wp_route_get_hardware_volume(value));
+    }
+
+    g_variant_builder_add(&b, "{sv}", "Id", g_variant_new_uint32(self->id));
+    g_variant_builder_add(&b, "{sv}", "DeviceType", g_variant_new_uint32(self->type));
+    g_variant_builder_add(&b, "{sv}", "Description",
+                          g_variant_new_string(self->description ? self->description : ""));
+    g_variant_builder_add(&b, "{sv}", "Icon", g_variant_new_string(self->icon ? self->icon : ""));
+    g_variant_builder_add(&b, "{sv}", "ActiveProfile", g_variant_new_int32(self->active_profile));
+    g_variant_builder_add(&b, "{sv}", "Profiles", g_variant_builder_end(&profiles));
+    g_variant_builder_add(&b, "{sv}", "Routes", g_variant_builder_end(&routes));
+
+    return g_variant_builder_end(&b);
+}
+
+static void astal_wp_device_apply_string(AstalWpDevice *self, gchar **field, GVariant *value,
+                                         const gchar *property) {
+    const gchar *str = g_variant_get_string(value, NULL);
+    if (*str == '\0') str = NULL;
+    if (g_strcmp0(*field, str) == 0) return;
+
+    g_free(*field);
+    *field = g_strdup(str);
+    g_object_notify(G_OBJECT(self), property);
+}
+
+// the same diff as astal_wp_device_update_routes on the a(issuuuib) of astal_wp_device_serialize
+static void astal_wp_device_apply_routes(AstalWpDevice *self, GVariant *value) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    gboolean changed = FALSE;
+
+    GVariantIter iter;
+    gint index, device;
+    const gchar *name, *description;
+    guint32 direction, priority, available;
+    gboolean hardware_volume;
+
+    g_variant_iter_init(&iter, value);
+    while (g_variant_iter_next(&iter, "(i&s&suuuib)", &index, &name, &description, &direction,
+                               &priority, &available, &device, &hardware_volume)) {
+        AstalWpRoute *route = g_hash_table_lookup(priv->routes, GINT_TO_POINTER(index));
+        if (route == NULL) {
+            route = astal_wp_route_new(index);
+            g_hash_table_insert(priv->routes, GINT_TO_POINTER(index), route);
+            changed = TRUE;
+        }
+
+        changed |= astal_wp_route_update(route, *name != '\0' ? name : NULL,
+                                         *description != '\0' ? description : NULL, direction,
+                                         priority, available);
+        changed |= astal_wp_route_set_active(route, device, hardware_volume);
+        g_hash_table_add(seen, GINT_TO_POINTER(index));
+    }
+
+    GHashTableIter routes;
+    gpointer key;
+    g_hash_table_iter_init(&routes, priv->routes);
+    while (g_hash_table_iter_next(&routes, &key, NULL)) {
+        if (!g_hash_table_contains(seen, key)) {
+            g_hash_table_iter_remove(&routes);
+            changed = TRUE;
+        }
+    }
+    g_hash_table_destroy(seen);
+
+    if (changed) g_object_notify(G_OBJECT(self), "routes");
+}
+
+// updates a mirrored device from a{sv} as produced by astal_wp_device_serialize. Missing keys
+// are left untouched and only properties which actually changed are notified.
+void astal_wp_device_apply(AstalWpDevice *self, GVariant *state) {
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    GVariantIter iter;
+    const gchar *key;
+    GVariant *value;
+
+    g_object_freeze_notify(G_OBJECT(self));
+
+    g_variant_iter_init(&iter, state);
+    while (g_variant_iter_loop(&iter, "{&sv}", &key, &value)) {
+        if (g_strcmp0(key, "Id") == 0) {
+            guint id = g_variant_get_uint32(value);
+            if (id != self->id) {
+                self->id = id;
+                g_object_notify(G_OBJECT(self), "id");
+            }
+        } else if (g_strcmp0(key, "DeviceType") == 0) {
+            AstalWpDeviceType type = g_variant_get_uint32(value);
+            if (type != self->type) {
+                self->type = type;
+                g_object_notify(G_OBJECT(self), "device-type");
+            }
+        } else if (g_strcmp0(key, "Description") == 0) {
+            astal_wp_device_apply_string(self, &self->description, value, "description");
+        } else if (g_strcmp0(key, "Icon") == 0) {
+            astal_wp_device_apply_string(self, &self->icon, value, "icon");
+        } else if (g_strcmp0(key, "ActiveProfile") == 0) {
+            gint active_profile = g_variant_get_int32(value);
+            if (!astal_wp_pending_reconcile(&priv->pending_profile, active_profile)) continue;
+            if (active_profile != self->active_profile) {
+                self->active_profile = active_profile;
+                g_object_notify(G_OBJECT(self), "active-profile-id");
+            }
+        } else if (g_strcmp0(key, "Profiles") == 0) {
+            astal_wp_device_set_profiles(self, value);
+        } else if (g_strcmp0(key, "Routes") == 0) {
+            astal_wp_device_apply_routes(self, value);
+        }
+    }
+
+    g_object_thaw_notify(G_OBJECT(self));
+}
+
+AstalWpDevice *astal_wp_device_create_remote(AstalWpWp *wp, GVariant *state) {
+    AstalWpDevice *self = g_object_new(ASTAL_WP_TYPE_DEVICE, NULL);
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    priv->remote = wp;
+    astal_wp_device_apply(self, state);
+    return self;
+}
+
+// device is NULL when a replay creates the device, its params are then reported through
+// astal_wp_device_replay_params
+AstalWpDevice *astal_wp_device_create(guint id, WpDevice *device, WpProperties *properties,
+                                      AstalWpWp *wp) {
     AstalWpDevice *self = g_object_new(ASTAL_WP_TYPE_DEVICE, NULL);
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
 
-    priv->device = g_object_ref(device);
+    self->id = id;
+    priv->device = device != NULL ? g_object_ref(device) : NULL;
+    priv->properties = wp_properties_ref(properties);
+    priv->wp = wp;
 
-    g_signal_connect_swapped(priv->device, "params-changed",
-                             G_CALLBACK(astal_wp_device_params_changed), self);
+    if (priv->device != NULL)
+        g_signal_connect_swapped(priv->device, "params-changed",
+                                 G_CALLBACK(astal_wp_device_params_changed), self);
 
     astal_wp_device_update_properties(self);
     return self;
@@ -295,8 +1112,18 @@ AstalWpDevice *astal_wp_device_create(WpDevice *device) {
 static void astal_wp_device_init(AstalWpDevice *self) {
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
     priv->device = NULL;
+    priv->properties = NULL;
+    priv->params = NULL;
+    priv->remote = NULL;
+    priv->wp = NULL;
+    astal_wp_pending_init(&priv->pending_profile, ASTAL_WP_WRITE_PROFILE,
+                          (AstalWpPendingRollbackFunc)astal_wp_device_rollback, self);
 
-    priv->profiles = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->profiles = NULL;
+    priv->profile_available = g_array_new(FALSE, FALSE, sizeof(guint32));
+    priv->available_profiles = g_ptr_array_new();
+    priv->routes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->endpoints = NULL;
 
     self->description = NULL;
     self->icon = NULL;
@@ -306,11 +1133,21 @@ static void astal_wp_device_dispose(GObject *object) {
     AstalWpDevice *self = ASTAL_WP_DEVICE(object);
     AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
 
+    astal_wp_pending_clear(&priv->pending_profile);
     g_clear_object(&priv->device);
+    g_clear_pointer(&priv->properties, wp_properties_unref);
+    g_clear_pointer(&priv->params, g_hash_table_destroy);
 }
 
 static void astal_wp_device_finalize(GObject *object) {
     AstalWpDevice *self = ASTAL_WP_DEVICE(object);
+    AstalWpDevicePrivate *priv = astal_wp_device_get_instance_private(self);
+
+    if (priv->profiles != NULL) astal_wp_profile_set_unref(priv->profiles);
+    g_array_unref(priv->profile_available);
+    g_ptr_array_unref(priv->available_profiles);
+    g_hash_table_destroy(priv->routes);
+    if (priv->endpoints != NULL) g_ptr_array_unref(priv->endpoints);
     g_free(self->description);
     g_free(self->icon);
 }
@@ -365,6 +1202,21 @@ static void astal_wp_device_class_init(AstalWpDeviceClass *class) {
     astal_wp_device_properties[ASTAL_WP_DEVICE_PROP_ACTIVE_PROFILE] =
         g_param_spec_int("active-profile-id", "active-profile-id", "active-profile-id", G_MININT,
                          G_MAXINT, 0, G_PARAM_READWRITE);
+    /**
+     * AstalWpDevice:routes: (type GList(AstalWpRoute)) (transfer container)
+     *
+     * A list of the routes of this device. Routes are kept across updates, so this is notified
+     * when a route is added, removed or changes, and the route itself notifies what changed.
+     */
+    astal_wp_device_properties[ASTAL_WP_DEVICE_PROP_ROUTES] =
+        g_param_spec_pointer("routes", "routes", "routes", G_PARAM_READABLE);
+    /**
+     * AstalWpDevice:endpoints: (type GList(AstalWpEndpoint)) (transfer container)
+     *
+     * A list of the endpoints of this device.
+     */
+    astal_wp_device_properties[ASTAL_WP_DEVICE_PROP_ENDPOINTS] =
+        g_param_spec_pointer("endpoints", "endpoints", "endpoints", G_PARAM_READABLE);
 
     g_object_class_install_properties(object_class, ASTAL_WP_DEVICE_N_PROPERTIES,
                                       astal_wp_device_properties);
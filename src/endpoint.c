@@ -5,6 +5,10 @@
 #include "device.h"
 #include "endpoint-private.h"
 #include "glib.h"
+#include "pending-private.h"
+#include "ramp-private.h"
+#include "scale-private.h"
+#include "wp-private.h"
 #include "wp.h"
 
 struct _AstalWpEndpoint {
@@ -23,7 +27,10 @@ struct _AstalWpEndpoint {
 };
 
 typedef struct {
+    // NULL for endpoints created by a replay, which only know the properties of the node
     WpNode *node;
+    // a copy of the properties the node reported last
+    WpProperties *properties;
     WpPlugin *mixer;
     WpPlugin *defaults;
     AstalWpWp *wp;
@@ -31,231 +38,1477 @@ typedef struct {
     gboolean is_default_node;
     AstalWpMediaClass media_class;
 
+    // mirrored from another process, writes are forwarded through astal_wp_wp_remote_command
+    gboolean remote;
+
     gulong default_signal_handler_id;
     gulong mixer_signal_handler_id;
+    gulong properties_signal_handler_id;
+
+    gchar *serial;
+    gchar *node_name;
+    guint client_id;
+
+    // the device.id of the node, the device itself is linked by the AstalWpWp once it is known and
+    // unlinked before it is destroyed, not owned
+    guint device_id;
+    AstalWpDevice *device;
+
+    // raw values of the target.object and target.node keys in the default metadata
+    gchar *target_object;
+    gchar *target_node;
+
+    gchar *requested_latency;
+
+    // channels as last reported by the mixer, new volumes are written relative to them without
+    // asking the mixer again. channel_keys are the keys of the channelVolumes dictionary,
+    // channel_map holds the channel positions like "FL" or "FR"
+    guint n_channels;
+    gchar **channel_keys;
+    gchar **channel_map;
+    // linear, the mixer always reports linear volumes
+    gdouble *channel_volumes;
+    // channel_volumes converted to the scale of this endpoint
+    gdouble *scaled_channel_volumes;
+    // the loudest channel, self->volume is this volume in the scale of this endpoint
+    gdouble linear_volume;
+
+    // a scale set on this endpoint, otherwise the scale of the AstalWpWp is used
+    gboolean has_scale;
+    AstalWpScale scale;
+    AstalWpScaleFunc scale_func;
+    gpointer scale_data;
+    GDestroyNotify scale_destroy;
+
+    // optimistic writes waiting for PipeWire, indexed by AstalWpWriteKind
+    AstalWpPendingWrite pending[ASTAL_WP_WRITE_N_KINDS];
+} AstalWpEndpointPrivate;
+
+G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpEndpoint, astal_wp_endpoint, G_TYPE_OBJECT);
+
+G_DEFINE_ENUM_TYPE(AstalWpMediaClass, astal_wp_media_class,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE, "Audio/Source"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER, "Audio/Sink"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_RECORDER, "Stream/Input/Audio"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_STREAM, "Stream/Output/Audio"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_SOURCE, "Video/Source"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_SINK, "Video/Sink"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_RECORDER, "Stream/Input/Video"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_STREAM, "Stream/Output/Video"));
+
+G_DEFINE_ENUM_TYPE(AstalWpRampCurve, astal_wp_ramp_curve,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_RAMP_CURVE_LINEAR, "linear"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_RAMP_CURVE_EASE_IN, "ease-in"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_RAMP_CURVE_EASE_OUT, "ease-out"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_RAMP_CURVE_EASE_IN_OUT, "ease-in-out"));
+
+typedef enum {
+    ASTAL_WP_ENDPOINT_SIGNAL_LINKS_CHANGED,
+    ASTAL_WP_ENDPOINT_N_SIGNALS
+} AstalWpEndpointSignals;
+
+static guint astal_wp_endpoint_signals[ASTAL_WP_ENDPOINT_N_SIGNALS] = {
+    0,
+};
+
+typedef enum {
+    ASTAL_WP_ENDPOINT_PROP_ID = 1,
+    ASTAL_WP_ENDPOINT_PROP_VOLUME,
+    ASTAL_WP_ENDPOINT_PROP_MUTE,
+    ASTAL_WP_ENDPOINT_PROP_DESCRIPTION,
+    ASTAL_WP_ENDPOINT_PROP_NAME,
+    ASTAL_WP_ENDPOINT_PROP_MEDIA_CLASS,
+    ASTAL_WP_ENDPOINT_PROP_DEFAULT,
+    ASTAL_WP_ENDPOINT_PROP_ICON,
+    ASTAL_WP_ENDPOINT_PROP_VOLUME_ICON,
+    ASTAL_WP_ENDPOINT_PROP_LOCK_CHANNELS,
+    ASTAL_WP_ENDPOINT_PROP_TARGET,
+    ASTAL_WP_ENDPOINT_PROP_REQUESTED_LATENCY,
+    ASTAL_WP_ENDPOINT_PROP_CHANNEL_MAP,
+    ASTAL_WP_ENDPOINT_PROP_CHANNEL_VOLUMES,
+    ASTAL_WP_ENDPOINT_PROP_SCALE,
+    ASTAL_WP_ENDPOINT_PROP_DEVICE,
+    ASTAL_WP_ENDPOINT_N_PROPERTIES,
+} AstalWpEndpointProperties;
+
+static GParamSpec *astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_N_PROPERTIES] = {
+    NULL,
+};
+
+static AstalWpScale astal_wp_endpoint_lookup_scale(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->has_scale) return priv->scale;
+    if (priv->wp != NULL) return astal_wp_wp_get_scale(priv->wp);
+    return ASTAL_WP_SCALE_CUBIC;
+}
+
+static AstalWpScaleFunc astal_wp_endpoint_lookup_scale_func(AstalWpEndpoint *self,
+                                                            gpointer *data) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    *data = NULL;
+    if (priv->scale_func != NULL) {
+        *data = priv->scale_data;
+        return priv->scale_func;
+    }
+    if (priv->wp != NULL) return astal_wp_wp_get_scale_func(priv->wp, data);
+    return NULL;
+}
+
+static gdouble astal_wp_endpoint_convert(AstalWpEndpoint *self, AstalWpScale scale,
+                                         gdouble volume, gboolean to_linear) {
+    gpointer data;
+    AstalWpScaleFunc func = astal_wp_endpoint_lookup_scale_func(self, &data);
+    return astal_wp_scale_convert(scale, func, data, volume, to_linear);
+}
+
+// converts between linear volumes and the scale of this endpoint
+gdouble astal_wp_endpoint_convert_volume(AstalWpEndpoint *self, gdouble volume,
+                                         gboolean to_linear) {
+    return astal_wp_endpoint_convert(self, astal_wp_endpoint_lookup_scale(self), volume,
+                                     to_linear);
+}
+
+// clamps volume to the range of the scale of this endpoint
+gdouble astal_wp_endpoint_clamp_volume(AstalWpEndpoint *self, gdouble volume) {
+    return astal_wp_scale_clamp(astal_wp_endpoint_lookup_scale(self), volume);
+}
+
+static void astal_wp_endpoint_scale_channels(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    gpointer data;
+    AstalWpScaleFunc func = astal_wp_endpoint_lookup_scale_func(self, &data);
+    astal_wp_scale_convert_array(astal_wp_endpoint_lookup_scale(self), func, data,
+                                 priv->channel_volumes, priv->scaled_channel_volumes,
+                                 priv->n_channels, FALSE);
+}
+
+// stores the linear volume of this endpoint, returns whether its volume in the current scale
+// changed
+static gboolean astal_wp_endpoint_update_linear_volume(AstalWpEndpoint *self, gdouble linear) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    priv->linear_volume = linear;
+    gdouble volume = astal_wp_endpoint_convert_volume(self, linear, FALSE);
+    if (volume == self->volume) return FALSE;
+
+    self->volume = volume;
+    g_object_notify(G_OBJECT(self), "volume");
+    return TRUE;
+}
+
+// recomputes every volume from the cached linear volumes after the scale changed
+void astal_wp_endpoint_update_scale(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    g_object_freeze_notify(G_OBJECT(self));
+
+    astal_wp_endpoint_scale_channels(self);
+    if (priv->n_channels > 0) g_object_notify(G_OBJECT(self), "channel-volumes");
+    astal_wp_endpoint_update_linear_volume(self, priv->linear_volume);
+    g_object_notify(G_OBJECT(self), "scale");
+
+    g_object_thaw_notify(G_OBJECT(self));
+}
+
+// replaces the cached channels, takes ownership of the arrays and notifies what changed
+static void astal_wp_endpoint_update_channels(AstalWpEndpoint *self, guint n_channels,
+                                              gchar **keys, gchar **map, gdouble *volumes) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    gboolean map_changed = n_channels != priv->n_channels;
+    gboolean volumes_changed = map_changed;
+
+    for (guint i = 0; i < n_channels && !map_changed; i++) {
+        if (g_strcmp0(map[i], priv->channel_map[i]) != 0) map_changed = TRUE;
+        if (volumes[i] != priv->channel_volumes[i]) volumes_changed = TRUE;
+    }
+
+    g_strfreev(priv->channel_keys);
+    g_strfreev(priv->channel_map);
+    g_free(priv->channel_volumes);
+    priv->n_channels = n_channels;
+    priv->channel_keys = keys;
+    priv->channel_map = map;
+    priv->channel_volumes = volumes;
+
+    g_free(priv->scaled_channel_volumes);
+    priv->scaled_channel_volumes = g_new(gdouble, n_channels);
+    astal_wp_endpoint_scale_channels(self);
+
+    if (map_changed) g_object_notify(G_OBJECT(self), "channel-map");
+    if (volumes_changed || map_changed) g_object_notify(G_OBJECT(self), "channel-volumes");
+}
+
+// whether setters apply their change locally right away, see AstalWpWp:optimistic
+static gboolean astal_wp_endpoint_is_optimistic(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return !priv->remote && priv->wp != NULL && astal_wp_wp_get_optimistic(priv->wp);
+}
+
+static const gchar *astal_wp_endpoint_lookup_property(AstalWpEndpoint *self, const gchar *key) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->properties != NULL ? wp_properties_get(priv->properties, key) : NULL;
+}
+
+void astal_wp_endpoint_update_volume(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    gdouble volume = 0;
+    gboolean mute = self->mute;
+    GVariant *variant = NULL;
+    GVariantIter *channels = NULL;
+
+    if (priv->mixer == NULL) return;
+
+    gint64 start = g_get_monotonic_time();
+    g_signal_emit_by_name(priv->mixer, "get-volume", self->id, &variant);
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "mixer-api get-volume", self->id, start);
+
+    if (variant == NULL) return;
+    if (astal_wp_wp_is_recording(priv->wp))
+        astal_wp_wp_record_input(priv->wp, ASTAL_WP_JOURNAL_MIXER_VOLUME,
+                                 g_variant_new("(u@a{sv})", self->id, variant));
+
+    g_variant_lookup(variant, "volume", "d", &volume);
+    g_variant_lookup(variant, "mute", "b", &mute);
+    g_variant_lookup(variant, "channelVolumes", "a{sv}", &channels);
+
+    g_object_freeze_notify(G_OBJECT(self));
+
+    guint n = 0;
+    gchar **keys = NULL;
+    gchar **map = NULL;
+    gdouble *volumes = NULL;
+
+    if (channels != NULL) {
+        const gchar *key;
+        const gchar *channel_str;
+        gdouble channel_volume;
+        GVariant *varvol;
+
+        gsize n_children = g_variant_iter_n_children(channels);
+        keys = g_new0(gchar *, n_children + 1);
+        map = g_new0(gchar *, n_children + 1);
+        volumes = g_new0(gdouble, n_children);
+
+        while (g_variant_iter_loop(channels, "{&sv}", &key, &varvol)) {
+            channel_volume = 0;
+            channel_str = NULL;
+            g_variant_lookup(varvol, "volume", "d", &channel_volume);
+            g_variant_lookup(varvol, "channel", "&s", &channel_str);
+            if (channel_volume > volume) volume = channel_volume;
+
+            keys[n] = g_strdup(key);
+            map[n] = g_strdup(channel_str != NULL ? channel_str : "UNK");
+            volumes[n] = channel_volume;
+            n++;
+        }
+        g_variant_iter_free(channels);
+    }
+    g_variant_unref(variant);
+
+    // while an optimistic write is pending only the value it wrote is applied
+    gboolean apply_volume =
+        astal_wp_pending_reconcile(&priv->pending[ASTAL_WP_WRITE_VOLUME], volume);
+    gboolean apply_mute = astal_wp_pending_reconcile(&priv->pending[ASTAL_WP_WRITE_MUTE], mute);
+
+    if (apply_volume) {
+        astal_wp_endpoint_update_channels(self, n, keys, map, volumes);
+    } else {
+        g_strfreev(keys);
+        g_strfreev(map);
+        g_free(volumes);
+    }
+
+    if (apply_mute && mute != self->mute) {
+        self->mute = mute;
+        g_object_notify(G_OBJECT(self), "mute");
+    }
+
+    if (apply_volume) astal_wp_endpoint_update_linear_volume(self, volume);
+
+    g_object_notify(G_OBJECT(self), "volume-icon");
+
+    g_object_thaw_notify(G_OBJECT(self));
+}
+
+// the channelVolumes payload of the mixer api, built in one pass without nested builders
+static GVariant *astal_wp_endpoint_build_channel_volumes(AstalWpEndpoint *self,
+                                                         const gdouble *volumes) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    GVariant **entries = g_newa(GVariant *, priv->n_channels);
+    GVariant *volume_key = g_variant_ref_sink(g_variant_new_string("volume"));
+
+    for (guint i = 0; i < priv->n_channels; i++) {
+        GVariant *volume = g_variant_new_dict_entry(
+            volume_key, g_variant_new_variant(g_variant_new_double(volumes[i])));
+        GVariant *channel = g_variant_new_array(G_VARIANT_TYPE("{sv}"), &volume, 1);
+        entries[i] = g_variant_new_dict_entry(g_variant_new_string(priv->channel_keys[i]),
+                                              g_variant_new_variant(channel));
+    }
+
+    g_variant_unref(volume_key);
+    return g_variant_new_array(G_VARIANT_TYPE("{sv}"), entries, priv->n_channels);
+}
+
+static void astal_wp_endpoint_write_channel_volumes(AstalWpEndpoint *self,
+                                                    const gdouble *volumes) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    gboolean ret;
+    GVariantBuilder vol_b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(&vol_b, "{sv}", "channelVolumes",
+                          astal_wp_endpoint_build_channel_volumes(self, volumes));
+    gint64 start = g_get_monotonic_time();
+    g_signal_emit_by_name(priv->mixer, "set-volume", self->id, g_variant_builder_end(&vol_b), &ret);
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "mixer-api set-volume", self->id, start);
+}
+
+// tracks a written linear volume and applies it the way the mixer is going to report it when the
+// write is optimistic
+static void astal_wp_endpoint_apply_optimistic_volume(AstalWpEndpoint *self, gdouble volume,
+                                                      GTask *task) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    if (!astal_wp_pending_begin(&priv->pending[ASTAL_WP_WRITE_VOLUME], priv->wp,
+                                priv->linear_volume, volume,
+                                astal_wp_endpoint_is_optimistic(self), task))
+        return;
+
+    g_object_freeze_notify(G_OBJECT(self));
+
+    if (priv->n_channels > 0) {
+        const gdouble factor = priv->linear_volume > 0 ? volume / priv->linear_volume : 0;
+        for (guint i = 0; i < priv->n_channels; i++) {
+            if (self->lock_channels || factor == 0)
+                priv->channel_volumes[i] = volume;
+            else
+                priv->channel_volumes[i] *= factor;
+        }
+        astal_wp_endpoint_scale_channels(self);
+        g_object_notify(G_OBJECT(self), "channel-volumes");
+    }
+
+    astal_wp_endpoint_update_linear_volume(self, volume);
+    g_object_notify(G_OBJECT(self), "volume-icon");
+
+    g_object_thaw_notify(G_OBJECT(self));
+}
+
+// writes a linear volume keeping the balance of the cached channel volumes, @task is completed
+// once the volume is reported
+static void astal_wp_endpoint_write_linear_volume(AstalWpEndpoint *self, gdouble volume,
+                                                  GTask *task) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    gboolean ret;
+    if (volume <= 0) volume = 0;
+
+    if (priv->remote) {
+        astal_wp_wp_remote_command(priv->wp, "SetVolume", g_variant_new("(ud)", self->id, volume));
+        astal_wp_endpoint_apply_optimistic_volume(self, volume, task);
+        return;
+    }
+
+    if (priv->mixer == NULL) {
+        if (task != NULL)
+            g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+                                    "the mixer api is not loaded");
+        return;
+    }
+
+    if (priv->n_channels > 0 && !self->lock_channels) {
+        gdouble *volumes = g_newa(gdouble, priv->n_channels);
+
+        if (priv->linear_volume == 0) {
+            for (guint i = 0; i < priv->n_channels; i++) volumes[i] = volume;
+        } else {
+            const gdouble factor = volume / priv->linear_volume;
+            const gdouble *current = priv->channel_volumes;
+            for (guint i = 0; i < priv->n_channels; i++) volumes[i] = current[i] * factor;
+        }
+
+        astal_wp_endpoint_write_channel_volumes(self, volumes);
+    } else {
+        GVariantBuilder vol_b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+        g_variant_builder_add(&vol_b, "{sv}", "volume", g_variant_new_double(volume));
+        gint64 start = g_get_monotonic_time();
+        g_signal_emit_by_name(priv->mixer, "set-volume", self->id, g_variant_builder_end(&vol_b),
+                              &ret);
+        ASTAL_WP_WP_REPORT_CALL(priv->wp, "mixer-api set-volume", self->id, start);
+    }
+
+    astal_wp_endpoint_apply_optimistic_volume(self, volume, task);
+}
+
+// sets linear channel volumes as received from a mirroring process, which already clamped them
+void astal_wp_endpoint_set_linear_channel_volumes(AstalWpEndpoint *self, const gdouble *volumes,
+                                                  guint n_channels) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    g_return_if_fail(n_channels > 0 && n_channels == priv->n_channels);
+
+    astal_wp_ramp_cancel(self);
+
+    if (priv->remote) {
+        astal_wp_wp_remote_command(
+            priv->wp, "SetChannelVolumes",
+            g_variant_new("(u@ad)", self->id,
+                          g_variant_new_fixed_array(G_VARIANT_TYPE_DOUBLE, volumes, n_channels,
+                                                    sizeof(gdouble))));
+        return;
+    }
+
+    if (priv->mixer == NULL) return;
+    astal_wp_endpoint_write_channel_volumes(self, volumes);
+}
+
+// writes volume in the scale of this endpoint, used by the setter and by volume ramps
+void astal_wp_endpoint_write_volume(AstalWpEndpoint *self, gdouble volume) {
+    volume = astal_wp_endpoint_clamp_volume(self, volume);
+    astal_wp_endpoint_write_linear_volume(
+        self, astal_wp_endpoint_convert_volume(self, volume, TRUE), NULL);
+}
+
+// sets a linear volume as received from a mirroring process, which already clamped it
+void astal_wp_endpoint_set_linear_volume(AstalWpEndpoint *self, gdouble volume) {
+    astal_wp_ramp_cancel(self);
+    astal_wp_endpoint_write_linear_volume(self, volume, NULL);
+}
+
+/**
+ * astal_wp_endpoint_set_volume:
+ * @self: the AstalWpEndpoint object
+ * @volume: The new volume level to set.
+ *
+ * Sets the volume level for this endpoint in its scale. The volume is clamped to be between
+ * 0 and 1.5, or to ASTAL_WP_SCALE_DECIBEL_MIN and the decibel value of a cubic volume of 1.5.
+ */
+void astal_wp_endpoint_set_volume(AstalWpEndpoint *self, gdouble volume) {
+    astal_wp_ramp_cancel(self);
+    astal_wp_endpoint_write_volume(self, volume);
+}
+
+/**
+ * astal_wp_endpoint_set_volume_async:
+ * @self: the AstalWpEndpoint object
+ * @volume: the new volume in the scale of this endpoint
+ * @cancellable: (nullable): a GCancellable
+ * @callback: (scope async): called once PipeWire reported the new volume
+ * @user_data: data passed to @callback
+ *
+ * Like astal_wp_endpoint_set_volume, but completes once PipeWire reports the volume. The write
+ * fails with G_IO_ERROR_TIMED_OUT when it is not reported within a second.
+ */
+void astal_wp_endpoint_set_volume_async(AstalWpEndpoint *self, gdouble volume,
+                                        GCancellable *cancellable, GAsyncReadyCallback callback,
+                                        gpointer user_data) {
+    GTask *task = g_task_new(self, cancellable, callback, user_data);
+    g_task_set_source_tag(task, astal_wp_endpoint_set_volume_async);
+
+    astal_wp_ramp_cancel(self);
+    volume = astal_wp_endpoint_clamp_volume(self, volume);
+    astal_wp_endpoint_write_linear_volume(
+        self, astal_wp_endpoint_convert_volume(self, volume, TRUE), task);
+    g_object_unref(task);
+}
+
+/**
+ * astal_wp_endpoint_set_volume_finish:
+ * @self: the AstalWpEndpoint object
+ * @result: the GAsyncResult passed to the callback
+ * @round_trip: (out) (optional): the time in microseconds between the write and its report
+ * @error: return location for an error
+ *
+ * Finishes astal_wp_endpoint_set_volume_async.
+ *
+ * Returns: whether the volume was reported
+ */
+gboolean astal_wp_endpoint_set_volume_finish(AstalWpEndpoint *self, GAsyncResult *result,
+                                             gint64 *round_trip, GError **error) {
+    return astal_wp_pending_finish(self, result, round_trip, error);
+}
+
+/**
+ * astal_wp_endpoint_ramp_volume:
+ * @self: the AstalWpEndpoint object
+ * @volume: the volume to ramp to
+ * @duration_ms: the duration of the ramp in milliseconds
+ * @curve: how the volume progresses over the duration
+ *
+ * Changes the volume to @volume gradually over @duration_ms, keeping the balance of the channels.
+ * Every running ramp is advanced by one shared timer, and steps too small to be audible are not
+ * written. A ramp is cancelled by another ramp or astal_wp_endpoint_set_volume on the same node.
+ */
+void astal_wp_endpoint_ramp_volume(AstalWpEndpoint *self, gdouble volume, guint duration_ms,
+                                   AstalWpRampCurve curve) {
+    astal_wp_ramp_start(self, volume, g_get_monotonic_time(), duration_ms, curve);
+}
+
+/**
+ * astal_wp_endpoint_get_volume_in_scale:
+ * @self: the AstalWpEndpoint object
+ * @scale: the scale to report the volume in
+ *
+ * Converts the volume of this endpoint to @scale, regardless of the scale of the endpoint.
+ * ASTAL_WP_SCALE_CUSTOM uses the function set on this endpoint or on the AstalWpWp.
+ *
+ * Returns: the volume in @scale
+ */
+gdouble astal_wp_endpoint_get_volume_in_scale(AstalWpEndpoint *self, AstalWpScale scale) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return astal_wp_endpoint_convert(self, scale, priv->linear_volume, FALSE);
+}
+
+/**
+ * astal_wp_endpoint_set_volume_in_scale:
+ * @self: the AstalWpEndpoint object
+ * @scale: the scale of @volume
+ * @volume: the new volume
+ *
+ * Like astal_wp_endpoint_set_volume, with @volume given in @scale instead of the scale of the
+ * endpoint.
+ */
+void astal_wp_endpoint_set_volume_in_scale(AstalWpEndpoint *self, AstalWpScale scale,
+                                           gdouble volume) {
+    astal_wp_ramp_cancel(self);
+    volume = astal_wp_scale_clamp(scale, volume);
+    astal_wp_endpoint_write_linear_volume(
+        self, astal_wp_endpoint_convert(self, scale, volume, TRUE), NULL);
+}
+
+/**
+ * astal_wp_endpoint_get_scale:
+ * @self: the AstalWpEndpoint object
+ *
+ * Returns: the scale the volumes of this endpoint are reported and set in
+ */
+AstalWpScale astal_wp_endpoint_get_scale(AstalWpEndpoint *self) {
+    return astal_wp_endpoint_lookup_scale(self);
+}
+
+/**
+ * astal_wp_endpoint_set_scale:
+ * @self: the AstalWpEndpoint object
+ * @scale: the scale volumes should be reported and set in
+ *
+ * Sets a scale for this endpoint only, instead of following the scale of the AstalWpWp. The
+ * volumes are converted from cached linear volumes, switching the scale does not involve
+ * PipeWire.
+ */
+void astal_wp_endpoint_set_scale(AstalWpEndpoint *self, AstalWpScale scale) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    if (priv->has_scale && priv->scale == scale) return;
+    priv->has_scale = TRUE;
+    priv->scale = scale;
+    astal_wp_endpoint_update_scale(self);
+}
+
+/**
+ * astal_wp_endpoint_set_scale_func:
+ * @self: the AstalWpEndpoint object
+ * @func: (scope notified) (closure data) (destroy destroy): converts between linear volumes and
+ * the custom scale
+ * @data: data passed to @func
+ * @destroy: frees @data
+ *
+ * Sets the scale of this endpoint to ASTAL_WP_SCALE_CUSTOM, converting volumes with @func.
+ */
+void astal_wp_endpoint_set_scale_func(AstalWpEndpoint *self, AstalWpScaleFunc func, gpointer data,
+                                      GDestroyNotify destroy) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    if (priv->scale_destroy != NULL) priv->scale_destroy(priv->scale_data);
+    priv->scale_func = func;
+    priv->scale_data = data;
+    priv->scale_destroy = destroy;
+
+    priv->has_scale = TRUE;
+    priv->scale = ASTAL_WP_SCALE_CUSTOM;
+    astal_wp_endpoint_update_scale(self);
+}
+
+/**
+ * astal_wp_endpoint_unset_scale:
+ * @self: the AstalWpEndpoint object
+ *
+ * Makes this endpoint follow the scale of the AstalWpWp again.
+ */
+void astal_wp_endpoint_unset_scale(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    if (priv->scale_destroy != NULL) priv->scale_destroy(priv->scale_data);
+    priv->scale_func = NULL;
+    priv->scale_data = NULL;
+    priv->scale_destroy = NULL;
+
+    priv->has_scale = FALSE;
+    astal_wp_endpoint_update_scale(self);
+}
+
+/**
+ * astal_wp_endpoint_get_n_channels:
+ * @self: the AstalWpEndpoint object
+ *
+ * Returns: the number of channels of this endpoint, or 0 if the mixer only reports a single
+ * volume for it
+ */
+guint astal_wp_endpoint_get_n_channels(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->n_channels;
+}
+
+/**
+ * astal_wp_endpoint_get_channel_map:
+ * @self: the AstalWpEndpoint object
+ *
+ * The position of every channel, like "FL" or "FR", in the order used by the channel volume
+ * arrays.
+ *
+ * Returns: (transfer none) (array zero-terminated=1) (nullable): the channel map
+ */
+const gchar *const *astal_wp_endpoint_get_channel_map(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return (const gchar *const *)priv->channel_map;
+}
+
+/**
+ * astal_wp_endpoint_get_channel_volumes:
+ * @self: the AstalWpEndpoint object
+ * @n_channels: (out): the number of channels
+ *
+ * The volumes are in the scale of the endpoint. The returned array is owned by the endpoint and
+ * is only valid until the volume or the scale changes next.
+ *
+ * Returns: (transfer none) (array length=n_channels) (nullable): the volume of every channel
+ */
+const gdouble *astal_wp_endpoint_get_channel_volumes(AstalWpEndpoint *self, guint *n_channels) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (n_channels != NULL) *n_channels = priv->n_channels;
+    return priv->scaled_channel_volumes;
+}
+
+/**
+ * astal_wp_endpoint_get_channel_volumes_in_scale:
+ * @self: the AstalWpEndpoint object
+ * @scale: the scale to report the volumes in
+ * @volumes: (out caller-allocates) (array length=n_channels): the array to fill
+ * @n_channels: the length of @volumes
+ *
+ * Copies the volume of every channel converted to @scale into @volumes. At most @n_channels
+ * values are written.
+ *
+ * Returns: the number of channels of this endpoint
+ */
+guint astal_wp_endpoint_get_channel_volumes_in_scale(AstalWpEndpoint *self, AstalWpScale scale,
+                                                     gdouble *volumes, guint n_channels) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    gpointer data;
+    AstalWpScaleFunc func = astal_wp_endpoint_lookup_scale_func(self, &data);
+    astal_wp_scale_convert_array(scale, func, data, priv->channel_volumes, volumes,
+                                 MIN(n_channels, priv->n_channels), FALSE);
+    return priv->n_channels;
+}
+
+/**
+ * astal_wp_endpoint_get_channel_volumes_float:
+ * @self: the AstalWpEndpoint object
+ * @volumes: (out caller-allocates) (array length=n_channels): the array to fill
+ * @n_channels: the length of @volumes
+ *
+ * Copies the volume of every channel into @volumes as single precision floats, as used by most
+ * audio code. At most @n_channels values are written.
+ *
+ * Returns: the number of channels of this endpoint
+ */
+guint astal_wp_endpoint_get_channel_volumes_float(AstalWpEndpoint *self, gfloat *volumes,
+                                                  guint n_channels) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    guint n = MIN(n_channels, priv->n_channels);
+    const gdouble *current = priv->scaled_channel_volumes;
+    for (guint i = 0; i < n; i++) volumes[i] = (gfloat)current[i];
+    return priv->n_channels;
+}
+
+/**
+ * astal_wp_endpoint_get_channel_volume:
+ * @self: the AstalWpEndpoint object
+ * @channel: the index of the channel
+ *
+ * Returns: the volume of the channel, or the volume of the endpoint if it has no such channel
+ */
+gdouble astal_wp_endpoint_get_channel_volume(AstalWpEndpoint *self, guint channel) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (channel >= priv->n_channels) return self->volume;
+    return priv->scaled_channel_volumes[channel];
+}
+
+/**
+ * astal_wp_endpoint_set_channel_volumes:
+ * @self: the AstalWpEndpoint object
+ * @volumes: (array length=n_channels): the new volume of every channel
+ * @n_channels: the length of @volumes, which has to match the number of channels
+ *
+ * Sets the volume of every channel at once, in the order of the channel map. The volumes are
+ * clamped to be between 0 and 1.5. Cancels a running volume ramp.
+ */
+void astal_wp_endpoint_set_channel_volumes(AstalWpEndpoint *self, const gdouble *volumes,
+                                           guint n_channels) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    g_return_if_fail(n_channels > 0 && n_channels == priv->n_channels);
+
+    AstalWpScale scale = astal_wp_endpoint_lookup_scale(self);
+    gdouble *linear = g_newa(gdouble, n_channels);
+    for (guint i = 0; i < n_channels; i++) linear[i] = astal_wp_scale_clamp(scale, volumes[i]);
+
+    gpointer data;
+    AstalWpScaleFunc func = astal_wp_endpoint_lookup_scale_func(self, &data);
+    astal_wp_scale_convert_array(scale, func, data, linear, linear, n_channels, TRUE);
+
+    astal_wp_endpoint_set_linear_channel_volumes(self, linear, n_channels);
+}
+
+/**
+ * astal_wp_endpoint_set_channel_volumes_float:
+ * @self: the AstalWpEndpoint object
+ * @volumes: (array length=n_channels): the new volume of every channel
+ * @n_channels: the length of @volumes, which has to match the number of channels
+ *
+ * Like astal_wp_endpoint_set_channel_volumes, for single precision floats.
+ */
+void astal_wp_endpoint_set_channel_volumes_float(AstalWpEndpoint *self, const gfloat *volumes,
+                                                 guint n_channels) {
+    gdouble *converted = g_newa(gdouble, n_channels);
+    for (guint i = 0; i < n_channels; i++) converted[i] = volumes[i];
+    astal_wp_endpoint_set_channel_volumes(self, converted, n_channels);
+}
+
+/**
+ * astal_wp_endpoint_set_channel_volume:
+ * @self: the AstalWpEndpoint object
+ * @channel: the index of the channel
+ * @volume: the new volume of the channel
+ *
+ * Sets the volume of a single channel and leaves the other channels untouched.
+ */
+void astal_wp_endpoint_set_channel_volume(AstalWpEndpoint *self, guint channel, gdouble volume) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    g_return_if_fail(channel < priv->n_channels);
+
+    gdouble *volumes = g_newa(gdouble, priv->n_channels);
+    memcpy(volumes, priv->scaled_channel_volumes, priv->n_channels * sizeof(gdouble));
+    volumes[channel] = volume;
+    astal_wp_endpoint_set_channel_volumes(self, volumes, priv->n_channels);
+}
+
+static void astal_wp_endpoint_write_mute(AstalWpEndpoint *self, gboolean mute, GTask *task) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    if (priv->remote) {
+        astal_wp_wp_remote_command(priv->wp, "SetMute", g_variant_new("(ub)", self->id, mute));
+    } else if (priv->mixer == NULL) {
+        if (task != NULL)
+            g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+                                    "the mixer api is not loaded");
+        return;
+    } else {
+        gboolean ret;
+        GVariant *variant = NULL;
+        GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+        g_variant_builder_add(&b, "{sv}", "mute", g_variant_new_boolean(mute));
+        variant = g_variant_builder_end(&b);
+
+        gint64 start = g_get_monotonic_time();
+        g_signal_emit_by_name(priv->mixer, "set-volume", self->id, variant, &ret);
+        ASTAL_WP_WP_REPORT_CALL(priv->wp, "mixer-api set-volume", self->id, start);
+    }
+
+    if (!astal_wp_pending_begin(&priv->pending[ASTAL_WP_WRITE_MUTE], priv->wp, self->mute, mute,
+                                astal_wp_endpoint_is_optimistic(self), task))
+        return;
+    self->mute = mute;
+    g_object_notify(G_OBJECT(self), "mute");
+    g_object_notify(G_OBJECT(self), "volume-icon");
+}
+
+/**
+ * astal_wp_endpoint_set_mute:
+ * @self: the AstalWpEndpoint instance.
+ * @mute: A boolean indicating whether to mute the endpoint.
+ *
+ * Sets the mute status for the endpoint.
+ */
+void astal_wp_endpoint_set_mute(AstalWpEndpoint *self, gboolean mute) {
+    astal_wp_endpoint_write_mute(self, mute, NULL);
+}
+
+/**
+ * astal_wp_endpoint_set_mute_async:
+ * @self: the AstalWpEndpoint object
+ * @mute: whether to mute the endpoint
+ * @cancellable: (nullable): a GCancellable
+ * @callback: (scope async): called once PipeWire reported the new mute state
+ * @user_data: data passed to @callback
+ *
+ * Like astal_wp_endpoint_set_mute, but completes once PipeWire reports the mute state.
+ */
+void astal_wp_endpoint_set_mute_async(AstalWpEndpoint *self, gboolean mute,
+                                      GCancellable *cancellable, GAsyncReadyCallback callback,
+                                      gpointer user_data) {
+    GTask *task = g_task_new(self, cancellable, callback, user_data);
+    g_task_set_source_tag(task, astal_wp_endpoint_set_mute_async);
+    astal_wp_endpoint_write_mute(self, mute, task);
+    g_object_unref(task);
+}
+
+/**
+ * astal_wp_endpoint_set_mute_finish:
+ * @self: the AstalWpEndpoint object
+ * @result: the GAsyncResult passed to the callback
+ * @round_trip: (out) (optional): the time in microseconds between the write and its report
+ * @error: return location for an error
+ *
+ * Finishes astal_wp_endpoint_set_mute_async.
+ *
+ * Returns: whether the mute state was reported
+ */
+gboolean astal_wp_endpoint_set_mute_finish(AstalWpEndpoint *self, GAsyncResult *result,
+                                           gint64 *round_trip, GError **error) {
+    return astal_wp_pending_finish(self, result, round_trip, error);
+}
+
+/**
+ * astal_wp_endpoint_get_media_class:
+ * @self: the AstalWpEndpoint instance.
+ *
+ * gets the media class of the endpoint.
+ */
+AstalWpMediaClass astal_wp_endpoint_get_media_class(AstalWpEndpoint *self) { return self->type; }
+
+/**
+ * astal_wp_endpoint_get_id:
+ * @self: the AstalWpEndpoint instance.
+ *
+ * gets the id of the endpoint.
+ */
+guint astal_wp_endpoint_get_id(AstalWpEndpoint *self) { return self->id; }
+
+/**
+ * astal_wp_endpoint_get_mute:
+ * @self: the AstalWpEndpoint instance.
+ *
+ * gets the mute status of the endpoint.
+ */
+gboolean astal_wp_endpoint_get_mute(AstalWpEndpoint *self) { return self->mute; }
+
+/**
+ * astal_wp_endpoint_get_volume:
+ * @self: the AstalWpEndpoint instance.
+ *
+ * gets the volume
+ */
+gdouble astal_wp_endpoint_get_volume(AstalWpEndpoint *self) { return self->volume; }
+
+const gchar *astal_wp_endpoint_get_description(AstalWpEndpoint *self) { return self->description; }
+
+const gchar *astal_wp_endpoint_get_name(AstalWpEndpoint *self) { return self->name; }
+
+const gchar *astal_wp_endpoint_get_icon(AstalWpEndpoint *self) { return self->icon; }
+
+gboolean astal_wp_endpoint_get_is_default(AstalWpEndpoint *self) { return self->is_default; }
+
+static void astal_wp_endpoint_write_default(AstalWpEndpoint *self, GTask *task) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    if (priv->remote) {
+        astal_wp_wp_remote_command(priv->wp, "SetDefault", g_variant_new("(u)", self->id));
+    } else if (priv->defaults == NULL) {
+        if (task != NULL)
+            g_task_return_new_error(task, G_IO_ERROR, G_IO_ERROR_NOT_INITIALIZED,
+                                    "the default nodes api is not loaded");
+        return;
+    } else {
+        gboolean ret;
+        const gchar *name = astal_wp_endpoint_lookup_property(self, "node.name");
+        const gchar *media_class = astal_wp_endpoint_lookup_property(self, "media.class");
+        gint64 start = g_get_monotonic_time();
+        g_signal_emit_by_name(priv->defaults, "set-default-configured-node-name", media_class,
+                              name, &ret);
+        ASTAL_WP_WP_REPORT_CALL(priv->wp, "default-nodes-api set-default-configured-node-name",
+                                self->id, start);
+    }
+
+    // the default endpoints always are the default, writes through them complete right away
+    if (!astal_wp_pending_begin(&priv->pending[ASTAL_WP_WRITE_DEFAULT], priv->wp,
+                                self->is_default, TRUE, astal_wp_endpoint_is_optimistic(self),
+                                task))
+        return;
+    self->is_default = TRUE;
+    g_object_notify(G_OBJECT(self), "is-default");
+}
+
+void astal_wp_endpoint_set_is_default(AstalWpEndpoint *self, gboolean is_default) {
+    if (!is_default) return;
+    astal_wp_endpoint_write_default(self, NULL);
+}
+
+/**
+ * astal_wp_endpoint_set_is_default_async:
+ * @self: the AstalWpEndpoint object
+ * @cancellable: (nullable): a GCancellable
+ * @callback: (scope async): called once PipeWire reported this endpoint as the default
+ * @user_data: data passed to @callback
+ *
+ * Makes this endpoint the default like astal_wp_endpoint_set_is_default and completes once
+ * PipeWire reports it as the default.
+ */
+void astal_wp_endpoint_set_is_default_async(AstalWpEndpoint *self, GCancellable *cancellable,
+                                            GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = g_task_new(self, cancellable, callback, user_data);
+    g_task_set_source_tag(task, astal_wp_endpoint_set_is_default_async);
+    astal_wp_endpoint_write_default(self, task);
+    g_object_unref(task);
+}
+
+/**
+ * astal_wp_endpoint_set_is_default_finish:
+ * @self: the AstalWpEndpoint object
+ * @result: the GAsyncResult passed to the callback
+ * @round_trip: (out) (optional): the time in microseconds between the write and its report
+ * @error: return location for an error
+ *
+ * Finishes astal_wp_endpoint_set_is_default_async.
+ *
+ * Returns: whether this endpoint was reported as the default
+ */
+gboolean astal_wp_endpoint_set_is_default_finish(AstalWpEndpoint *self, GAsyncResult *result,
+                                                 gint64 *round_trip, GError **error) {
+    return astal_wp_pending_finish(self, result, round_trip, error);
+}
+
+gboolean astal_wp_endpoint_get_lock_channels(AstalWpEndpoint *self) { return self->lock_channels; }
+
+void astal_wp_endpoint_set_lock_channels(AstalWpEndpoint *self, gboolean lock_channels) {
+    self->lock_channels = lock_channels;
+    astal_wp_endpoint_set_volume(self, self->volume);
+}
+
+const gchar *astal_wp_endpoint_get_volume_icon(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    // the thresholds are perceived loudness, independent of the scale of this endpoint
+    gdouble volume = astal_wp_scale_from_linear(ASTAL_WP_SCALE_CUBIC, priv->linear_volume);
+
+    if (self->type == ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE) {
+        if (self->mute) return "microphone-sensitivity-muted-symbolic";
+        if (volume <= 0.33) return "microphone-sensitivity-low-symbolic";
+        if (volume <= 0.66) return "microphone-sensitivity-medium-symbolic";
+        return "microphone-sensitivity-high-symbolic";
+
+    } else {
+        if (self->mute) return "audio-volume-muted-symbolic";
+        if (volume <= 0.33) return "audio-volume-low-symbolic";
+        if (volume <= 0.66) return "audio-volume-medium-symbolic";
+        if (volume <= 1) return "audio-volume-high-symbolic";
+        return "audio-volume-overamplified-symbolic";
+    }
+}
+
+const gchar *astal_wp_endpoint_get_serial(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->serial;
+}
+
+const gchar *astal_wp_endpoint_get_node_name(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->node_name;
+}
+
+guint astal_wp_endpoint_get_client_id(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->client_id;
+}
+
+guint astal_wp_endpoint_get_device_id(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->device_id;
+}
+
+/**
+ * astal_wp_endpoint_get_device:
+ * @self: the AstalWpEndpoint object
+ *
+ * gets the device this endpoint belongs to, for example the sound card of a speaker
+ *
+ * Returns: (transfer none) (nullable)
+ */
+AstalWpDevice *astal_wp_endpoint_get_device(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->device;
+}
 
-} AstalWpEndpointPrivate;
+// speakers and microphones take the icon of their device
+static const gchar *astal_wp_endpoint_device_icon(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpEndpoint, astal_wp_endpoint, G_TYPE_OBJECT);
+    AstalWpDevice *device = priv->device;
+    if (device == NULL && priv->device_id != 0 && priv->wp != NULL)
+        device = astal_wp_wp_get_device(priv->wp, priv->device_id);
 
-G_DEFINE_ENUM_TYPE(AstalWpMediaClass, astal_wp_media_class,
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE, "Audio/Source"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER, "Audio/Sink"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_RECORDER, "Stream/Input/Audio"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_AUDIO_STREAM, "Stream/Output/Audio"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_SOURCE, "Video/Source"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_SINK, "Video/Sink"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_RECORDER, "Stream/Input/Video"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_MEDIA_CLASS_VIDEO_STREAM, "Stream/Output/Video"));
+    const gchar *icon = device != NULL ? astal_wp_device_get_icon(device) : NULL;
+    if (icon != NULL) return icon;
+    return self->type == ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER ? "audio-card-symbolic"
+                                                            : "audio-input-microphone-symbolic";
+}
 
-typedef enum {
-    ASTAL_WP_ENDPOINT_PROP_ID = 1,
-    ASTAL_WP_ENDPOINT_PROP_VOLUME,
-    ASTAL_WP_ENDPOINT_PROP_MUTE,
-    ASTAL_WP_ENDPOINT_PROP_DESCRIPTION,
-    ASTAL_WP_ENDPOINT_PROP_NAME,
-    ASTAL_WP_ENDPOINT_PROP_MEDIA_CLASS,
-    ASTAL_WP_ENDPOINT_PROP_DEFAULT,
-    ASTAL_WP_ENDPOINT_PROP_ICON,
-    ASTAL_WP_ENDPOINT_PROP_VOLUME_ICON,
-    ASTAL_WP_ENDPOINT_PROP_LOCK_CHANNELS,
-    ASTAL_WP_ENDPOINT_N_PROPERTIES,
-} AstalWpEndpointProperties;
+// links the device of this endpoint, resolving the icon which may have been a fallback so far
+void astal_wp_endpoint_set_device(AstalWpEndpoint *self, AstalWpDevice *device) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-static GParamSpec *astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_N_PROPERTIES] = {
-    NULL,
-};
+    if (priv->device == device) return;
+    priv->device = device;
+    g_object_notify(G_OBJECT(self), "device");
 
-void astal_wp_endpoint_update_volume(AstalWpEndpoint *self) {
+    // mirrored endpoints get the icon resolved by the other process
+    if (priv->remote || device == NULL) return;
+    if (self->type != ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER &&
+        self->type != ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE)
+        return;
+
+    const gchar *icon = astal_wp_endpoint_device_icon(self);
+    if (g_strcmp0(icon, self->icon) == 0) return;
+    g_free(self->icon);
+    self->icon = g_strdup(icon);
+    g_object_notify(G_OBJECT(self), "icon");
+}
+
+AstalWpWp *astal_wp_endpoint_get_wp(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->wp;
+}
 
-    gdouble volume = 0;
-    gboolean mute;
-    GVariant *variant = NULL;
-    GVariantIter *channels = NULL;
+/**
+ * astal_wp_endpoint_get_target:
+ * @self: the AstalWpEndpoint instance.
+ *
+ * gets the endpoint this stream is configured to be routed to. This is NULL if the stream
+ * follows the default endpoint.
+ *
+ * Returns: (transfer none) (nullable)
+ */
+AstalWpEndpoint *astal_wp_endpoint_get_target(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->wp == NULL) return NULL;
 
-    g_signal_emit_by_name(priv->mixer, "get-volume", self->id, &variant);
+    AstalWpEndpoint *target = astal_wp_wp_find_target(priv->wp, priv->target_object);
+    if (target == NULL && priv->target_node != NULL) {
+        target = astal_wp_wp_get_endpoint(priv->wp, g_ascii_strtoull(priv->target_node, NULL, 10));
+    }
+    return target;
+}
 
-    if (variant == NULL) return;
+void astal_wp_endpoint_write_target(AstalWpEndpoint *self, WpMetadata *metadata,
+                                    AstalWpEndpoint *target) {
+    AstalWpEndpointPrivate *target_priv =
+        target != NULL ? astal_wp_endpoint_get_instance_private(target) : NULL;
 
-    g_variant_lookup(variant, "volume", "d", &volume);
-    g_variant_lookup(variant, "mute", "b", &mute);
-    g_variant_lookup(variant, "channelVolumes", "a{sv}", &channels);
+    // target.node is deprecated, drop it so it can not override the new target.object
+    wp_metadata_set(metadata, self->id, "target.node", NULL, NULL);
 
-    if (channels != NULL) {
-        const gchar *key;
-        const gchar *channel_str;
-        gdouble channel_volume;
-        GVariant *varvol;
+    if (target_priv == NULL) {
+        wp_metadata_set(metadata, self->id, "target.object", NULL, NULL);
+    } else if (target_priv->serial != NULL) {
+        wp_metadata_set(metadata, self->id, "target.object", "Spa:Id", target_priv->serial);
+    } else {
+        wp_metadata_set(metadata, self->id, "target.object", "Spa:String",
+                        target_priv->node_name);
+    }
+}
 
-        while (g_variant_iter_loop(channels, "{&sv}", &key, &varvol)) {
-            g_variant_lookup(varvol, "volume", "d", &channel_volume);
-            g_variant_lookup(varvol, "channel", "&s", &channel_str);
-            if (channel_volume > volume) volume = channel_volume;
-        }
+/**
+ * astal_wp_endpoint_set_target:
+ * @self: the AstalWpEndpoint instance.
+ * @target: (nullable): the endpoint this stream should be routed to
+ *
+ * Routes this stream to the given endpoint through the default metadata. Passing NULL makes the
+ * stream follow the default endpoint again.
+ */
+void astal_wp_endpoint_set_target(AstalWpEndpoint *self, AstalWpEndpoint *target) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->wp == NULL) return;
+
+    if (priv->remote) {
+        guint target_id = target != NULL ? target->id : 0;
+        astal_wp_wp_remote_command(priv->wp, "SetTarget",
+                                   g_variant_new("(uu)", self->id, target_id));
+        return;
     }
 
-    if (mute != self->mute) {
-        self->mute = mute;
-        g_object_notify(G_OBJECT(self), "mute");
+    WpMetadata *metadata = astal_wp_wp_get_default_metadata(priv->wp);
+    if (metadata == NULL) {
+        g_warning("can not set target of endpoint %u: default metadata is not available",
+                  self->id);
+        return;
     }
 
-    if (volume != self->volume) {
-        self->volume = volume;
-        g_object_notify(G_OBJECT(self), "volume");
+    astal_wp_endpoint_write_target(self, metadata, target);
+}
+
+void astal_wp_endpoint_update_target(AstalWpEndpoint *self, const gchar *key, const gchar *value) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    gboolean changed = FALSE;
+
+    // a NULL key means every key of this subject was removed
+    if (key == NULL || g_strcmp0(key, "target.object") == 0) {
+        if (g_strcmp0(priv->target_object, value) != 0) {
+            g_free(priv->target_object);
+            priv->target_object = g_strdup(value);
+            changed = TRUE;
+        }
+    }
+    if (key == NULL || g_strcmp0(key, "target.node") == 0) {
+        if (g_strcmp0(priv->target_node, value) != 0) {
+            g_free(priv->target_node);
+            priv->target_node = g_strdup(value);
+            changed = TRUE;
+        }
     }
 
-    g_object_notify(G_OBJECT(self), "volume-icon");
+    if (changed) g_object_notify(G_OBJECT(self), "target");
 }
 
 /**
- * astal_wp_endpoint_set_volume:
- * @self: the AstalWpEndpoint object
- * @volume: The new volume level to set.
+ * astal_wp_endpoint_get_requested_latency:
+ * @self: the AstalWpEndpoint instance.
  *
- * Sets the volume level for this endpoint. The volume is clamped to be between
- * 0 and 1.5.
+ * gets the latency this node requested as a fraction, e.g. "256/48000".
+ *
+ * Returns: (nullable)
  */
-void astal_wp_endpoint_set_volume(AstalWpEndpoint *self, gdouble volume) {
+const gchar *astal_wp_endpoint_get_requested_latency(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->requested_latency;
+}
 
-    gboolean ret;
-    if (volume >= 1.5) volume = 1.5;
-    if (volume <= 0) volume = 0;
+/**
+ * astal_wp_endpoint_set_requested_latency:
+ * @self: the AstalWpEndpoint instance.
+ * @latency: (nullable): the latency as a fraction, e.g. "256/48000", or NULL to reset it
+ *
+ * Asks the client owning this node for a different latency by setting node.latency through its
+ * Props param. This is best-effort: most nodes, including the ALSA sinks and sources, ignore it,
+ * and there is no reply either way. The requested-latency property only changes if the node
+ * accepts the request and reports the new value, so watch it to tell whether the request had an
+ * effect. Does nothing on mirrored or replayed endpoints.
+ */
+void astal_wp_endpoint_set_requested_latency(AstalWpEndpoint *self, const gchar *latency) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->node == NULL) return;
 
-    gboolean mute;
-    GVariant *variant = NULL;
-    GVariantIter *channels = NULL;
+    g_autoptr(WpSpaPodBuilder) params = wp_spa_pod_builder_new_struct();
+    wp_spa_pod_builder_add_string(params, "node.latency");
+    if (latency != NULL)
+        wp_spa_pod_builder_add_string(params, latency);
+    else
+        wp_spa_pod_builder_add_none(params);
+    g_autoptr(WpSpaPod) struct_pod = wp_spa_pod_builder_end(params);
+
+    g_autoptr(WpSpaPodBuilder) builder =
+        wp_spa_pod_builder_new_object("Spa:Pod:Object:Param:Props", "Props");
+    wp_spa_pod_builder_add_property(builder, "params");
+    wp_spa_pod_builder_add_pod(builder, struct_pod);
+    g_autoptr(WpSpaPod) pod = wp_spa_pod_builder_end(builder);
+
+    wp_pipewire_object_set_param(WP_PIPEWIRE_OBJECT(priv->node), "Props", 0,
+                                 g_steal_pointer(&pod));
+}
 
-    g_auto(GVariantBuilder) vol_b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
-    g_signal_emit_by_name(priv->mixer, "get-volume", self->id, &variant);
+static void astal_wp_endpoint_update_latency(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->properties == NULL) return;
 
-    if (variant == NULL) return;
+    const gchar *latency = astal_wp_endpoint_lookup_property(self, "node.latency");
+    if (g_strcmp0(latency, priv->requested_latency) == 0) return;
 
-    g_variant_lookup(variant, "mute", "b", &mute);
-    g_variant_lookup(variant, "channelVolumes", "a{sv}", &channels);
+    g_free(priv->requested_latency);
+    priv->requested_latency = g_strdup(latency);
+    g_object_notify(G_OBJECT(self), "requested-latency");
+}
 
-    if (channels != NULL && !self->lock_channels) {
-        g_auto(GVariantBuilder) channel_volumes_b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+// replaces the properties of the node, as reported by the node or read from a journal
+void astal_wp_endpoint_set_properties(AstalWpEndpoint *self, WpProperties *properties) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-        const gchar *key;
-        const gchar *channel_str;
-        gdouble channel_volume;
-        GVariant *varvol;
+    g_clear_pointer(&priv->properties, wp_properties_unref);
+    priv->properties = wp_properties_ref(properties);
+    astal_wp_endpoint_update_latency(self);
+}
 
-        while (g_variant_iter_loop(channels, "{&sv}", &key, &varvol)) {
-            g_auto(GVariantBuilder) channel_b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
-            g_variant_lookup(varvol, "volume", "d", &channel_volume);
-            g_variant_lookup(varvol, "channel", "&s", &channel_str);
-            gdouble vol = self->volume == 0 ? volume : channel_volume * volume / self->volume;
-            g_variant_builder_add(&channel_b, "{sv}", "volume", g_variant_new_double(vol));
-            g_variant_builder_add(&channel_volumes_b, "{sv}", key,
-                                  g_variant_builder_end(&channel_b));
-        }
+WpProperties *astal_wp_endpoint_get_node_properties(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    return priv->properties;
+}
 
-        g_variant_builder_add(&vol_b, "{sv}", "channelVolumes",
-                              g_variant_builder_end(&channel_volumes_b));
-    } else {
-        GVariant *volume_variant = g_variant_new_double(volume);
-        g_variant_builder_add(&vol_b, "{sv}", "volume", volume_variant);
-    }
+static void astal_wp_endpoint_properties_changed(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-    g_signal_emit_by_name(priv->mixer, "set-volume", self->id, g_variant_builder_end(&vol_b), &ret);
+    WpProperties *properties = wp_pipewire_object_get_properties(WP_PIPEWIRE_OBJECT(priv->node));
+    if (properties == NULL) return;
+    // the properties wrap the info of the proxy, which is replaced on the next update
+    properties = wp_properties_ensure_unique_owner(properties);
+
+    if (astal_wp_wp_is_recording(priv->wp))
+        astal_wp_wp_record_input(priv->wp, ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES,
+                                 astal_wp_journal_properties(self->id, properties));
+    astal_wp_endpoint_set_properties(self, properties);
+    wp_properties_unref(properties);
 }
 
-/**
- * astal_wp_endpoint_set_mute:
- * @self: the AstalWpEndpoint instance.
- * @mute: A boolean indicating whether to mute the endpoint.
- *
- * Sets the mute status for the endpoint.
- */
-void astal_wp_endpoint_set_mute(AstalWpEndpoint *self, gboolean mute) {
+static GList *astal_wp_endpoint_get_links(AstalWpEndpoint *self, AstalWpDirection direction) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->wp == NULL) return NULL;
 
-    gboolean ret;
-    GVariant *variant = NULL;
-    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
-    g_variant_builder_add(&b, "{sv}", "mute", g_variant_new_boolean(mute));
-    variant = g_variant_builder_end(&b);
+    GPtrArray *links = astal_wp_wp_get_node_links(priv->wp, self->id, direction);
+    if (links == NULL) return NULL;
+
+    GList *list = NULL;
+    for (guint i = 0; i < links->len; i++) list = g_list_prepend(list, links->pdata[i]);
+    return list;
+}
 
-    g_signal_emit_by_name(priv->mixer, "set-volume", self->id, variant, &ret);
+static GList *astal_wp_endpoint_get_peers(AstalWpEndpoint *self, AstalWpDirection direction) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->wp == NULL) return NULL;
+
+    GPtrArray *links = astal_wp_wp_get_node_links(priv->wp, self->id, direction);
+    if (links == NULL) return NULL;
+
+    GList *peers = NULL;
+    // there is one link per port pair, so the same peer usually shows up once per channel
+    GHashTable *seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (guint i = 0; i < links->len; i++) {
+        AstalWpLink *link = links->pdata[i];
+        guint peer_id = direction == ASTAL_WP_DIRECTION_INPUT
+                            ? astal_wp_link_get_output_node(link)
+                            : astal_wp_link_get_input_node(link);
+        if (!g_hash_table_add(seen, GUINT_TO_POINTER(peer_id))) continue;
+
+        AstalWpEndpoint *peer = astal_wp_wp_get_endpoint(priv->wp, peer_id);
+        if (peer != NULL) peers = g_list_prepend(peers, peer);
+    }
+    g_hash_table_destroy(seen);
+    return peers;
 }
 
 /**
- * astal_wp_endpoint_get_media_class:
+ * astal_wp_endpoint_get_input_links:
  * @self: the AstalWpEndpoint instance.
  *
- * gets the media class of the endpoint.
+ * gets the links feeding into this endpoint.
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpLink))
  */
-AstalWpMediaClass astal_wp_endpoint_get_media_class(AstalWpEndpoint *self) { return self->type; }
+GList *astal_wp_endpoint_get_input_links(AstalWpEndpoint *self) {
+    return astal_wp_endpoint_get_links(self, ASTAL_WP_DIRECTION_INPUT);
+}
 
 /**
- * astal_wp_endpoint_get_id:
+ * astal_wp_endpoint_get_output_links:
  * @self: the AstalWpEndpoint instance.
  *
- * gets the id of the endpoint.
+ * gets the links this endpoint is feeding.
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpLink))
  */
-guint astal_wp_endpoint_get_id(AstalWpEndpoint *self) { return self->id; }
+GList *astal_wp_endpoint_get_output_links(AstalWpEndpoint *self) {
+    return astal_wp_endpoint_get_links(self, ASTAL_WP_DIRECTION_OUTPUT);
+}
 
 /**
- * astal_wp_endpoint_get_mute:
+ * astal_wp_endpoint_get_upstream:
  * @self: the AstalWpEndpoint instance.
  *
- * gets the mute status of the endpoint.
+ * gets the endpoints linked into this endpoint, e.g. the streams playing to a speaker.
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpEndpoint))
  */
-gboolean astal_wp_endpoint_get_mute(AstalWpEndpoint *self) { return self->mute; }
+GList *astal_wp_endpoint_get_upstream(AstalWpEndpoint *self) {
+    return astal_wp_endpoint_get_peers(self, ASTAL_WP_DIRECTION_INPUT);
+}
 
 /**
- * astal_wp_endpoint_get_volume:
+ * astal_wp_endpoint_get_downstream:
  * @self: the AstalWpEndpoint instance.
  *
- * gets the volume
+ * gets the endpoints this endpoint is linked to, e.g. the recorders of a microphone.
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpEndpoint))
  */
-gdouble astal_wp_endpoint_get_volume(AstalWpEndpoint *self) { return self->volume; }
-
-const gchar *astal_wp_endpoint_get_description(AstalWpEndpoint *self) { return self->description; }
+GList *astal_wp_endpoint_get_downstream(AstalWpEndpoint *self) {
+    return astal_wp_endpoint_get_peers(self, ASTAL_WP_DIRECTION_OUTPUT);
+}
 
-const gchar *astal_wp_endpoint_get_name(AstalWpEndpoint *self) { return self->name; }
+/**
+ * astal_wp_endpoint_get_ports:
+ * @self: the AstalWpEndpoint instance.
+ *
+ * gets the ports of this endpoint.
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpPort))
+ */
+GList *astal_wp_endpoint_get_ports(AstalWpEndpoint *self) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->wp == NULL) return NULL;
 
-const gchar *astal_wp_endpoint_get_icon(AstalWpEndpoint *self) { return self->icon; }
+    GPtrArray *ports = astal_wp_wp_get_node_ports(priv->wp, self->id);
+    if (ports == NULL) return NULL;
 
-gboolean astal_wp_endpoint_get_is_default(AstalWpEndpoint *self) { return self->is_default; }
+    GList *list = NULL;
+    for (guint i = 0; i < ports->len; i++) list = g_list_prepend(list, ports->pdata[i]);
+    return list;
+}
 
-void astal_wp_endpoint_set_is_default(AstalWpEndpoint *self, gboolean is_default) {
+// the state of this endpoint as a floating a{sv}, the keys match the D-Bus properties. Volumes
+// are linear, every process converts them to its own scale
+GVariant *astal_wp_endpoint_serialize(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    AstalWpEndpoint *target = astal_wp_endpoint_get_target(self);
+    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
 
-    if (!is_default) return;
-    gboolean ret;
-    const gchar *name =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "node.name");
-    const gchar *media_class =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "media.class");
-    g_signal_emit_by_name(priv->defaults, "set-default-configured-node-name", media_class, name,
-                          &ret);
+    g_variant_builder_add(&b, "{sv}", "Id", g_variant_new_uint32(self->id));
+    g_variant_builder_add(&b, "{sv}", "MediaClass", g_variant_new_uint32(self->type));
+    g_variant_builder_add(&b, "{sv}", "Description",
+                          g_variant_new_string(self->description ? self->description : ""));
+    g_variant_builder_add(&b, "{sv}", "Name", g_variant_new_string(self->name ? self->name : ""));
+    g_variant_builder_add(&b, "{sv}", "Icon", g_variant_new_string(self->icon ? self->icon : ""));
+    g_variant_builder_add(&b, "{sv}", "DeviceId", g_variant_new_uint32(priv->device_id));
+    g_variant_builder_add(&b, "{sv}", "Volume", g_variant_new_double(priv->linear_volume));
+    g_variant_builder_add(&b, "{sv}", "Mute", g_variant_new_boolean(self->mute));
+    g_variant_builder_add(&b, "{sv}", "IsDefault", g_variant_new_boolean(self->is_default));
+    g_variant_builder_add(&b, "{sv}", "Target",
+                          g_variant_new_uint32(target != NULL ? target->id : 0));
+    g_variant_builder_add(
+        &b, "{sv}", "ChannelMap",
+        g_variant_new_strv((const gchar *const *)priv->channel_map, priv->n_channels));
+    g_variant_builder_add(&b, "{sv}", "ChannelVolumes",
+                          g_variant_new_fixed_array(G_VARIANT_TYPE_DOUBLE, priv->channel_volumes,
+                                                    priv->n_channels, sizeof(gdouble)));
+
+    return g_variant_builder_end(&b);
 }
 
-gboolean astal_wp_endpoint_get_lock_channels(AstalWpEndpoint *self) { return self->lock_channels; }
+static void astal_wp_endpoint_apply_string(AstalWpEndpoint *self, gchar **field,
+                                           GVariant *value, const gchar *property) {
+    const gchar *str = g_variant_get_string(value, NULL);
+    if (*str == '\0') str = NULL;
+    if (g_strcmp0(*field, str) == 0) return;
 
-void astal_wp_endpoint_set_lock_channels(AstalWpEndpoint *self, gboolean lock_channels) {
-    self->lock_channels = lock_channels;
-    astal_wp_endpoint_set_volume(self, self->volume);
+    g_free(*field);
+    *field = g_strdup(str);
+    g_object_notify(G_OBJECT(self), property);
 }
 
-const gchar *astal_wp_endpoint_get_volume_icon(AstalWpEndpoint *self) {
-    if (self->type == ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE) {
-        if (self->mute) return "microphone-sensitivity-muted-symbolic";
-        if (self->volume <= 0.33) return "microphone-sensitivity-low-symbolic";
-        if (self->volume <= 0.66) return "microphone-sensitivity-medium-symbolic";
-        return "microphone-sensitivity-high-symbolic";
+// updates a mirrored endpoint from a{sv} as produced by astal_wp_endpoint_serialize. Missing keys
+// are left untouched and only properties which actually changed are notified.
+void astal_wp_endpoint_apply(AstalWpEndpoint *self, GVariant *state) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-    } else {
-        if (self->mute) return "audio-volume-muted-symbolic";
-        if (self->volume <= 0.33) return "audio-volume-low-symbolic";
-        if (self->volume <= 0.66) return "audio-volume-medium-symbolic";
-        if (self->volume <= 1) return "audio-volume-high-symbolic";
-        return "audio-volume-overamplified-symbolic";
+    GVariantIter iter;
+    const gchar *key;
+    GVariant *value;
+    gboolean volume_changed = FALSE;
+    g_autoptr(GVariant) channel_map = NULL;
+    g_autoptr(GVariant) channel_volumes = NULL;
+
+    g_object_freeze_notify(G_OBJECT(self));
+
+    g_variant_iter_init(&iter, state);
+    while (g_variant_iter_loop(&iter, "{&sv}", &key, &value)) {
+        if (g_strcmp0(key, "Id") == 0) {
+            guint id = g_variant_get_uint32(value);
+            if (id != self->id) {
+                self->id = id;
+                g_object_notify(G_OBJECT(self), "id");
+            }
+        } else if (g_strcmp0(key, "MediaClass") == 0) {
+            AstalWpMediaClass type = g_variant_get_uint32(value);
+            if (type != self->type) {
+                self->type = type;
+                g_object_notify(G_OBJECT(self), "media-class");
+            }
+        } else if (g_strcmp0(key, "Description") == 0) {
+            astal_wp_endpoint_apply_string(self, &self->description, value, "description");
+        } else if (g_strcmp0(key, "Name") == 0) {
+            astal_wp_endpoint_apply_string(self, &self->name, value, "name");
+        } else if (g_strcmp0(key, "Icon") == 0) {
+            astal_wp_endpoint_apply_string(self, &self->icon, value, "icon");
+        } else if (g_strcmp0(key, "DeviceId") == 0) {
+            priv->device_id = g_variant_get_uint32(value);
+        } else if (g_strcmp0(key, "Volume") == 0) {
+            gdouble volume = g_variant_get_double(value);
+            if (astal_wp_pending_reconcile(&priv->pending[ASTAL_WP_WRITE_VOLUME], volume) &&
+                astal_wp_endpoint_update_linear_volume(self, volume))
+                volume_changed = TRUE;
+        } else if (g_strcmp0(key, "Mute") == 0) {
+            gboolean mute = g_variant_get_boolean(value);
+            if (!astal_wp_pending_reconcile(&priv->pending[ASTAL_WP_WRITE_MUTE], mute)) continue;
+            if (mute != self->mute) {
+                self->mute = mute;
+                volume_changed = TRUE;
+                g_object_notify(G_OBJECT(self), "mute");
+            }
+        } else if (g_strcmp0(key, "IsDefault") == 0) {
+            // the default endpoints always are the default
+            gboolean is_default = priv->is_default_node || g_variant_get_boolean(value);
+            if (!astal_wp_pending_reconcile(&priv->pending[ASTAL_WP_WRITE_DEFAULT], is_default))
+                continue;
+            if (is_default != self->is_default) {
+                self->is_default = is_default;
+                g_object_notify(G_OBJECT(self), "is-default");
+            }
+        } else if (g_strcmp0(key, "Target") == 0) {
+            guint target = g_variant_get_uint32(value);
+            g_autofree gchar *target_node = target != 0 ? g_strdup_printf("%u", target) : NULL;
+            astal_wp_endpoint_update_target(self, "target.object", NULL);
+            astal_wp_endpoint_update_target(self, "target.node", target_node);
+        } else if (g_strcmp0(key, "ChannelMap") == 0) {
+            channel_map = g_variant_ref(value);
+        } else if (g_strcmp0(key, "ChannelVolumes") == 0) {
+            channel_volumes = g_variant_ref(value);
+        }
+    }
+
+    // PropertiesChanged only carries the channel map when it changed as well
+    if (channel_map != NULL || channel_volumes != NULL) {
+        gsize n_map = priv->n_channels;
+        gsize n_volumes = priv->n_channels;
+        gchar **map = channel_map != NULL ? g_variant_dup_strv(channel_map, &n_map)
+                                          : g_strdupv(priv->channel_map);
+        gdouble *volumes = NULL;
+
+        if (channel_volumes != NULL) {
+            const gdouble *v =
+                g_variant_get_fixed_array(channel_volumes, &n_volumes, sizeof(gdouble));
+            volumes = g_memdup2(v, n_volumes * sizeof(gdouble));
+        } else {
+            volumes = g_memdup2(priv->channel_volumes, n_volumes * sizeof(gdouble));
+        }
+
+        if (n_map == n_volumes) {
+            astal_wp_endpoint_update_channels(self, n_map, NULL, map, volumes);
+        } else {
+            g_strfreev(map);
+            g_free(volumes);
+        }
     }
+
+    if (volume_changed) g_object_notify(G_OBJECT(self), "volume-icon");
+
+    g_object_thaw_notify(G_OBJECT(self));
 }
 
 static void astal_wp_endpoint_get_property(GObject *object, guint property_id, GValue *value,
@@ -293,6 +1546,28 @@ static void astal_wp_endpoint_get_property(GObject *object, guint property_id, G
         case ASTAL_WP_ENDPOINT_PROP_LOCK_CHANNELS:
             g_value_set_boolean(value, self->lock_channels);
             break;
+        case ASTAL_WP_ENDPOINT_PROP_TARGET:
+            g_value_set_object(value, astal_wp_endpoint_get_target(self));
+            break;
+        case ASTAL_WP_ENDPOINT_PROP_REQUESTED_LATENCY:
+            g_value_set_string(value, astal_wp_endpoint_get_requested_latency(self));
+            break;
+        case ASTAL_WP_ENDPOINT_PROP_CHANNEL_MAP:
+            g_value_set_boxed(value, astal_wp_endpoint_get_channel_map(self));
+            break;
+        case ASTAL_WP_ENDPOINT_PROP_CHANNEL_VOLUMES: {
+            guint n;
+            const gdouble *volumes = astal_wp_endpoint_get_channel_volumes(self, &n);
+            g_value_take_variant(value, g_variant_new_fixed_array(G_VARIANT_TYPE_DOUBLE, volumes,
+                                                                  n, sizeof(gdouble)));
+            break;
+        }
+        case ASTAL_WP_ENDPOINT_PROP_SCALE:
+            g_value_set_enum(value, astal_wp_endpoint_get_scale(self));
+            break;
+        case ASTAL_WP_ENDPOINT_PROP_DEVICE:
+            g_value_set_object(value, astal_wp_endpoint_get_device(self));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -310,6 +1585,9 @@ static void astal_wp_endpoint_set_property(GObject *object, guint property_id, c
         case ASTAL_WP_ENDPOINT_PROP_VOLUME:
             astal_wp_endpoint_set_volume(self, g_value_get_double(value));
             break;
+        case ASTAL_WP_ENDPOINT_PROP_SCALE:
+            astal_wp_endpoint_set_scale(self, g_value_get_enum(value));
+            break;
         case ASTAL_WP_ENDPOINT_PROP_DEFAULT:
             astal_wp_endpoint_set_is_default(self, g_value_get_boolean(value));
             break;
@@ -320,6 +1598,12 @@ static void astal_wp_endpoint_set_property(GObject *object, guint property_id, c
         case ASTAL_WP_ENDPOINT_PROP_LOCK_CHANNELS:
             astal_wp_endpoint_set_lock_channels(self, g_value_get_boolean(value));
             break;
+        case ASTAL_WP_ENDPOINT_PROP_TARGET:
+            astal_wp_endpoint_set_target(self, g_value_get_object(value));
+            break;
+        case ASTAL_WP_ENDPOINT_PROP_REQUESTED_LATENCY:
+            astal_wp_endpoint_set_requested_latency(self, g_value_get_string(value));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -328,28 +1612,45 @@ static void astal_wp_endpoint_set_property(GObject *object, guint property_id, c
 
 static void astal_wp_endpoint_update_properties(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
-    if (priv->node == NULL) return;
-    self->id = wp_proxy_get_bound_id(WP_PROXY(priv->node));
+    if (priv->properties == NULL) return;
     astal_wp_endpoint_update_volume(self);
 
-    const gchar *description =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "node.description");
+    const gchar *description = astal_wp_endpoint_lookup_property(self, "node.description");
     if (description == NULL) {
-        description = wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "node.nick");
+        description = astal_wp_endpoint_lookup_property(self, "node.nick");
     }
     if (description == NULL) {
-        description = wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "node.name");
+        description = astal_wp_endpoint_lookup_property(self, "node.name");
     }
     g_free(self->description);
     self->description = g_strdup(description);
 
-    const gchar *name =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "media.name");
+    const gchar *name = astal_wp_endpoint_lookup_property(self, "media.name");
     g_free(self->name);
     self->name = g_strdup(name);
 
-    const gchar *type =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "media.class");
+    const gchar *serial = astal_wp_endpoint_lookup_property(self, "object.serial");
+    g_free(priv->serial);
+    priv->serial = g_strdup(serial);
+
+    const gchar *node_name = astal_wp_endpoint_lookup_property(self, "node.name");
+    g_free(priv->node_name);
+    priv->node_name = g_strdup(node_name);
+
+    const gchar *client_id = astal_wp_endpoint_lookup_property(self, "client.id");
+    priv->client_id = client_id != NULL ? g_ascii_strtoull(client_id, NULL, 10) : 0;
+
+    const gchar *device_id = astal_wp_endpoint_lookup_property(self, "device.id");
+    priv->device_id = device_id != NULL ? g_ascii_strtoull(device_id, NULL, 10) : 0;
+    // the default endpoints follow other nodes, drop a link to the device of the previous one
+    if (priv->device != NULL && astal_wp_device_get_id(priv->device) != priv->device_id) {
+        priv->device = NULL;
+        g_object_notify(G_OBJECT(self), "device");
+    }
+
+    astal_wp_endpoint_update_latency(self);
+
+    const gchar *type = astal_wp_endpoint_lookup_property(self, "media.class");
     GEnumClass *enum_class = g_type_class_ref(ASTAL_WP_TYPE_MEDIA_CLASS);
     if (g_enum_get_value_by_nick(enum_class, type) != NULL)
         self->type = g_enum_get_value_by_nick(enum_class, type)->value;
@@ -359,27 +1660,15 @@ static void astal_wp_endpoint_update_properties(AstalWpEndpoint *self) {
     switch (self->type) {
         case ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER:
         case ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE:
-            const gchar *dev =
-                wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "device.id");
-            guint device_id = g_ascii_strtoull(dev, NULL, 10);
-            AstalWpDevice *device = astal_wp_wp_get_device(priv->wp, device_id);
-            icon = astal_wp_device_get_icon(device);
-            if (icon == NULL) {
-                icon = self->type == ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER
-                           ? "audio-card-symbolic"
-                           : "audio-input-microphone-symbolic";
-            }
+            icon = astal_wp_endpoint_device_icon(self);
             break;
         case ASTAL_WP_MEDIA_CLASS_AUDIO_STREAM:
         case ASTAL_WP_MEDIA_CLASS_AUDIO_RECORDER:
-            icon =
-                wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "media.icon-name");
+            icon = astal_wp_endpoint_lookup_property(self, "media.icon-name");
             if (icon == NULL)
-                icon = wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node),
-                                                       "window.icon-name");
+                icon = astal_wp_endpoint_lookup_property(self, "window.icon-name");
             if (icon == NULL)
-                icon = wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node),
-                                                       "application.icon-name");
+                icon = astal_wp_endpoint_lookup_property(self, "application.icon-name");
             if (icon == NULL) icon = "application-x-executable-symbolic";
             break;
         default:
@@ -397,21 +1686,34 @@ static void astal_wp_endpoint_update_properties(AstalWpEndpoint *self) {
 
 static void astal_wp_endpoint_default_changed_as_default(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->defaults == NULL) return;
 
     GEnumClass *enum_class = g_type_class_ref(ASTAL_WP_TYPE_MEDIA_CLASS);
     const gchar *media_class = g_enum_get_value(enum_class, priv->media_class)->value_nick;
     guint defaultId;
+    gint64 start = g_get_monotonic_time();
     g_signal_emit_by_name(priv->defaults, "get-default-node", media_class, &defaultId);
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "default-nodes-api get-default-node", self->id, start);
+    if (astal_wp_wp_is_recording(priv->wp))
+        astal_wp_wp_record_input(priv->wp, ASTAL_WP_JOURNAL_DEFAULT_NODE,
+                                 g_variant_new("(su)", media_class, defaultId));
     g_type_class_unref(enum_class);
 
     if (defaultId != self->id) {
-        if (priv->node != NULL) g_object_unref(priv->node);
+        // writes to the previous node are not confirmed by the new one
+        for (guint i = 0; i < ASTAL_WP_WRITE_N_KINDS; i++)
+            astal_wp_pending_clear(&priv->pending[i]);
+        g_clear_object(&priv->node);
+        g_clear_pointer(&priv->properties, wp_properties_unref);
         AstalWpEndpoint *default_endpoint = astal_wp_wp_get_endpoint(priv->wp, defaultId);
         if (default_endpoint != NULL &&
             astal_wp_endpoint_get_media_class(default_endpoint) == priv->media_class) {
             AstalWpEndpointPrivate *default_endpoint_priv =
                 astal_wp_endpoint_get_instance_private(default_endpoint);
-            priv->node = g_object_ref(default_endpoint_priv->node);
+            if (default_endpoint_priv->node != NULL)
+                priv->node = g_object_ref(default_endpoint_priv->node);
+            priv->properties = wp_properties_ref(default_endpoint_priv->properties);
+            self->id = defaultId;
             astal_wp_endpoint_update_properties(self);
         }
     }
@@ -419,11 +1721,19 @@ static void astal_wp_endpoint_default_changed_as_default(AstalWpEndpoint *self)
 
 static void astal_wp_endpoint_default_changed(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+    if (priv->defaults == NULL) return;
 
     guint defaultId;
-    const gchar *media_class =
-        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->node), "media.class");
+    const gchar *media_class = astal_wp_endpoint_lookup_property(self, "media.class");
+    gint64 start = g_get_monotonic_time();
     g_signal_emit_by_name(priv->defaults, "get-default-node", media_class, &defaultId);
+    ASTAL_WP_WP_REPORT_CALL(priv->wp, "default-nodes-api get-default-node", self->id, start);
+    if (media_class != NULL && astal_wp_wp_is_recording(priv->wp))
+        astal_wp_wp_record_input(priv->wp, ASTAL_WP_JOURNAL_DEFAULT_NODE,
+                                 g_variant_new("(su)", media_class, defaultId));
+
+    if (!astal_wp_pending_reconcile(&priv->pending[ASTAL_WP_WRITE_DEFAULT], defaultId == self->id))
+        return;
 
     if (self->is_default && defaultId != self->id) {
         self->is_default = FALSE;
@@ -434,6 +1744,14 @@ static void astal_wp_endpoint_default_changed(AstalWpEndpoint *self) {
     }
 }
 
+// restores the reported state after an optimistic write was not confirmed in time
+static void astal_wp_endpoint_rollback(AstalWpEndpoint *self, AstalWpWriteKind kind) {
+    if (kind == ASTAL_WP_WRITE_DEFAULT)
+        astal_wp_endpoint_default_changed(self);
+    else
+        astal_wp_endpoint_update_volume(self);
+}
+
 static void astal_wp_endpoint_mixer_changed(AstalWpEndpoint *self, guint node_id) {
     if (self->id != node_id) return;
     astal_wp_endpoint_update_volume(self);
@@ -444,51 +1762,90 @@ AstalWpEndpoint *astal_wp_endpoint_init_as_default(AstalWpEndpoint *self, WpPlug
                                                    AstalWpWp *wp) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-    priv->mixer = g_object_ref(mixer);
-    priv->defaults = g_object_ref(defaults);
+    priv->mixer = mixer != NULL ? g_object_ref(mixer) : NULL;
+    priv->defaults = defaults != NULL ? g_object_ref(defaults) : NULL;
 
     priv->media_class = type;
     priv->is_default_node = TRUE;
     self->is_default = TRUE;
     priv->wp = g_object_ref(wp);
 
-    priv->default_signal_handler_id = g_signal_connect_swapped(
-        priv->defaults, "changed", G_CALLBACK(astal_wp_endpoint_default_changed_as_default), self);
-    priv->mixer_signal_handler_id = g_signal_connect_swapped(
-        priv->mixer, "changed", G_CALLBACK(astal_wp_endpoint_mixer_changed), self);
+    if (priv->defaults != NULL)
+        priv->default_signal_handler_id = g_signal_connect_swapped(
+            priv->defaults, "changed", G_CALLBACK(astal_wp_endpoint_default_changed_as_default),
+            self);
+    if (priv->mixer != NULL)
+        priv->mixer_signal_handler_id = g_signal_connect_swapped(
+            priv->mixer, "changed", G_CALLBACK(astal_wp_endpoint_mixer_changed), self);
 
     astal_wp_endpoint_default_changed_as_default(self);
     astal_wp_endpoint_update_properties(self);
     return self;
 }
 
-AstalWpEndpoint *astal_wp_endpoint_create(WpNode *node, WpPlugin *mixer, WpPlugin *defaults,
-                                          AstalWpWp *wp) {
+// node is NULL when a replay creates the endpoint, it is then only described by its properties
+AstalWpEndpoint *astal_wp_endpoint_create(guint id, WpNode *node, WpProperties *properties,
+                                          WpPlugin *mixer, WpPlugin *defaults, AstalWpWp *wp) {
     AstalWpEndpoint *self = g_object_new(ASTAL_WP_TYPE_ENDPOINT, NULL);
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-    priv->mixer = g_object_ref(mixer);
-    priv->defaults = g_object_ref(defaults);
-    priv->node = g_object_ref(node);
+    // either plugin is missing when its subsystem was not selected, see AstalWpWp:subsystems
+    priv->mixer = mixer != NULL ? g_object_ref(mixer) : NULL;
+    priv->defaults = defaults != NULL ? g_object_ref(defaults) : NULL;
+    priv->node = node != NULL ? g_object_ref(node) : NULL;
+    priv->properties = wp_properties_ref(properties);
     priv->is_default_node = FALSE;
+    self->id = id;
     priv->wp = g_object_ref(wp);
 
-    priv->default_signal_handler_id = g_signal_connect_swapped(
-        priv->defaults, "changed", G_CALLBACK(astal_wp_endpoint_default_changed), self);
-    priv->mixer_signal_handler_id = g_signal_connect_swapped(
-        priv->mixer, "changed", G_CALLBACK(astal_wp_endpoint_mixer_changed), self);
+    if (priv->defaults != NULL)
+        priv->default_signal_handler_id = g_signal_connect_swapped(
+            priv->defaults, "changed", G_CALLBACK(astal_wp_endpoint_default_changed), self);
+    if (priv->mixer != NULL)
+        priv->mixer_signal_handler_id = g_signal_connect_swapped(
+            priv->mixer, "changed", G_CALLBACK(astal_wp_endpoint_mixer_changed), self);
+    if (priv->node != NULL)
+        priv->properties_signal_handler_id =
+            g_signal_connect_swapped(priv->node, "notify::properties",
+                                     G_CALLBACK(astal_wp_endpoint_properties_changed), self);
 
     astal_wp_endpoint_update_properties(self);
     astal_wp_endpoint_default_changed(self);
     return self;
 }
 
+// turns self into a mirror of an endpoint owned by another process. Its state is only changed
+// through astal_wp_endpoint_apply and setters are forwarded through astal_wp_wp_remote_command.
+AstalWpEndpoint *astal_wp_endpoint_init_remote(AstalWpEndpoint *self, AstalWpWp *wp,
+                                               gboolean is_default_node) {
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
+
+    priv->remote = TRUE;
+    priv->is_default_node = is_default_node;
+    if (is_default_node) self->is_default = TRUE;
+    g_set_object(&priv->wp, wp);
+
+    return self;
+}
+
 static void astal_wp_endpoint_init(AstalWpEndpoint *self) {
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
     priv->node = NULL;
+    priv->properties = NULL;
     priv->mixer = NULL;
     priv->defaults = NULL;
     priv->wp = NULL;
+    priv->serial = NULL;
+    priv->node_name = NULL;
+    priv->target_object = NULL;
+    priv->target_node = NULL;
+    priv->requested_latency = NULL;
+    priv->properties_signal_handler_id = 0;
+    priv->remote = FALSE;
+
+    for (guint i = 0; i < ASTAL_WP_WRITE_N_KINDS; i++)
+        astal_wp_pending_init(&priv->pending[i], i,
+                              (AstalWpPendingRollbackFunc)astal_wp_endpoint_rollback, self);
 
     self->volume = 0;
     self->mute = TRUE;
@@ -500,10 +1857,17 @@ static void astal_wp_endpoint_dispose(GObject *object) {
     AstalWpEndpoint *self = ASTAL_WP_ENDPOINT(object);
     AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
 
-    g_signal_handler_disconnect(priv->defaults, priv->default_signal_handler_id);
-    g_signal_handler_disconnect(priv->mixer, priv->mixer_signal_handler_id);
+    if (priv->defaults != NULL)
+        g_signal_handler_disconnect(priv->defaults, priv->default_signal_handler_id);
+    if (priv->mixer != NULL) g_signal_handler_disconnect(priv->mixer, priv->mixer_signal_handler_id);
+    if (priv->properties_signal_handler_id != 0)
+        g_clear_signal_handler(&priv->properties_signal_handler_id, priv->node);
+
+    astal_wp_ramp_cancel(self);
+    for (guint i = 0; i < ASTAL_WP_WRITE_N_KINDS; i++) astal_wp_pending_clear(&priv->pending[i]);
 
     g_clear_object(&priv->node);
+    g_clear_pointer(&priv->properties, wp_properties_unref);
     g_clear_object(&priv->mixer);
     g_clear_object(&priv->defaults);
     g_clear_object(&priv->wp);
@@ -511,8 +1875,19 @@ static void astal_wp_endpoint_dispose(GObject *object) {
 
 static void astal_wp_endpoint_finalize(GObject *object) {
     AstalWpEndpoint *self = ASTAL_WP_ENDPOINT(object);
+    AstalWpEndpointPrivate *priv = astal_wp_endpoint_get_instance_private(self);
     g_free(self->description);
     g_free(self->name);
+    g_free(priv->serial);
+    g_free(priv->node_name);
+    g_free(priv->target_object);
+    g_free(priv->target_node);
+    g_free(priv->requested_latency);
+    g_strfreev(priv->channel_keys);
+    g_strfreev(priv->channel_map);
+    g_free(priv->channel_volumes);
+    g_free(priv->scaled_channel_volumes);
+    if (priv->scale_destroy != NULL) priv->scale_destroy(priv->scale_data);
 }
 
 static void astal_wp_endpoint_class_init(AstalWpEndpointClass *class) {
@@ -524,8 +1899,8 @@ static void astal_wp_endpoint_class_init(AstalWpEndpointClass *class) {
 
     astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_ID] =
         g_param_spec_uint("id", "id", "id", 0, UINT_MAX, 0, G_PARAM_READABLE);
-    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_VOLUME] =
-        g_param_spec_double("volume", "volume", "volume", 0, G_MAXFLOAT, 0, G_PARAM_READWRITE);
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_VOLUME] = g_param_spec_double(
+        "volume", "volume", "volume", ASTAL_WP_SCALE_DECIBEL_MIN, G_MAXFLOAT, 0, G_PARAM_READWRITE);
     astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_MUTE] =
         g_param_spec_boolean("mute", "mute", "mute", TRUE, G_PARAM_READWRITE);
     astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_DESCRIPTION] =
@@ -548,7 +1923,65 @@ static void astal_wp_endpoint_class_init(AstalWpEndpointClass *class) {
         g_param_spec_boolean("is_default", "is_default", "is_default", FALSE, G_PARAM_READWRITE);
     astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_LOCK_CHANNELS] = g_param_spec_boolean(
         "lock_channels", "lock_channels", "lock channels", FALSE, G_PARAM_READWRITE);
+    /**
+     * AstalWpEndpoint:target: (nullable)
+     *
+     * The endpoint this stream is routed to, or NULL if it follows the default endpoint.
+     */
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_TARGET] = g_param_spec_object(
+        "target", "target", "target", ASTAL_WP_TYPE_ENDPOINT, G_PARAM_READWRITE);
+    /**
+     * AstalWpEndpoint:requested-latency: (nullable)
+     *
+     * The latency this node requested as a fraction, e.g. "256/48000". Setting it is only a
+     * request most nodes ignore, see astal_wp_endpoint_set_requested_latency.
+     */
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_REQUESTED_LATENCY] =
+        g_param_spec_string("requested-latency", "requested-latency", "requested-latency", NULL,
+                            G_PARAM_READWRITE);
+    /**
+     * AstalWpEndpoint:channel-map: (nullable)
+     *
+     * The position of every channel, like "FL" or "FR".
+     */
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_CHANNEL_MAP] = g_param_spec_boxed(
+        "channel-map", "channel-map", "channel-map", G_TYPE_STRV, G_PARAM_READABLE);
+    /**
+     * AstalWpEndpoint:channel-volumes:
+     *
+     * The volume of every channel as an array of doubles, in the order of the channel map. Use
+     * astal_wp_endpoint_get_channel_volumes to read them without copying.
+     */
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_CHANNEL_VOLUMES] =
+        g_param_spec_variant("channel-volumes", "channel-volumes", "channel-volumes",
+                             G_VARIANT_TYPE("ad"), NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpEndpoint:scale: (type AstalWpScale)
+     *
+     * The scale the volumes of this endpoint are reported and set in. Follows the scale of the
+     * AstalWpWp until it is set.
+     */
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_SCALE] =
+        g_param_spec_enum("scale", "scale", "scale", ASTAL_WP_TYPE_SCALE, ASTAL_WP_SCALE_CUBIC,
+                          G_PARAM_READWRITE);
+    /**
+     * AstalWpEndpoint:device: (nullable)
+     *
+     * The device this endpoint belongs to. Set as soon as the device is known, which may be after
+     * the endpoint was added.
+     */
+    astal_wp_endpoint_properties[ASTAL_WP_ENDPOINT_PROP_DEVICE] = g_param_spec_object(
+        "device", "device", "device", ASTAL_WP_TYPE_DEVICE, G_PARAM_READABLE);
 
     g_object_class_install_properties(object_class, ASTAL_WP_ENDPOINT_N_PROPERTIES,
                                       astal_wp_endpoint_properties);
+
+    /**
+     * AstalWpEndpoint::links-changed:
+     *
+     * Emitted when a link to or from this endpoint was added or removed.
+     */
+    astal_wp_endpoint_signals[ASTAL_WP_ENDPOINT_SIGNAL_LINKS_CHANGED] =
+        g_signal_new("links-changed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 0);
 }
@@ -0,0 +1,52 @@
+#include <math.h>
+#include <string.h>
+
+#include "histogram-private.h"
+
+// Values below 2 * ASTAL_WP_HISTOGRAM_SUB_BUCKETS have a bucket each. Above that a value with its
+// highest bit at position SUB_BITS + shift lands in one of the SUB_BUCKETS buckets of its range,
+// chosen by the SUB_BITS bits below the highest one.
+
+static guint astal_wp_histogram_index(guint64 value) {
+    gint shift = (gint)g_bit_storage(value) - (ASTAL_WP_HISTOGRAM_SUB_BITS + 1);
+    if (shift <= 0) return value;
+    return shift * ASTAL_WP_HISTOGRAM_SUB_BUCKETS + (value >> shift);
+}
+
+// the highest value which is counted in the bucket at index
+static gint64 astal_wp_histogram_highest(guint index) {
+    if (index < 2 * ASTAL_WP_HISTOGRAM_SUB_BUCKETS) return index;
+
+    guint shift = index / ASTAL_WP_HISTOGRAM_SUB_BUCKETS - 1;
+    guint64 sub = index % ASTAL_WP_HISTOGRAM_SUB_BUCKETS + ASTAL_WP_HISTOGRAM_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+void astal_wp_histogram_record(AstalWpHistogram *self, gint64 value) {
+    if (value < 0) value = 0;
+    value = MIN(value, ((gint64)1 << ASTAL_WP_HISTOGRAM_MAX_BITS) - 1);
+
+    self->counts[astal_wp_histogram_index(value)]++;
+    self->total++;
+    if (value > self->max) self->max = value;
+}
+
+// gets the value below or at which percentile percent of the recorded values are, or 0 if nothing
+// was recorded. Like HdrHistogram this reports the highest value of the bucket, capped at the
+// highest recorded value.
+gint64 astal_wp_histogram_percentile(const AstalWpHistogram *self, gdouble percentile) {
+    if (self->total == 0) return 0;
+
+    percentile = CLAMP(percentile, 0, 100);
+    guint64 rank = MAX(ceil(percentile / 100 * self->total), 1);
+    guint64 seen = 0;
+
+    for (guint i = 0; i < ASTAL_WP_HISTOGRAM_SIZE; i++) {
+        seen += self->counts[i];
+        if (seen >= rank) return MIN(astal_wp_histogram_highest(i), self->max);
+    }
+
+    return self->max;
+}
+
+void astal_wp_histogram_reset(AstalWpHistogram *self) { memset(self, 0, sizeof(*self)); }
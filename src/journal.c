@@ -0,0 +1,626 @@
+#include <errno.h>
+#include <glib/gstdio.h>
+#include <spa/pod/pod.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "journal-private.h"
+#include "wp-private.h"
+#include "wp.h"
+
+// Records the raw inputs the handlers of an AstalWpWp consume: the properties of nodes and
+// devices, the params devices enumerate and the payloads of the mixer and default nodes apis. A
+// replay feeds them back through the same handlers, with stand-ins for the two plugins. Records
+// are padded to 8 bytes to keep the mapped variants aligned.
+
+#define ASTAL_WP_JOURNAL_ALIGN(size) (((size) + 7) & ~(gsize)7)
+
+static const gchar *astal_wp_journal_types[ASTAL_WP_JOURNAL_N_RECORDS] = {
+    [ASTAL_WP_JOURNAL_STATE] = "(a{sv}aa{sv}aa{sv})",
+    [ASTAL_WP_JOURNAL_DEFAULTS] = "a{sv}",
+    [ASTAL_WP_JOURNAL_ENDPOINT_ADDED] = "a{sv}",
+    [ASTAL_WP_JOURNAL_ENDPOINT_REMOVED] = "u",
+    [ASTAL_WP_JOURNAL_ENDPOINT_CHANGED] = "(ua{sv})",
+    [ASTAL_WP_JOURNAL_DEVICE_ADDED] = "a{sv}",
+    [ASTAL_WP_JOURNAL_DEVICE_REMOVED] = "u",
+    [ASTAL_WP_JOURNAL_DEVICE_CHANGED] = "(ua{sv})",
+    [ASTAL_WP_JOURNAL_PW_NODE_ADDED] = "(ua{ss})",
+    [ASTAL_WP_JOURNAL_PW_NODE_REMOVED] = "u",
+    [ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES] = "(ua{ss})",
+    [ASTAL_WP_JOURNAL_PW_DEVICE_ADDED] = "(ua{ss})",
+    [ASTAL_WP_JOURNAL_PW_DEVICE_REMOVED] = "u",
+    [ASTAL_WP_JOURNAL_PW_DEVICE_PARAMS] = "(usaay)",
+    [ASTAL_WP_JOURNAL_MIXER_VOLUME] = "(ua{sv})",
+    [ASTAL_WP_JOURNAL_DEFAULT_NODE] = "(su)",
+    [ASTAL_WP_JOURNAL_INSTALLED] = "()",
+};
+
+struct _AstalWpJournal {
+    AstalWpWp *wp;
+
+    FILE *file;
+    gint64 start;
+
+    // the latest input per object since the last flush, every object is written once per
+    // iteration. node id -> (ua{ss}) and (ua{sv}), device id -> GHashTable of param name ->
+    // (usaay), media class -> node id
+    GHashTable *dirty_properties;
+    GHashTable *dirty_volumes;
+    GHashTable *dirty_params;
+    GHashTable *dirty_defaults;
+    guint flush_id;
+};
+
+GVariant *astal_wp_journal_defaults(AstalWpWp *wp) {
+    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(
+        &b, "{sv}", "DefaultSpeaker",
+        g_variant_new_uint32(astal_wp_endpoint_get_id(astal_wp_wp_get_default_speaker(wp))));
+    g_variant_builder_add(
+        &b, "{sv}", "DefaultMicrophone",
+        g_variant_new_uint32(astal_wp_endpoint_get_id(astal_wp_wp_get_default_microphone(wp))));
+    return g_variant_builder_end(&b);
+}
+
+GVariant *astal_wp_journal_properties(guint id, WpProperties *properties) {
+    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("a{ss}"));
+
+    if (properties != NULL) {
+        WpIterator *iter = wp_properties_new_iterator(properties);
+        GValue item = G_VALUE_INIT;
+        while (wp_iterator_next(iter, &item)) {
+            WpPropertiesItem *pi = g_value_get_boxed(&item);
+            const gchar *value = wp_properties_item_get_value(pi);
+            g_variant_builder_add(&b, "{ss}", wp_properties_item_get_key(pi),
+                                  value != NULL ? value : "");
+            g_value_unset(&item);
+        }
+        wp_iterator_unref(iter);
+    }
+
+    return g_variant_new("(ua{ss})", id, &b);
+}
+
+static WpProperties *astal_wp_journal_parse_properties(GVariant *dict) {
+    WpProperties *properties = wp_properties_new_empty();
+
+    GVariantIter iter;
+    const gchar *key, *value;
+    g_variant_iter_init(&iter, dict);
+    while (g_variant_iter_next(&iter, "{&s&s}", &key, &value))
+        wp_properties_set(properties, key, value);
+
+    return properties;
+}
+
+GVariant *astal_wp_journal_params(guint id, const gchar *name, GPtrArray *pods) {
+    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("aay"));
+
+    for (guint i = 0; i < pods->len; i++) {
+        const struct spa_pod *pod = wp_spa_pod_get_spa_pod(pods->pdata[i]);
+        g_variant_builder_add_value(
+            &b, g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, pod, SPA_POD_SIZE(pod), 1));
+    }
+
+    return g_variant_new("(usaay)", id, name, &b);
+}
+
+// copies the recorded pods, byte arrays in the journal are not aligned the way spa expects
+static GPtrArray *astal_wp_journal_parse_params(GVariant *array) {
+    GPtrArray *pods = g_ptr_array_new_with_free_func((GDestroyNotify)wp_spa_pod_unref);
+
+    GVariantIter iter;
+    GVariant *bytes;
+    g_variant_iter_init(&iter, array);
+    while ((bytes = g_variant_iter_next_value(&iter)) != NULL) {
+        gsize size;
+        const guint8 *data = g_variant_get_fixed_array(bytes, &size, 1);
+
+        if (size >= sizeof(struct spa_pod)) {
+            struct spa_pod *pod = g_malloc(size);
+            memcpy(pod, data, size);
+            if (SPA_POD_SIZE(pod) <= size) {
+                WpSpaPod *wrapped = wp_spa_pod_new_wrap_const(pod);
+                g_ptr_array_add(pods, wp_spa_pod_ensure_unique_owner(wrapped));
+            }
+            g_free(pod);
+        }
+        g_variant_unref(bytes);
+    }
+
+    return pods;
+}
+
+static void astal_wp_journal_write(AstalWpJournal *self, AstalWpJournalRecordType type,
+                                   GVariant *value) {
+    static const guint8 padding[8] = {0};
+
+    g_variant_ref_sink(value);
+
+    AstalWpJournalRecord record = {
+        .time = g_get_monotonic_time() - self->start,
+        .type = type,
+        .size = g_variant_get_size(value),
+    };
+
+    fwrite(&record, sizeof(record), 1, self->file);
+    fwrite(g_variant_get_data(value), 1, record.size, self->file);
+    fwrite(padding, 1, ASTAL_WP_JOURNAL_ALIGN(record.size) - record.size, self->file);
+
+    g_variant_unref(value);
+}
+
+void astal_wp_journal_flush(AstalWpJournal *self) {
+    GHashTableIter iter, params;
+    gpointer key, value;
+
+    astal_wp_wp_clear_source(self->wp, &self->flush_id);
+
+    g_hash_table_iter_init(&iter, self->dirty_properties);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+        astal_wp_journal_write(self, ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES, value);
+    g_hash_table_remove_all(self->dirty_properties);
+
+    g_hash_table_iter_init(&iter, self->dirty_params);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        gpointer param;
+        g_hash_table_iter_init(&params, value);
+        while (g_hash_table_iter_next(&params, NULL, &param))
+            astal_wp_journal_write(self, ASTAL_WP_JOURNAL_PW_DEVICE_PARAMS, param);
+    }
+    g_hash_table_remove_all(self->dirty_params);
+
+    // the volumes and defaults last, the nodes they refer to are known by then
+    g_hash_table_iter_init(&iter, self->dirty_volumes);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+        astal_wp_journal_write(self, ASTAL_WP_JOURNAL_MIXER_VOLUME, value);
+    g_hash_table_remove_all(self->dirty_volumes);
+
+    g_hash_table_iter_init(&iter, self->dirty_defaults);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        astal_wp_journal_write(self, ASTAL_WP_JOURNAL_DEFAULT_NODE,
+                               g_variant_new("(su)", key, GPOINTER_TO_UINT(value)));
+    }
+    g_hash_table_remove_all(self->dirty_defaults);
+
+    fflush(self->file);
+}
+
+static gboolean astal_wp_journal_flush_idle(AstalWpJournal *self) {
+    self->flush_id = 0;
+    astal_wp_journal_flush(self);
+    return G_SOURCE_REMOVE;
+}
+
+static void astal_wp_journal_keep(GHashTable *table, GVariant *value) {
+    guint id;
+    g_variant_get_child(value, 0, "u", &id);
+    g_hash_table_insert(table, GUINT_TO_POINTER(id), g_variant_ref(value));
+}
+
+void astal_wp_journal_input(AstalWpJournal *self, AstalWpJournalRecordType type, GVariant *value) {
+    guint id;
+    const gchar *name;
+
+    g_variant_ref_sink(value);
+
+    switch (type) {
+        case ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES:
+            astal_wp_journal_keep(self->dirty_properties, value);
+            break;
+        case ASTAL_WP_JOURNAL_MIXER_VOLUME:
+            astal_wp_journal_keep(self->dirty_volumes, value);
+            break;
+        case ASTAL_WP_JOURNAL_PW_DEVICE_PARAMS: {
+            g_variant_get(value, "(u&s@aay)", &id, &name, NULL);
+            GHashTable *params = g_hash_table_lookup(self->dirty_params, GUINT_TO_POINTER(id));
+            if (params == NULL) {
+                params = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                               (GDestroyNotify)g_variant_unref);
+                g_hash_table_insert(self->dirty_params, GUINT_TO_POINTER(id), params);
+            }
+            g_hash_table_insert(params, g_strdup(name), g_variant_ref(value));
+            break;
+        }
+        case ASTAL_WP_JOURNAL_DEFAULT_NODE:
+            g_variant_get(value, "(&su)", &name, &id);
+            g_hash_table_insert(self->dirty_defaults, g_strdup(name), GUINT_TO_POINTER(id));
+            break;
+        case ASTAL_WP_JOURNAL_PW_NODE_ADDED: {
+            // the endpoint asks for the volume as soon as it is created
+            GVariant *volume;
+            g_variant_get_child(value, 0, "u", &id);
+            if (g_hash_table_steal_extended(self->dirty_volumes, GUINT_TO_POINTER(id), NULL,
+                                            (gpointer *)&volume)) {
+                astal_wp_journal_write(self, ASTAL_WP_JOURNAL_MIXER_VOLUME, volume);
+                g_variant_unref(volume);
+            }
+            astal_wp_journal_write(self, type, value);
+            break;
+        }
+        case ASTAL_WP_JOURNAL_PW_NODE_REMOVED:
+            id = g_variant_get_uint32(value);
+            g_hash_table_remove(self->dirty_properties, GUINT_TO_POINTER(id));
+            g_hash_table_remove(self->dirty_volumes, GUINT_TO_POINTER(id));
+            astal_wp_journal_write(self, type, value);
+            break;
+        case ASTAL_WP_JOURNAL_PW_DEVICE_REMOVED:
+            g_hash_table_remove(self->dirty_params,
+                                GUINT_TO_POINTER(g_variant_get_uint32(value)));
+            astal_wp_journal_write(self, type, value);
+            break;
+        default:
+            astal_wp_journal_write(self, type, value);
+            break;
+    }
+
+    g_variant_unref(value);
+
+    // bursts are written out together once the main loop is idle again
+    if (self->flush_id == 0)
+        self->flush_id = astal_wp_wp_idle_add(self->wp, G_PRIORITY_DEFAULT_IDLE,
+                                              (GSourceFunc)astal_wp_journal_flush_idle, self);
+}
+
+AstalWpJournal *astal_wp_journal_new(AstalWpWp *wp, const gchar *path, GError **error) {
+    FILE *file = g_fopen(path, "wb");
+    if (file == NULL) {
+        gint errsv = errno;
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errsv), "could not open %s: %s",
+                    path, g_strerror(errsv));
+        return NULL;
+    }
+
+    AstalWpJournal *self = g_new0(AstalWpJournal, 1);
+    self->wp = wp;
+    self->file = file;
+    self->start = g_get_monotonic_time();
+    self->dirty_properties = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                   (GDestroyNotify)g_variant_unref);
+    self->dirty_volumes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                (GDestroyNotify)g_variant_unref);
+    self->dirty_params = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                               (GDestroyNotify)g_hash_table_destroy);
+    self->dirty_defaults = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    AstalWpJournalHeader header = {ASTAL_WP_JOURNAL_MAGIC, ASTAL_WP_JOURNAL_VERSION};
+    fwrite(&header, sizeof(header), 1, file);
+
+    return self;
+}
+
+void astal_wp_journal_free(AstalWpJournal *self) {
+    if (self == NULL) return;
+
+    // inputs of the last iteration still belong into the journal
+    astal_wp_journal_flush(self);
+
+    g_hash_table_destroy(self->dirty_properties);
+    g_hash_table_destroy(self->dirty_volumes);
+    g_hash_table_destroy(self->dirty_params);
+    g_hash_table_destroy(self->dirty_defaults);
+    fclose(self->file);
+    g_free(self);
+}
+
+// applies a record through the astal_wp_wp_mirror_* functions
+void astal_wp_journal_apply(AstalWpWp *wp, AstalWpJournalRecordType type, GVariant *value) {
+    guint id;
+    g_autoptr(GVariant) state = NULL;
+
+    switch (type) {
+        case ASTAL_WP_JOURNAL_STATE: {
+            g_autoptr(GVariant) defaults = g_variant_get_child_value(value, 0);
+            g_autoptr(GVariant) endpoints = g_variant_get_child_value(value, 1);
+            g_autoptr(GVariant) devices = g_variant_get_child_value(value, 2);
+            astal_wp_wp_mirror_state(wp, defaults, endpoints, devices);
+            break;
+        }
+        case ASTAL_WP_JOURNAL_DEFAULTS:
+            astal_wp_wp_mirror_defaults(wp, value);
+            break;
+        case ASTAL_WP_JOURNAL_ENDPOINT_ADDED:
+            astal_wp_wp_mirror_endpoint(wp, value);
+            break;
+        case ASTAL_WP_JOURNAL_ENDPOINT_REMOVED:
+            astal_wp_wp_mirror_endpoint_removed(wp, g_variant_get_uint32(value));
+            break;
+        case ASTAL_WP_JOURNAL_ENDPOINT_CHANGED:
+            g_variant_get(value, "(u@a{sv})", &id, &state);
+            astal_wp_wp_mirror_endpoint_changed(wp, id, state);
+            break;
+        case ASTAL_WP_JOURNAL_DEVICE_ADDED:
+            astal_wp_wp_mirror_device(wp, value);
+            break;
+        case ASTAL_WP_JOURNAL_DEVICE_REMOVED:
+            astal_wp_wp_mirror_device_removed(wp, g_variant_get_uint32(value));
+            break;
+        case ASTAL_WP_JOURNAL_DEVICE_CHANGED:
+            g_variant_get(value, "(u@a{sv})", &id, &state);
+            astal_wp_wp_mirror_device_changed(wp, id, state);
+            break;
+        default:
+            break;
+    }
+}
+
+// stand-ins for the mixer and default nodes plugins while replaying, they answer the action
+// signals with what the journal reported last and refuse every write
+
+G_DECLARE_FINAL_TYPE(AstalWpReplayMixer, astal_wp_replay_mixer, ASTAL_WP, REPLAY_MIXER, WpPlugin)
+
+struct _AstalWpReplayMixer {
+    WpPlugin parent_instance;
+
+    // node id -> the a{sv} of get-volume
+    GHashTable *volumes;
+};
+
+G_DEFINE_FINAL_TYPE(AstalWpReplayMixer, astal_wp_replay_mixer, WP_TYPE_PLUGIN);
+
+static GVariant *astal_wp_replay_mixer_get_volume(AstalWpReplayMixer *self, guint id) {
+    GVariant *volume = g_hash_table_lookup(self->volumes, GUINT_TO_POINTER(id));
+    return volume != NULL ? g_variant_ref(volume) : NULL;
+}
+
+static gboolean astal_wp_replay_mixer_set_volume(AstalWpReplayMixer *self, guint id,
+                                                 GVariant *volume) {
+    return FALSE;
+}
+
+static void astal_wp_replay_mixer_init(AstalWpReplayMixer *self) {
+    self->volumes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                          (GDestroyNotify)g_variant_unref);
+}
+
+static void astal_wp_replay_mixer_finalize(GObject *object) {
+    AstalWpReplayMixer *self = ASTAL_WP_REPLAY_MIXER(object);
+    g_hash_table_destroy(self->volumes);
+    G_OBJECT_CLASS(astal_wp_replay_mixer_parent_class)->finalize(object);
+}
+
+static void astal_wp_replay_mixer_class_init(AstalWpReplayMixerClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->finalize = astal_wp_replay_mixer_finalize;
+
+    g_signal_new_class_handler("get-volume", G_TYPE_FROM_CLASS(class),
+                               G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+                               G_CALLBACK(astal_wp_replay_mixer_get_volume), NULL, NULL, NULL,
+                               G_TYPE_VARIANT, 1, G_TYPE_UINT);
+    g_signal_new_class_handler("set-volume", G_TYPE_FROM_CLASS(class),
+                               G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+                               G_CALLBACK(astal_wp_replay_mixer_set_volume), NULL, NULL, NULL,
+                               G_TYPE_BOOLEAN, 2, G_TYPE_UINT, G_TYPE_VARIANT);
+    g_signal_new("changed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL,
+                 G_TYPE_NONE, 1, G_TYPE_UINT);
+}
+
+G_DECLARE_FINAL_TYPE(AstalWpReplayDefaults, astal_wp_replay_defaults, ASTAL_WP, REPLAY_DEFAULTS,
+                     WpPlugin)
+
+struct _AstalWpReplayDefaults {
+    WpPlugin parent_instance;
+
+    // media class -> node id
+    GHashTable *nodes;
+};
+
+G_DEFINE_FINAL_TYPE(AstalWpReplayDefaults, astal_wp_replay_defaults, WP_TYPE_PLUGIN);
+
+static guint astal_wp_replay_defaults_get_default_node(AstalWpReplayDefaults *self,
+                                                       const gchar *media_class) {
+    gpointer id;
+    if (media_class == NULL ||
+        !g_hash_table_lookup_extended(self->nodes, media_class, NULL, &id))
+        return G_MAXUINT;
+    return GPOINTER_TO_UINT(id);
+}
+
+static gboolean astal_wp_replay_defaults_set_default_configured_node_name(
+    AstalWpReplayDefaults *self, const gchar *media_class, const gchar *name) {
+    return FALSE;
+}
+
+static void astal_wp_replay_defaults_init(AstalWpReplayDefaults *self) {
+    self->nodes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static void astal_wp_replay_defaults_finalize(GObject *object) {
+    AstalWpReplayDefaults *self = ASTAL_WP_REPLAY_DEFAULTS(object);
+    g_hash_table_destroy(self->nodes);
+    G_OBJECT_CLASS(astal_wp_replay_defaults_parent_class)->finalize(object);
+}
+
+static void astal_wp_replay_defaults_class_init(AstalWpReplayDefaultsClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->finalize = astal_wp_replay_defaults_finalize;
+
+    g_signal_new_class_handler("get-default-node", G_TYPE_FROM_CLASS(class),
+                               G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+                               G_CALLBACK(astal_wp_replay_defaults_get_default_node), NULL, NULL,
+                               NULL, G_TYPE_UINT, 1, G_TYPE_STRING);
+    g_signal_new_class_handler(
+        "set-default-configured-node-name", G_TYPE_FROM_CLASS(class),
+        G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+        G_CALLBACK(astal_wp_replay_defaults_set_default_configured_node_name), NULL, NULL, NULL,
+        G_TYPE_BOOLEAN, 2, G_TYPE_STRING, G_TYPE_STRING);
+    g_signal_new("changed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL,
+                 G_TYPE_NONE, 0);
+}
+
+struct _AstalWpReplay {
+    AstalWpWp *wp;
+    AstalWpReplayMixer *mixer;
+    AstalWpReplayDefaults *defaults;
+
+    GMappedFile *file;
+    GBytes *bytes;
+    gsize offset;
+
+    // 0 replays as fast as possible
+    gdouble speed;
+    gint64 start;
+    guint source_id;
+};
+
+static void astal_wp_replay_schedule(AstalWpReplay *self);
+
+// hands a raw input to the handlers of the AstalWpWp, or to the stand-in plugin it came from
+static void astal_wp_replay_feed(AstalWpReplay *self, AstalWpJournalRecordType type,
+                                 GVariant *value) {
+    guint id;
+    const gchar *name;
+    g_autoptr(GVariant) child = NULL;
+
+    switch (type) {
+        case ASTAL_WP_JOURNAL_PW_NODE_ADDED:
+        case ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES:
+        case ASTAL_WP_JOURNAL_PW_DEVICE_ADDED: {
+            g_variant_get(value, "(u@a{ss})", &id, &child);
+            WpProperties *properties = astal_wp_journal_parse_properties(child);
+            if (type == ASTAL_WP_JOURNAL_PW_NODE_ADDED)
+                astal_wp_wp_replay_node_added(self->wp, id, properties);
+            else if (type == ASTAL_WP_JOURNAL_PW_NODE_PROPERTIES)
+                astal_wp_wp_replay_node_properties(self->wp, id, properties);
+            else
+                astal_wp_wp_replay_device_added(self->wp, id, properties);
+            wp_properties_unref(properties);
+            break;
+        }
+        case ASTAL_WP_JOURNAL_PW_NODE_REMOVED:
+            id = g_variant_get_uint32(value);
+            astal_wp_wp_replay_node_removed(self->wp, id);
+            g_hash_table_remove(self->mixer->volumes, GUINT_TO_POINTER(id));
+            break;
+        case ASTAL_WP_JOURNAL_PW_DEVICE_REMOVED:
+            astal_wp_wp_replay_device_removed(self->wp, g_variant_get_uint32(value));
+            break;
+        case ASTAL_WP_JOURNAL_PW_DEVICE_PARAMS:
+            g_variant_get(value, "(u&s@aay)", &id, &name, &child);
+            astal_wp_wp_replay_device_params(self->wp, id, name,
+                                             astal_wp_journal_parse_params(child));
+            break;
+        case ASTAL_WP_JOURNAL_MIXER_VOLUME:
+            g_variant_get(value, "(u@a{sv})", &id, &child);
+            g_hash_table_insert(self->mixer->volumes, GUINT_TO_POINTER(id),
+                                g_steal_pointer(&child));
+            g_signal_emit_by_name(self->mixer, "changed", id);
+            break;
+        case ASTAL_WP_JOURNAL_DEFAULT_NODE:
+            g_variant_get(value, "(&su)", &name, &id);
+            g_hash_table_insert(self->defaults->nodes, g_strdup(name), GUINT_TO_POINTER(id));
+            g_signal_emit_by_name(self->defaults, "changed");
+            break;
+        case ASTAL_WP_JOURNAL_INSTALLED:
+            astal_wp_wp_replay_installed(self->wp);
+            break;
+        default:
+            // the a{sv} records only carry state between threads, see worker.c
+            break;
+    }
+}
+
+// reads the record at the current offset, returns FALSE at the end of the journal
+static gboolean astal_wp_replay_peek(AstalWpReplay *self, AstalWpJournalRecord *record) {
+    gsize length = g_bytes_get_size(self->bytes);
+    if (self->offset + sizeof(*record) > length) return FALSE;
+
+    memcpy(record, (const guint8 *)g_bytes_get_data(self->bytes, NULL) + self->offset,
+           sizeof(*record));
+
+    if (self->offset + sizeof(*record) + record->size > length) {
+        g_warning("the journal is truncated");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean astal_wp_replay_dispatch(AstalWpReplay *self) {
+    self->source_id = 0;
+
+    AstalWpJournalRecord record;
+    if (!astal_wp_replay_peek(self, &record)) {
+        g_signal_emit_by_name(self->wp, "replay-finished");
+        return G_SOURCE_REMOVE;
+    }
+
+    gsize offset = self->offset + sizeof(record);
+    self->offset = offset + ASTAL_WP_JOURNAL_ALIGN(record.size);
+
+    if (record.type < ASTAL_WP_JOURNAL_N_RECORDS) {
+        g_autoptr(GBytes) data = g_bytes_new_from_bytes(self->bytes, offset, record.size);
+        g_autoptr(GVariant) value = g_variant_ref_sink(g_variant_new_from_bytes(
+            G_VARIANT_TYPE(astal_wp_journal_types[record.type]), data, FALSE));
+        astal_wp_replay_feed(self, record.type, value);
+    }
+
+    astal_wp_replay_schedule(self);
+    return G_SOURCE_REMOVE;
+}
+
+static void astal_wp_replay_schedule(AstalWpReplay *self) {
+    AstalWpJournalRecord record;
+    gint64 delay = 0;
+
+    if (self->speed > 0 && astal_wp_replay_peek(self, &record)) {
+        gint64 deadline = self->start + (gint64)(record.time / self->speed);
+        delay = (deadline - g_get_monotonic_time()) / 1000;
+    }
+
+    if (delay > 0)
+        self->source_id = astal_wp_wp_timeout_add(self->wp, (guint)delay,
+                                                  (GSourceFunc)astal_wp_replay_dispatch, self);
+    else
+        self->source_id = astal_wp_wp_idle_add(self->wp, G_PRIORITY_DEFAULT_IDLE,
+                                               (GSourceFunc)astal_wp_replay_dispatch, self);
+}
+
+AstalWpReplay *astal_wp_replay_new(AstalWpWp *wp, const gchar *path, gdouble speed,
+                                   GError **error) {
+    GMappedFile *file = g_mapped_file_new(path, FALSE, error);
+    if (file == NULL) return NULL;
+
+    AstalWpJournalHeader header;
+    if (g_mapped_file_get_length(file) < sizeof(header)) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "%s is not a journal", path);
+        g_mapped_file_unref(file);
+        return NULL;
+    }
+
+    memcpy(&header, g_mapped_file_get_contents(file), sizeof(header));
+    if (header.magic != ASTAL_WP_JOURNAL_MAGIC || header.version != ASTAL_WP_JOURNAL_VERSION) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                    header.magic == GUINT32_SWAP_LE_BE(ASTAL_WP_JOURNAL_MAGIC)
+                        ? "%s was recorded with a different byte order"
+                        : "%s is not a journal of a supported version",
+                    path);
+        g_mapped_file_unref(file);
+        return NULL;
+    }
+
+    AstalWpReplay *self = g_new0(AstalWpReplay, 1);
+    self->wp = wp;
+    self->mixer = g_object_new(astal_wp_replay_mixer_get_type(), "name", "mixer-api", NULL);
+    self->defaults =
+        g_object_new(astal_wp_replay_defaults_get_type(), "name", "default-nodes-api", NULL);
+    self->file = file;
+    self->bytes = g_mapped_file_get_bytes(file);
+    self->offset = sizeof(header);
+    self->speed = speed;
+    self->start = g_get_monotonic_time();
+
+    astal_wp_wp_replay_begin(wp, WP_PLUGIN(self->mixer), WP_PLUGIN(self->defaults));
+    astal_wp_replay_schedule(self);
+    return self;
+}
+
+void astal_wp_replay_free(AstalWpReplay *self) {
+    if (self == NULL) return;
+
+    astal_wp_wp_clear_source(self->wp, &self->source_id);
+    g_object_unref(self->mixer);
+    g_object_unref(self->defaults);
+    g_bytes_unref(self->bytes);
+    g_mapped_file_unref(self->file);
+    g_free(self);
+}
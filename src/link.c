@@ -0,0 +1,233 @@
+#include "link.h"
+
+#include <wp/wp.h>
+
+#include "link-private.h"
+
+struct _AstalWpLink {
+    GObject parent_instance;
+
+    guint id;
+    guint output_node;
+    guint output_port;
+    guint input_node;
+    guint input_port;
+    AstalWpLinkState state;
+};
+
+typedef struct {
+    WpLink *link;
+    gulong state_signal_handler_id;
+} AstalWpLinkPrivate;
+
+G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpLink, astal_wp_link, G_TYPE_OBJECT);
+
+G_DEFINE_ENUM_TYPE(AstalWpLinkState, astal_wp_link_state,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_ERROR, "error"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_UNLINKED, "unlinked"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_INIT, "init"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_NEGOTIATING, "negotiating"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_ALLOCATING, "allocating"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_PAUSED, "paused"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_LINK_STATE_ACTIVE, "active"));
+
+typedef enum {
+    ASTAL_WP_LINK_PROP_ID = 1,
+    ASTAL_WP_LINK_PROP_OUTPUT_NODE,
+    ASTAL_WP_LINK_PROP_OUTPUT_PORT,
+    ASTAL_WP_LINK_PROP_INPUT_NODE,
+    ASTAL_WP_LINK_PROP_INPUT_PORT,
+    ASTAL_WP_LINK_PROP_STATE,
+    ASTAL_WP_LINK_N_PROPERTIES,
+} AstalWpLinkProperties;
+
+static GParamSpec *astal_wp_link_properties[ASTAL_WP_LINK_N_PROPERTIES] = {
+    NULL,
+};
+
+/**
+ * astal_wp_link_get_id
+ * @self: the AstalWpLink object
+ *
+ * gets the id of this link
+ *
+ */
+guint astal_wp_link_get_id(AstalWpLink *self) { return self->id; }
+
+/**
+ * astal_wp_link_get_output_node
+ * @self: the AstalWpLink object
+ *
+ * gets the id of the node this link reads from
+ *
+ */
+guint astal_wp_link_get_output_node(AstalWpLink *self) { return self->output_node; }
+
+/**
+ * astal_wp_link_get_output_port
+ * @self: the AstalWpLink object
+ *
+ * gets the id of the port this link reads from
+ *
+ */
+guint astal_wp_link_get_output_port(AstalWpLink *self) { return self->output_port; }
+
+/**
+ * astal_wp_link_get_input_node
+ * @self: the AstalWpLink object
+ *
+ * gets the id of the node this link writes to
+ *
+ */
+guint astal_wp_link_get_input_node(AstalWpLink *self) { return self->input_node; }
+
+/**
+ * astal_wp_link_get_input_port
+ * @self: the AstalWpLink object
+ *
+ * gets the id of the port this link writes to
+ *
+ */
+guint astal_wp_link_get_input_port(AstalWpLink *self) { return self->input_port; }
+
+/**
+ * astal_wp_link_get_state
+ * @self: the AstalWpLink object
+ *
+ * gets the current state of this link
+ *
+ */
+AstalWpLinkState astal_wp_link_get_state(AstalWpLink *self) { return self->state; }
+
+static void astal_wp_link_get_property(GObject *object, guint property_id, GValue *value,
+                                       GParamSpec *pspec) {
+    AstalWpLink *self = ASTAL_WP_LINK(object);
+
+    switch (property_id) {
+        case ASTAL_WP_LINK_PROP_ID:
+            g_value_set_uint(value, self->id);
+            break;
+        case ASTAL_WP_LINK_PROP_OUTPUT_NODE:
+            g_value_set_uint(value, self->output_node);
+            break;
+        case ASTAL_WP_LINK_PROP_OUTPUT_PORT:
+            g_value_set_uint(value, self->output_port);
+            break;
+        case ASTAL_WP_LINK_PROP_INPUT_NODE:
+            g_value_set_uint(value, self->input_node);
+            break;
+        case ASTAL_WP_LINK_PROP_INPUT_PORT:
+            g_value_set_uint(value, self->input_port);
+            break;
+        case ASTAL_WP_LINK_PROP_STATE:
+            g_value_set_enum(value, self->state);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+static void astal_wp_link_state_changed(AstalWpLink *self, WpLinkState old_state,
+                                        WpLinkState new_state) {
+    if ((AstalWpLinkState)new_state == self->state) return;
+    self->state = (AstalWpLinkState)new_state;
+    g_object_notify(G_OBJECT(self), "state");
+}
+
+static void astal_wp_link_update_properties(AstalWpLink *self) {
+    AstalWpLinkPrivate *priv = astal_wp_link_get_instance_private(self);
+    if (priv->link == NULL) return;
+    self->id = wp_proxy_get_bound_id(WP_PROXY(priv->link));
+
+    guint32 output_node, output_port, input_node, input_port;
+    wp_link_get_linked_object_ids(priv->link, &output_node, &output_port, &input_node,
+                                  &input_port);
+    self->output_node = output_node;
+    self->output_port = output_port;
+    self->input_node = input_node;
+    self->input_port = input_port;
+
+    self->state = (AstalWpLinkState)wp_link_get_state(priv->link, NULL);
+}
+
+AstalWpLink *astal_wp_link_create(WpLink *link) {
+    AstalWpLink *self = g_object_new(ASTAL_WP_TYPE_LINK, NULL);
+    AstalWpLinkPrivate *priv = astal_wp_link_get_instance_private(self);
+
+    priv->link = g_object_ref(link);
+
+    priv->state_signal_handler_id = g_signal_connect_swapped(
+        priv->link, "state-changed", G_CALLBACK(astal_wp_link_state_changed), self);
+
+    astal_wp_link_update_properties(self);
+    return self;
+}
+
+static void astal_wp_link_init(AstalWpLink *self) {
+    AstalWpLinkPrivate *priv = astal_wp_link_get_instance_private(self);
+    priv->link = NULL;
+
+    self->state = ASTAL_WP_LINK_STATE_INIT;
+}
+
+static void astal_wp_link_dispose(GObject *object) {
+    AstalWpLink *self = ASTAL_WP_LINK(object);
+    AstalWpLinkPrivate *priv = astal_wp_link_get_instance_private(self);
+
+    if (priv->link != NULL) g_signal_handler_disconnect(priv->link, priv->state_signal_handler_id);
+    g_clear_object(&priv->link);
+}
+
+static void astal_wp_link_class_init(AstalWpLinkClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->dispose = astal_wp_link_dispose;
+    object_class->get_property = astal_wp_link_get_property;
+
+    /**
+     * AstalWpLink:id
+     *
+     * The id of this link.
+     */
+    astal_wp_link_properties[ASTAL_WP_LINK_PROP_ID] =
+        g_param_spec_uint("id", "id", "id", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpLink:output-node
+     *
+     * The id of the node this link reads from.
+     */
+    astal_wp_link_properties[ASTAL_WP_LINK_PROP_OUTPUT_NODE] = g_param_spec_uint(
+        "output-node", "output-node", "output-node", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpLink:output-port
+     *
+     * The id of the port this link reads from.
+     */
+    astal_wp_link_properties[ASTAL_WP_LINK_PROP_OUTPUT_PORT] = g_param_spec_uint(
+        "output-port", "output-port", "output-port", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpLink:input-node
+     *
+     * The id of the node this link writes to.
+     */
+    astal_wp_link_properties[ASTAL_WP_LINK_PROP_INPUT_NODE] = g_param_spec_uint(
+        "input-node", "input-node", "input-node", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpLink:input-port
+     *
+     * The id of the port this link writes to.
+     */
+    astal_wp_link_properties[ASTAL_WP_LINK_PROP_INPUT_PORT] = g_param_spec_uint(
+        "input-port", "input-port", "input-port", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpLink:state: (type AstalWpLinkState)
+     *
+     * The current state of this link.
+     */
+    astal_wp_link_properties[ASTAL_WP_LINK_PROP_STATE] =
+        g_param_spec_enum("state", "state", "state", ASTAL_WP_TYPE_LINK_STATE,
+                          ASTAL_WP_LINK_STATE_INIT, G_PARAM_READABLE);
+
+    g_object_class_install_properties(object_class, ASTAL_WP_LINK_N_PROPERTIES,
+                                      astal_wp_link_properties);
+}
@@ -0,0 +1,160 @@
+#include <gio/gio.h>
+#include <string.h>
+
+#include "mirror-private.h"
+#include "service-private.h"
+#include "wp-private.h"
+#include "wp.h"
+
+// Mirrors the graph exported by an AstalWpService into a local AstalWpWp. Every state change is
+// applied through the same astal_wp_wp_mirror_* functions, so the local objects behave exactly
+// like the ones in the service process.
+
+struct _AstalWpMirror {
+    AstalWpWp *wp;
+
+    GDBusConnection *connection;
+    GCancellable *cancellable;
+    guint watch_id;
+    gchar *owner;
+
+    guint signals_id;
+    guint properties_id;
+};
+
+static void astal_wp_mirror_signal(GDBusConnection *connection, const gchar *sender,
+                                   const gchar *path, const gchar *interface, const gchar *signal,
+                                   GVariant *params, AstalWpMirror *self) {
+    if (g_strcmp0(signal, "EndpointAdded") == 0) {
+        g_autoptr(GVariant) state = g_variant_get_child_value(params, 0);
+        astal_wp_wp_mirror_endpoint(self->wp, state);
+    } else if (g_strcmp0(signal, "EndpointRemoved") == 0) {
+        guint id;
+        g_variant_get(params, "(u)", &id);
+        astal_wp_wp_mirror_endpoint_removed(self->wp, id);
+    } else if (g_strcmp0(signal, "DeviceAdded") == 0) {
+        g_autoptr(GVariant) state = g_variant_get_child_value(params, 0);
+        astal_wp_wp_mirror_device(self->wp, state);
+    } else if (g_strcmp0(signal, "DeviceRemoved") == 0) {
+        guint id;
+        g_variant_get(params, "(u)", &id);
+        astal_wp_wp_mirror_device_removed(self->wp, id);
+    }
+}
+
+static void astal_wp_mirror_properties_changed(GDBusConnection *connection, const gchar *sender,
+                                               const gchar *path, const gchar *interface,
+                                               const gchar *signal, GVariant *params,
+                                               AstalWpMirror *self) {
+    const gchar *changed_interface;
+    g_autoptr(GVariant) changed = NULL;
+    g_variant_get(params, "(&s@a{sv}@as)", &changed_interface, &changed, NULL);
+
+    if (g_strcmp0(path, ASTAL_WP_DBUS_PATH) == 0) {
+        astal_wp_wp_mirror_defaults(self->wp, changed);
+    } else if (g_str_has_prefix(path, ASTAL_WP_DBUS_ENDPOINT_PATH)) {
+        guint id = g_ascii_strtoull(path + strlen(ASTAL_WP_DBUS_ENDPOINT_PATH), NULL, 10);
+        astal_wp_wp_mirror_endpoint_changed(self->wp, id, changed);
+    } else if (g_str_has_prefix(path, ASTAL_WP_DBUS_DEVICE_PATH)) {
+        guint id = g_ascii_strtoull(path + strlen(ASTAL_WP_DBUS_DEVICE_PATH), NULL, 10);
+        astal_wp_wp_mirror_device_changed(self->wp, id, changed);
+    }
+}
+
+static void astal_wp_mirror_got_state(GDBusConnection *connection, GAsyncResult *result,
+                                      AstalWpMirror *self) {
+    GError *error = NULL;
+    GVariant *reply = g_dbus_connection_call_finish(connection, result, &error);
+    if (error != NULL) {
+        if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+            g_critical("could not get the state of %s: %s", ASTAL_WP_DBUS_NAME, error->message);
+        g_error_free(error);
+        return;
+    }
+
+    GVariant *defaults, *endpoints, *devices;
+    g_variant_get(reply, "(@a{sv}@aa{sv}@aa{sv})", &defaults, &endpoints, &devices);
+    astal_wp_wp_mirror_state(self->wp, defaults, endpoints, devices);
+
+    g_variant_unref(defaults);
+    g_variant_unref(endpoints);
+    g_variant_unref(devices);
+    g_variant_unref(reply);
+}
+
+static void astal_wp_mirror_name_appeared(GDBusConnection *connection, const gchar *name,
+                                          const gchar *owner, AstalWpMirror *self) {
+    g_set_object(&self->connection, connection);
+    g_free(self->owner);
+    self->owner = g_strdup(owner);
+
+    // subscribe before asking for the state, changes to unknown objects are simply dropped
+    self->signals_id = g_dbus_connection_signal_subscribe(
+        connection, owner, ASTAL_WP_DBUS_INTERFACE, NULL, ASTAL_WP_DBUS_PATH, NULL,
+        G_DBUS_SIGNAL_FLAGS_NONE, (GDBusSignalCallback)astal_wp_mirror_signal, self, NULL);
+    self->properties_id = g_dbus_connection_signal_subscribe(
+        connection, owner, "org.freedesktop.DBus.Properties", "PropertiesChanged", NULL, NULL,
+        G_DBUS_SIGNAL_FLAGS_NONE, (GDBusSignalCallback)astal_wp_mirror_properties_changed, self,
+        NULL);
+
+    self->cancellable = g_cancellable_new();
+    g_dbus_connection_call(connection, owner, ASTAL_WP_DBUS_PATH, ASTAL_WP_DBUS_INTERFACE,
+                           "GetState", NULL, G_VARIANT_TYPE("(a{sv}aa{sv}aa{sv})"),
+                           G_DBUS_CALL_FLAGS_NONE, -1, self->cancellable,
+                           (GAsyncReadyCallback)astal_wp_mirror_got_state, self);
+}
+
+static void astal_wp_mirror_disconnect(AstalWpMirror *self) {
+    if (self->cancellable != NULL) g_cancellable_cancel(self->cancellable);
+    g_clear_object(&self->cancellable);
+
+    if (self->connection != NULL) {
+        if (self->signals_id != 0)
+            g_dbus_connection_signal_unsubscribe(self->connection, self->signals_id);
+        if (self->properties_id != 0)
+            g_dbus_connection_signal_unsubscribe(self->connection, self->properties_id);
+    }
+    self->signals_id = 0;
+    self->properties_id = 0;
+
+    g_clear_pointer(&self->owner, g_free);
+}
+
+static void astal_wp_mirror_name_vanished(GDBusConnection *connection, const gchar *name,
+                                          AstalWpMirror *self) {
+    gboolean was_connected = self->owner != NULL;
+    astal_wp_mirror_disconnect(self);
+    if (was_connected) astal_wp_wp_mirror_clear(self->wp);
+}
+
+void astal_wp_mirror_call(AstalWpMirror *self, const gchar *method, GVariant *args) {
+    if (self->owner == NULL) {
+        g_warning("can not call %s: %s is not running", method, ASTAL_WP_DBUS_NAME);
+        g_variant_unref(g_variant_ref_sink(args));
+        return;
+    }
+
+    g_dbus_connection_call(self->connection, self->owner, ASTAL_WP_DBUS_PATH,
+                           ASTAL_WP_DBUS_INTERFACE, method, args, NULL, G_DBUS_CALL_FLAGS_NONE, -1,
+                           NULL, NULL, NULL);
+}
+
+AstalWpMirror *astal_wp_mirror_new(AstalWpWp *wp) {
+    AstalWpMirror *self = g_new0(AstalWpMirror, 1);
+    self->wp = wp;
+
+    self->watch_id = g_bus_watch_name(
+        G_BUS_TYPE_SESSION, ASTAL_WP_DBUS_NAME, G_BUS_NAME_WATCHER_FLAGS_NONE,
+        (GBusNameAppearedCallback)astal_wp_mirror_name_appeared,
+        (GBusNameVanishedCallback)astal_wp_mirror_name_vanished, self, NULL);
+    return self;
+}
+
+void astal_wp_mirror_free(AstalWpMirror *self) {
+    if (self == NULL) return;
+
+    g_bus_unwatch_name(self->watch_id);
+    astal_wp_mirror_disconnect(self);
+    g_clear_object(&self->connection);
+    g_free(self);
+}
@@ -0,0 +1,142 @@
+#include <math.h>
+
+#include "pending-private.h"
+#include "wp-private.h"
+
+// The mixer reports volumes as floats, anything closer than this is the value which was written.
+#define ASTAL_WP_PENDING_EPSILON 1e-4
+
+typedef struct {
+    // monotonic time of the write
+    gint64 time;
+    // the value the reported state has to match to confirm the write, linear for volumes
+    gdouble expected;
+    // completed with the round trip time in microseconds, nullable
+    GTask *task;
+} AstalWpPendingEntry;
+
+static void astal_wp_pending_entry_complete(AstalWpPendingEntry *entry, gint64 round_trip,
+                                            GError *error) {
+    if (entry->task != NULL) {
+        if (error != NULL)
+            g_task_return_error(entry->task, g_error_copy(error));
+        else if (!g_task_return_error_if_cancelled(entry->task))
+            g_task_return_int(entry->task, round_trip);
+        g_object_unref(entry->task);
+    }
+    g_free(entry);
+}
+
+// completes every write with @error, or successfully with their time so far
+static void astal_wp_pending_complete_all(AstalWpPendingWrite *self, GError *error) {
+    gint64 now = g_get_monotonic_time();
+    AstalWpPendingEntry *entry;
+    while ((entry = g_queue_pop_head(&self->writes)) != NULL)
+        astal_wp_pending_entry_complete(entry, now - entry->time, error);
+}
+
+static gboolean astal_wp_pending_timeout(AstalWpPendingWrite *self) {
+    self->timeout_id = 0;
+
+    g_autoptr(GError) error = g_error_new(G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                                          "PipeWire did not report the change within %u ms",
+                                          ASTAL_WP_PENDING_TIMEOUT_MS);
+    astal_wp_pending_complete_all(self, error);
+
+    if (self->optimistic) {
+        self->optimistic = FALSE;
+        astal_wp_wp_record_rollback(self->wp, self->kind);
+        self->rollback(self->data, self->kind);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+void astal_wp_pending_init(AstalWpPendingWrite *self, AstalWpWriteKind kind,
+                           AstalWpPendingRollbackFunc rollback, gpointer data) {
+    self->wp = NULL;
+    self->kind = kind;
+    g_queue_init(&self->writes);
+    self->optimistic = FALSE;
+    self->timeout_id = 0;
+    self->rollback = rollback;
+    self->data = data;
+}
+
+// tracks a write of @expected while the reported value is @current. A write of the value which is
+// already reported is not going to be reported again and completes right away. Returns whether
+// the caller applies @expected locally, which it does for tracked optimistic writes.
+gboolean astal_wp_pending_begin(AstalWpPendingWrite *self, AstalWpWp *wp, gdouble current,
+                                gdouble expected, gboolean optimistic, GTask *task) {
+    if (!optimistic && task == NULL) return FALSE;
+
+    AstalWpPendingEntry *entry = g_new0(AstalWpPendingEntry, 1);
+    entry->time = g_get_monotonic_time();
+    entry->expected = expected;
+    entry->task = task != NULL ? g_object_ref(task) : NULL;
+
+    if (g_queue_is_empty(&self->writes) && fabs(current - expected) <= ASTAL_WP_PENDING_EPSILON) {
+        astal_wp_pending_entry_complete(entry, 0, NULL);
+        return FALSE;
+    }
+
+    if (g_queue_get_length(&self->writes) == ASTAL_WP_PENDING_MAX_WRITES)
+        astal_wp_pending_entry_complete(g_queue_pop_head(&self->writes), 0, NULL);
+    g_queue_push_tail(&self->writes, entry);
+
+    if (self->wp != NULL) astal_wp_wp_clear_source(self->wp, &self->timeout_id);
+    self->wp = wp;
+    self->optimistic = optimistic;
+    self->timeout_id = astal_wp_wp_timeout_add(wp, ASTAL_WP_PENDING_TIMEOUT_MS,
+                                               (GSourceFunc)astal_wp_pending_timeout, self);
+    return optimistic;
+}
+
+// whether a reported @value should be applied. A value matching a write confirms it, earlier
+// writes were overwritten by it and complete as well. While the latest write is optimistic only
+// its own value is applied, anything else is the echo of an earlier write.
+gboolean astal_wp_pending_reconcile(AstalWpPendingWrite *self, gdouble value) {
+    if (g_queue_is_empty(&self->writes)) return TRUE;
+
+    gint matched = -1;
+    guint i = 0;
+    for (GList *l = self->writes.head; l != NULL; l = l->next, i++) {
+        AstalWpPendingEntry *entry = l->data;
+        if (fabs(value - entry->expected) <= ASTAL_WP_PENDING_EPSILON) matched = i;
+    }
+    if (matched < 0) return !self->optimistic;
+
+    gint64 now = g_get_monotonic_time();
+    for (gint j = 0; j <= matched; j++) {
+        AstalWpPendingEntry *entry = g_queue_pop_head(&self->writes);
+        if (j == matched) astal_wp_wp_record_confirmation(self->wp, self->kind, now - entry->time);
+        astal_wp_pending_entry_complete(entry, now - entry->time, NULL);
+    }
+
+    if (!g_queue_is_empty(&self->writes)) return !self->optimistic;
+
+    astal_wp_wp_clear_source(self->wp, &self->timeout_id);
+    self->optimistic = FALSE;
+    return TRUE;
+}
+
+// stops tracking, tasks still waiting fail as cancelled
+void astal_wp_pending_clear(AstalWpPendingWrite *self) {
+    if (self->wp != NULL) astal_wp_wp_clear_source(self->wp, &self->timeout_id);
+    self->optimistic = FALSE;
+    if (g_queue_is_empty(&self->writes)) return;
+
+    g_autoptr(GError) error =
+        g_error_new(G_IO_ERROR, G_IO_ERROR_CANCELLED, "the object was removed or replaced");
+    astal_wp_pending_complete_all(self, error);
+}
+
+// the finish function shared by every asynchronous setter
+gboolean astal_wp_pending_finish(gpointer source, GAsyncResult *result, gint64 *round_trip,
+                                 GError **error) {
+    g_return_val_if_fail(g_task_is_valid(result, source), FALSE);
+
+    gssize value = g_task_propagate_int(G_TASK(result), error);
+    if (value < 0) return FALSE;
+    if (round_trip != NULL) *round_trip = value;
+    return TRUE;
+}
@@ -0,0 +1,264 @@
+#include "port.h"
+
+#include <wp/wp.h>
+
+#include "port-private.h"
+
+struct _AstalWpPort {
+    GObject parent_instance;
+
+    guint id;
+    guint node_id;
+    gchar *name;
+    gchar *channel;
+    AstalWpDirection direction;
+    gboolean is_physical;
+    gboolean is_monitor;
+};
+
+typedef struct {
+    WpPort *port;
+} AstalWpPortPrivate;
+
+G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpPort, astal_wp_port, G_TYPE_OBJECT);
+
+G_DEFINE_ENUM_TYPE(AstalWpDirection, astal_wp_direction,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_DIRECTION_INPUT, "in"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_DIRECTION_OUTPUT, "out"));
+
+typedef enum {
+    ASTAL_WP_PORT_PROP_ID = 1,
+    ASTAL_WP_PORT_PROP_NODE_ID,
+    ASTAL_WP_PORT_PROP_NAME,
+    ASTAL_WP_PORT_PROP_CHANNEL,
+    ASTAL_WP_PORT_PROP_DIRECTION,
+    ASTAL_WP_PORT_PROP_IS_PHYSICAL,
+    ASTAL_WP_PORT_PROP_IS_MONITOR,
+    ASTAL_WP_PORT_N_PROPERTIES,
+} AstalWpPortProperties;
+
+static GParamSpec *astal_wp_port_properties[ASTAL_WP_PORT_N_PROPERTIES] = {
+    NULL,
+};
+
+/**
+ * astal_wp_port_get_id
+ * @self: the AstalWpPort object
+ *
+ * gets the id of this port
+ *
+ */
+guint astal_wp_port_get_id(AstalWpPort *self) { return self->id; }
+
+/**
+ * astal_wp_port_get_node_id
+ * @self: the AstalWpPort object
+ *
+ * gets the id of the node this port belongs to
+ *
+ */
+guint astal_wp_port_get_node_id(AstalWpPort *self) { return self->node_id; }
+
+/**
+ * astal_wp_port_get_name
+ * @self: the AstalWpPort object
+ *
+ * gets the name of this port
+ *
+ */
+const gchar *astal_wp_port_get_name(AstalWpPort *self) { return self->name; }
+
+/**
+ * astal_wp_port_get_channel
+ * @self: the AstalWpPort object
+ *
+ * gets the audio channel of this port, e.g. FL or FR
+ *
+ */
+const gchar *astal_wp_port_get_channel(AstalWpPort *self) { return self->channel; }
+
+/**
+ * astal_wp_port_get_direction
+ * @self: the AstalWpPort object
+ *
+ * gets the direction of this port
+ *
+ */
+AstalWpDirection astal_wp_port_get_direction(AstalWpPort *self) { return self->direction; }
+
+/**
+ * astal_wp_port_get_is_physical
+ * @self: the AstalWpPort object
+ *
+ * whether this port belongs to a physical device
+ *
+ */
+gboolean astal_wp_port_get_is_physical(AstalWpPort *self) { return self->is_physical; }
+
+/**
+ * astal_wp_port_get_is_monitor
+ * @self: the AstalWpPort object
+ *
+ * whether this port is a monitor port
+ *
+ */
+gboolean astal_wp_port_get_is_monitor(AstalWpPort *self) { return self->is_monitor; }
+
+static void astal_wp_port_get_property(GObject *object, guint property_id, GValue *value,
+                                       GParamSpec *pspec) {
+    AstalWpPort *self = ASTAL_WP_PORT(object);
+
+    switch (property_id) {
+        case ASTAL_WP_PORT_PROP_ID:
+            g_value_set_uint(value, self->id);
+            break;
+        case ASTAL_WP_PORT_PROP_NODE_ID:
+            g_value_set_uint(value, self->node_id);
+            break;
+        case ASTAL_WP_PORT_PROP_NAME:
+            g_value_set_string(value, self->name);
+            break;
+        case ASTAL_WP_PORT_PROP_CHANNEL:
+            g_value_set_string(value, self->channel);
+            break;
+        case ASTAL_WP_PORT_PROP_DIRECTION:
+            g_value_set_enum(value, self->direction);
+            break;
+        case ASTAL_WP_PORT_PROP_IS_PHYSICAL:
+            g_value_set_boolean(value, self->is_physical);
+            break;
+        case ASTAL_WP_PORT_PROP_IS_MONITOR:
+            g_value_set_boolean(value, self->is_monitor);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+static void astal_wp_port_update_properties(AstalWpPort *self) {
+    AstalWpPortPrivate *priv = astal_wp_port_get_instance_private(self);
+    if (priv->port == NULL) return;
+    self->id = wp_proxy_get_bound_id(WP_PROXY(priv->port));
+
+    const gchar *node_id =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->port), "node.id");
+    self->node_id = node_id != NULL ? g_ascii_strtoull(node_id, NULL, 10) : 0;
+
+    const gchar *name =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->port), "port.alias");
+    if (name == NULL) {
+        name = wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->port), "port.name");
+    }
+    g_free(self->name);
+    self->name = g_strdup(name);
+
+    const gchar *channel =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->port), "audio.channel");
+    g_free(self->channel);
+    self->channel = g_strdup(channel);
+
+    self->direction = wp_port_get_direction(priv->port) == WP_DIRECTION_OUTPUT
+                          ? ASTAL_WP_DIRECTION_OUTPUT
+                          : ASTAL_WP_DIRECTION_INPUT;
+
+    const gchar *physical =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->port), "port.physical");
+    self->is_physical = g_strcmp0(physical, "true") == 0;
+
+    const gchar *monitor =
+        wp_pipewire_object_get_property(WP_PIPEWIRE_OBJECT(priv->port), "port.monitor");
+    self->is_monitor = g_strcmp0(monitor, "true") == 0;
+}
+
+AstalWpPort *astal_wp_port_create(WpPort *port) {
+    AstalWpPort *self = g_object_new(ASTAL_WP_TYPE_PORT, NULL);
+    AstalWpPortPrivate *priv = astal_wp_port_get_instance_private(self);
+
+    priv->port = g_object_ref(port);
+
+    astal_wp_port_update_properties(self);
+    return self;
+}
+
+static void astal_wp_port_init(AstalWpPort *self) {
+    AstalWpPortPrivate *priv = astal_wp_port_get_instance_private(self);
+    priv->port = NULL;
+
+    self->name = NULL;
+    self->channel = NULL;
+}
+
+static void astal_wp_port_dispose(GObject *object) {
+    AstalWpPort *self = ASTAL_WP_PORT(object);
+    AstalWpPortPrivate *priv = astal_wp_port_get_instance_private(self);
+
+    g_clear_object(&priv->port);
+}
+
+static void astal_wp_port_finalize(GObject *object) {
+    AstalWpPort *self = ASTAL_WP_PORT(object);
+    g_free(self->name);
+    g_free(self->channel);
+}
+
+static void astal_wp_port_class_init(AstalWpPortClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->dispose = astal_wp_port_dispose;
+    object_class->finalize = astal_wp_port_finalize;
+    object_class->get_property = astal_wp_port_get_property;
+
+    /**
+     * AstalWpPort:id
+     *
+     * The id of this port.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_ID] =
+        g_param_spec_uint("id", "id", "id", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpPort:node-id
+     *
+     * The id of the node this port belongs to.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_NODE_ID] =
+        g_param_spec_uint("node-id", "node-id", "node-id", 0, UINT_MAX, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpPort:name
+     *
+     * The name of this port.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_NAME] =
+        g_param_spec_string("name", "name", "name", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpPort:channel
+     *
+     * The audio channel of this port.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_CHANNEL] =
+        g_param_spec_string("channel", "channel", "channel", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpPort:direction: (type AstalWpDirection)
+     *
+     * The direction of this port.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_DIRECTION] =
+        g_param_spec_enum("direction", "direction", "direction", ASTAL_WP_TYPE_DIRECTION,
+                          ASTAL_WP_DIRECTION_INPUT, G_PARAM_READABLE);
+    /**
+     * AstalWpPort:is-physical
+     *
+     * Whether this port belongs to a physical device.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_IS_PHYSICAL] = g_param_spec_boolean(
+        "is-physical", "is-physical", "is-physical", FALSE, G_PARAM_READABLE);
+    /**
+     * AstalWpPort:is-monitor
+     *
+     * Whether this port is a monitor port.
+     */
+    astal_wp_port_properties[ASTAL_WP_PORT_PROP_IS_MONITOR] =
+        g_param_spec_boolean("is-monitor", "is-monitor", "is-monitor", FALSE, G_PARAM_READABLE);
+
+    g_object_class_install_properties(object_class, ASTAL_WP_PORT_N_PROPERTIES,
+                                      astal_wp_port_properties);
+}
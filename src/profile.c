@@ -2,11 +2,18 @@
 
 #include <wp/wp.h>
 
+#include "profile-private.h"
+
 struct _AstalWpProfile {
     GObject parent_instance;
 
     gint index;
+    gchar *name;
     gchar *description;
+    gint priority;
+    // media class -> number of nodes the profile creates for it
+    GStrv classes;
+    guint *n_nodes;
 };
 
 G_DEFINE_FINAL_TYPE(AstalWpProfile, astal_wp_profile, G_TYPE_OBJECT);
@@ -14,6 +21,8 @@ G_DEFINE_FINAL_TYPE(AstalWpProfile, astal_wp_profile, G_TYPE_OBJECT);
 typedef enum {
     ASTAL_WP_PROFILE_PROP_INDEX = 1,
     ASTAL_WP_PROFILE_PROP_DESCRIPTION,
+    ASTAL_WP_PROFILE_PROP_NAME,
+    ASTAL_WP_PROFILE_PROP_PRIORITY,
     ASTAL_WP_PROFILE_N_PROPERTIES,
 } AstalWpProfileProperties;
 
@@ -25,6 +34,49 @@ gint astal_wp_profile_get_index(AstalWpProfile *self) { return self->index; }
 
 const gchar *astal_wp_profile_get_description(AstalWpProfile *self) { return self->description; }
 
+/**
+ * astal_wp_profile_get_name
+ * @self: the AstalWpProfile object
+ *
+ * gets the name of this profile, for example `output:analog-stereo+input:analog-stereo`
+ *
+ * Returns: (transfer none) (nullable)
+ */
+const gchar *astal_wp_profile_get_name(AstalWpProfile *self) { return self->name; }
+
+/**
+ * astal_wp_profile_get_priority
+ * @self: the AstalWpProfile object
+ *
+ * gets the priority of this profile, higher is preferred
+ */
+gint astal_wp_profile_get_priority(AstalWpProfile *self) { return self->priority; }
+
+/**
+ * astal_wp_profile_get_classes
+ * @self: the AstalWpProfile object
+ *
+ * gets the media classes of the nodes this profile creates, for example `Audio/Sink`
+ *
+ * Returns: (transfer none) (array zero-terminated=1)
+ */
+const gchar *const *astal_wp_profile_get_classes(AstalWpProfile *self) {
+    return (const gchar *const *)self->classes;
+}
+
+/**
+ * astal_wp_profile_get_n_nodes
+ * @self: the AstalWpProfile object
+ * @media_class: a media class like `Audio/Source`
+ *
+ * gets the number of nodes of @media_class this profile creates
+ */
+guint astal_wp_profile_get_n_nodes(AstalWpProfile *self, const gchar *media_class) {
+    for (guint i = 0; self->classes[i] != NULL; i++)
+        if (g_strcmp0(self->classes[i], media_class) == 0) return self->n_nodes[i];
+    return 0;
+}
+
 static void astal_wp_profile_get_property(GObject *object, guint property_id, GValue *value,
                                           GParamSpec *pspec) {
     AstalWpProfile *self = ASTAL_WP_PROFILE(object);
@@ -36,6 +88,12 @@ static void astal_wp_profile_get_property(GObject *object, guint property_id, GV
         case ASTAL_WP_PROFILE_PROP_DESCRIPTION:
             g_value_set_string(value, self->description);
             break;
+        case ASTAL_WP_PROFILE_PROP_NAME:
+            g_value_set_string(value, self->name);
+            break;
+        case ASTAL_WP_PROFILE_PROP_PRIORITY:
+            g_value_set_int(value, self->priority);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -54,17 +112,32 @@ static void astal_wp_profile_set_property(GObject *object, guint property_id, co
             g_free(self->description);
             self->description = g_strdup(g_value_get_string(value));
             break;
+        case ASTAL_WP_PROFILE_PROP_NAME:
+            g_free(self->name);
+            self->name = g_strdup(g_value_get_string(value));
+            break;
+        case ASTAL_WP_PROFILE_PROP_PRIORITY:
+            self->priority = g_value_get_int(value);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
     }
 }
 
-static void astal_wp_profile_init(AstalWpProfile *self) { self->description = NULL; }
+static void astal_wp_profile_init(AstalWpProfile *self) {
+    self->name = NULL;
+    self->description = NULL;
+    self->classes = g_new0(gchar *, 1);
+    self->n_nodes = NULL;
+}
 
 static void astal_wp_profile_finalize(GObject *object) {
     AstalWpProfile *self = ASTAL_WP_PROFILE(object);
+    g_free(self->name);
     g_free(self->description);
+    g_strfreev(self->classes);
+    g_free(self->n_nodes);
 }
 
 static void astal_wp_profile_class_init(AstalWpProfileClass *class) {
@@ -79,6 +152,148 @@ static void astal_wp_profile_class_init(AstalWpProfileClass *class) {
     astal_wp_profile_properties[ASTAL_WP_PROFILE_PROP_INDEX] =
         g_param_spec_int("index", "index", "index", G_MININT, G_MAXINT, 0,
                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    astal_wp_profile_properties[ASTAL_WP_PROFILE_PROP_NAME] = g_param_spec_string(
+        "name", "name", "name", NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    astal_wp_profile_properties[ASTAL_WP_PROFILE_PROP_PRIORITY] =
+        g_param_spec_int("priority", "priority", "priority", G_MININT, G_MAXINT, 0,
+                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
     g_object_class_install_properties(object_class, ASTAL_WP_PROFILE_N_PROPERTIES,
                                       astal_wp_profile_properties);
 }
+
+struct _AstalWpProfileSet {
+    // protected by the catalog lock, the set is removed from the catalog when it drops to 0
+    guint ref_count;
+
+    // ASTAL_WP_PROFILE_SET_TYPE in normal form, the key of the catalog
+    GVariant *key;
+    // AstalWpProfile in the order they were enumerated
+    GPtrArray *profiles;
+};
+
+// GVariant -> AstalWpProfileSet, not owning the sets. Devices can be created on the thread of a
+// threaded backend and on the main thread at the same time, so all access holds the lock.
+static GHashTable *astal_wp_profile_catalog = NULL;
+G_LOCK_DEFINE_STATIC(astal_wp_profile_catalog);
+
+static guint astal_wp_profile_set_hash(gconstpointer key) {
+    gsize size = g_variant_get_size((GVariant *)key);
+    const guint8 *data = g_variant_get_data((GVariant *)key);
+
+    // djb2, the same as g_str_hash but over the serialized data
+    guint32 hash = 5381;
+    for (gsize i = 0; i < size; i++) hash = (hash << 5) + hash + data[i];
+    return hash;
+}
+
+// takes ownership of @key
+static AstalWpProfileSet *astal_wp_profile_set_new(GVariant *key) {
+    AstalWpProfileSet *self = g_new0(AstalWpProfileSet, 1);
+    self->ref_count = 1;
+    self->key = key;
+    self->profiles = g_ptr_array_new_with_free_func(g_object_unref);
+
+    GVariantIter iter, classes;
+    gint index, priority;
+    const gchar *name, *description, *class;
+    guint n_nodes;
+    g_variant_iter_init(&iter, key);
+    while (g_variant_iter_next(&iter, "(i&s&sia(su))", &index, &name, &description, &priority,
+                               &classes)) {
+        AstalWpProfile *profile =
+            g_object_new(ASTAL_WP_TYPE_PROFILE, "index", index, "name", *name ? name : NULL,
+                         "description", description, "priority", priority, NULL);
+
+        gsize n = g_variant_iter_n_children(&classes);
+        g_free(profile->classes);
+        profile->classes = g_new0(gchar *, n + 1);
+        profile->n_nodes = g_new0(guint, n);
+        for (gsize i = 0; g_variant_iter_next(&classes, "(&su)", &class, &n_nodes); i++) {
+            profile->classes[i] = g_strdup(class);
+            profile->n_nodes[i] = n_nodes;
+        }
+
+        g_ptr_array_add(self->profiles, profile);
+    }
+    return self;
+}
+
+// returns the set with the profiles of @profiles, an ASTAL_WP_PROFILE_SET_TYPE. Floating
+// references are sunk.
+AstalWpProfileSet *astal_wp_profile_set_intern(GVariant *profiles) {
+    g_return_val_if_fail(
+        g_variant_is_of_type(profiles, G_VARIANT_TYPE(ASTAL_WP_PROFILE_SET_TYPE)), NULL);
+
+    GVariant *key = g_variant_get_normal_form(profiles);
+    g_variant_unref(g_variant_ref_sink(profiles));
+
+    G_LOCK(astal_wp_profile_catalog);
+    if (astal_wp_profile_catalog == NULL)
+        astal_wp_profile_catalog =
+            g_hash_table_new(astal_wp_profile_set_hash, (GEqualFunc)g_variant_equal);
+
+    AstalWpProfileSet *self = g_hash_table_lookup(astal_wp_profile_catalog, key);
+    if (self != NULL) {
+        self->ref_count++;
+        g_variant_unref(key);
+    } else {
+        self = astal_wp_profile_set_new(key);
+        g_hash_table_insert(astal_wp_profile_catalog, self->key, self);
+    }
+    G_UNLOCK(astal_wp_profile_catalog);
+
+    return self;
+}
+
+AstalWpProfileSet *astal_wp_profile_set_ref(AstalWpProfileSet *self) {
+    G_LOCK(astal_wp_profile_catalog);
+    self->ref_count++;
+    G_UNLOCK(astal_wp_profile_catalog);
+    return self;
+}
+
+void astal_wp_profile_set_unref(AstalWpProfileSet *self) {
+    // the count is changed under the lock so a concurrent intern can not revive a dying set
+    G_LOCK(astal_wp_profile_catalog);
+    gboolean last = --self->ref_count == 0;
+    if (last) g_hash_table_remove(astal_wp_profile_catalog, self->key);
+    G_UNLOCK(astal_wp_profile_catalog);
+    if (!last) return;
+
+    g_ptr_array_unref(self->profiles);
+    g_variant_unref(self->key);
+    g_free(self);
+}
+
+guint astal_wp_profile_set_get_size(AstalWpProfileSet *self) { return self->profiles->len; }
+
+AstalWpProfile *astal_wp_profile_set_get(AstalWpProfileSet *self, guint position) {
+    return self->profiles->pdata[position];
+}
+
+// the position of the profile with @index, or -1
+gint astal_wp_profile_set_find(AstalWpProfileSet *self, gint index) {
+    // the sets are short and usually enumerated by index
+    if (index >= 0 && (guint)index < self->profiles->len) {
+        AstalWpProfile *profile = self->profiles->pdata[index];
+        if (profile->index == index) return index;
+    }
+    for (guint i = 0; i < self->profiles->len; i++) {
+        AstalWpProfile *profile = self->profiles->pdata[i];
+        if (profile->index == index) return i;
+    }
+    return -1;
+}
+
+AstalWpProfile *astal_wp_profile_set_lookup(AstalWpProfileSet *self, gint index) {
+    gint position = astal_wp_profile_set_find(self, index);
+    return position >= 0 ? self->profiles->pdata[position] : NULL;
+}
+
+// the profiles of the set as a GList, the profiles are owned by the set
+GList *astal_wp_profile_set_list(AstalWpProfileSet *self) {
+    GList *list = NULL;
+    for (guint i = self->profiles->len; i > 0; i--)
+        list = g_list_prepend(list, self->profiles->pdata[i - 1]);
+    return list;
+}
@@ -0,0 +1,288 @@
+#include <pipewire/extensions/profiler.h>
+#include <pipewire/pipewire.h>
+#include <spa/param/profiler.h>
+#include <spa/pod/parser.h>
+#include <wp/wp.h>
+
+#include "profiler-private.h"
+#include "profiler.h"
+
+G_DEFINE_BOXED_TYPE(AstalWpDriverStats, astal_wp_driver_stats, astal_wp_driver_stats_copy,
+                    astal_wp_driver_stats_free);
+
+AstalWpDriverStats *astal_wp_driver_stats_copy(const AstalWpDriverStats *self) {
+    AstalWpDriverStats *copy = g_new(AstalWpDriverStats, 1);
+    *copy = *self;
+    return copy;
+}
+
+void astal_wp_driver_stats_free(AstalWpDriverStats *self) { g_free(self); }
+
+typedef struct {
+    // the most recent cycle
+    AstalWpDriverStats current;
+    // the highest dsp load seen since the last flush
+    gdouble peak_load;
+    gboolean dirty;
+
+    // one sample per flush interval, oldest sample at (head - len)
+    AstalWpDriverStats history[ASTAL_WP_PROFILER_HISTORY_SIZE];
+    guint head;
+    guint len;
+} AstalWpDriverHistory;
+
+struct _AstalWpProfiler {
+    struct pw_registry *registry;
+    struct spa_hook registry_listener;
+
+    struct pw_proxy *profiler;
+    struct spa_hook profiler_listener;
+    guint32 profiler_id;
+
+    GHashTable *drivers;
+    GSource *timeout;
+
+    AstalWpProfilerFunc func;
+    gpointer user_data;
+};
+
+static void astal_wp_profiler_process(AstalWpProfiler *self, const struct spa_pod_object *object) {
+    struct spa_pod_prop *prop;
+
+    int64_t counter = 0;
+    float cpu_load_fast = 0, cpu_load_medium = 0, cpu_load_slow = 0;
+    int32_t info_xruns = 0;
+
+    int32_t clock_flags = 0, clock_id = -1;
+    char *clock_name = NULL;
+    int64_t clock_nsec = 0, position = 0, duration = 0, delay = 0;
+    struct spa_fraction rate = {0, 0};
+
+    int32_t driver_id = -1, status = 0, driver_xruns = -1;
+    char *driver_name = NULL;
+    int64_t prev_signal = 0, signal = 0, awake = 0, finish = 0;
+    struct spa_fraction latency = {0, 0};
+
+    gboolean have_clock = FALSE, have_driver = FALSE;
+
+    SPA_POD_OBJECT_FOREACH(object, prop) {
+        switch (prop->key) {
+            case SPA_PROFILER_info:
+                spa_pod_parse_struct(&prop->value, SPA_POD_Long(&counter),
+                                     SPA_POD_Float(&cpu_load_fast), SPA_POD_Float(&cpu_load_medium),
+                                     SPA_POD_Float(&cpu_load_slow), SPA_POD_Int(&info_xruns));
+                break;
+            case SPA_PROFILER_clock:
+                have_clock =
+                    spa_pod_parse_struct(&prop->value, SPA_POD_Int(&clock_flags),
+                                         SPA_POD_Int(&clock_id), SPA_POD_String(&clock_name),
+                                         SPA_POD_Long(&clock_nsec), SPA_POD_Fraction(&rate),
+                                         SPA_POD_Long(&position), SPA_POD_Long(&duration),
+                                         SPA_POD_Long(&delay)) >= 0;
+                break;
+            case SPA_PROFILER_driverBlock:
+                // the per driver xrun counter only exists in newer PipeWire versions
+                have_driver =
+                    spa_pod_parse_struct(&prop->value, SPA_POD_Int(&driver_id),
+                                         SPA_POD_String(&driver_name), SPA_POD_Long(&prev_signal),
+                                         SPA_POD_Long(&signal), SPA_POD_Long(&awake),
+                                         SPA_POD_Long(&finish), SPA_POD_Int(&status),
+                                         SPA_POD_Fraction(&latency),
+                                         SPA_POD_OPT_Int(&driver_xruns)) >= 0;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (!have_clock || !have_driver) return;
+
+    guint id = driver_id >= 0 ? (guint)driver_id : (guint)clock_id;
+    AstalWpDriverHistory *history = g_hash_table_lookup(self->drivers, GUINT_TO_POINTER(id));
+    if (history == NULL) {
+        history = g_new0(AstalWpDriverHistory, 1);
+        g_hash_table_insert(self->drivers, GUINT_TO_POINTER(id), history);
+    }
+
+    gdouble period = rate.denom != 0
+                         ? (gdouble)duration * SPA_NSEC_PER_SEC * rate.num / rate.denom
+                         : 0;
+
+    AstalWpDriverStats *stats = &history->current;
+    stats->id = id;
+    stats->timestamp = g_get_monotonic_time();
+    stats->quantum = duration;
+    stats->rate = rate.num != 0 ? rate.denom / rate.num : 0;
+    stats->dsp_load = period > 0 ? (finish - signal) / period : 0;
+    stats->cpu_load = cpu_load_fast;
+    stats->xruns = driver_xruns >= 0 ? driver_xruns : info_xruns;
+
+    if (stats->dsp_load > history->peak_load) history->peak_load = stats->dsp_load;
+    history->dirty = TRUE;
+}
+
+static void astal_wp_profiler_profile(void *data, const struct spa_pod *pod) {
+    AstalWpProfiler *self = data;
+    struct spa_pod *object;
+
+    // every object is one cycle of one driver, a single event can carry many of them
+    SPA_POD_STRUCT_FOREACH(pod, object) {
+        if (!spa_pod_is_object_type(object, SPA_TYPE_OBJECT_Profiler)) continue;
+        astal_wp_profiler_process(self, (const struct spa_pod_object *)object);
+    }
+}
+
+static const struct pw_profiler_events astal_wp_profiler_events = {
+    PW_VERSION_PROFILER_EVENTS,
+    .profile = astal_wp_profiler_profile,
+};
+
+static void astal_wp_profiler_unbind(AstalWpProfiler *self) {
+    if (self->profiler == NULL) return;
+    spa_hook_remove(&self->profiler_listener);
+    pw_proxy_destroy(self->profiler);
+    self->profiler = NULL;
+}
+
+static void astal_wp_profiler_registry_global(void *data, uint32_t id, uint32_t permissions,
+                                              const char *type, uint32_t version,
+                                              const struct spa_dict *props) {
+    AstalWpProfiler *self = data;
+
+    if (self->profiler != NULL || g_strcmp0(type, PW_TYPE_INTERFACE_Profiler) != 0) return;
+
+    self->profiler = pw_registry_bind(self->registry, id, type, PW_VERSION_PROFILER, 0);
+    if (self->profiler == NULL) return;
+    self->profiler_id = id;
+    pw_proxy_add_object_listener(self->profiler, &self->profiler_listener,
+                                 &astal_wp_profiler_events, self);
+}
+
+static void astal_wp_profiler_registry_global_remove(void *data, uint32_t id) {
+    AstalWpProfiler *self = data;
+    if (self->profiler != NULL && self->profiler_id == id) astal_wp_profiler_unbind(self);
+}
+
+static const struct pw_registry_events astal_wp_profiler_registry_events = {
+    PW_VERSION_REGISTRY_EVENTS,
+    .global = astal_wp_profiler_registry_global,
+    .global_remove = astal_wp_profiler_registry_global_remove,
+};
+
+static gboolean astal_wp_profiler_flush(AstalWpProfiler *self) {
+    gint64 now = g_get_monotonic_time();
+    GArray *samples = g_array_new(FALSE, FALSE, sizeof(AstalWpDriverStats));
+
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&iter, self->drivers);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        AstalWpDriverHistory *history = value;
+
+        if (!history->dirty) {
+            // the driver went idle or was removed
+            if (now - history->current.timestamp > 5 * G_USEC_PER_SEC)
+                g_hash_table_iter_remove(&iter);
+            continue;
+        }
+
+        AstalWpDriverStats sample = history->current;
+        sample.dsp_load = history->peak_load;
+
+        history->history[history->head] = sample;
+        history->head = (history->head + 1) % ASTAL_WP_PROFILER_HISTORY_SIZE;
+        if (history->len < ASTAL_WP_PROFILER_HISTORY_SIZE) history->len++;
+
+        history->dirty = FALSE;
+        history->peak_load = 0;
+
+        g_array_append_val(samples, sample);
+    }
+
+    // the callback may free this profiler, so it must not be touched afterwards
+    if (samples->len > 0 && self->func != NULL)
+        self->func((const AstalWpDriverStats *)samples->data, samples->len, self->user_data);
+
+    g_array_unref(samples);
+    return G_SOURCE_CONTINUE;
+}
+
+gboolean astal_wp_profiler_get_stats(AstalWpProfiler *self, guint driver_id,
+                                     AstalWpDriverStats *stats) {
+    AstalWpDriverHistory *history =
+        g_hash_table_lookup(self->drivers, GUINT_TO_POINTER(driver_id));
+    if (history == NULL) return FALSE;
+
+    *stats = history->current;
+    return TRUE;
+}
+
+AstalWpDriverStats *astal_wp_profiler_get_history(AstalWpProfiler *self, guint driver_id,
+                                                  guint *n_samples) {
+    AstalWpDriverHistory *history =
+        g_hash_table_lookup(self->drivers, GUINT_TO_POINTER(driver_id));
+    *n_samples = 0;
+    if (history == NULL || history->len == 0) return NULL;
+
+    AstalWpDriverStats *samples = g_new(AstalWpDriverStats, history->len);
+    guint start = (history->head + ASTAL_WP_PROFILER_HISTORY_SIZE - history->len) %
+                  ASTAL_WP_PROFILER_HISTORY_SIZE;
+
+    for (guint i = 0; i < history->len; i++) {
+        samples[i] = history->history[(start + i) % ASTAL_WP_PROFILER_HISTORY_SIZE];
+    }
+
+    *n_samples = history->len;
+    return samples;
+}
+
+guint *astal_wp_profiler_get_drivers(AstalWpProfiler *self, guint *n_drivers) {
+    guint *drivers = g_new(guint, g_hash_table_size(self->drivers) + 1);
+    guint n = 0;
+
+    GHashTableIter iter;
+    gpointer key;
+
+    g_hash_table_iter_init(&iter, self->drivers);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) drivers[n++] = GPOINTER_TO_UINT(key);
+
+    *n_drivers = n;
+    return drivers;
+}
+
+AstalWpProfiler *astal_wp_profiler_new(WpCore *core, AstalWpProfilerFunc func,
+                                       gpointer user_data) {
+    struct pw_core *pw_core = wp_core_get_pw_core(core);
+    if (pw_core == NULL) return NULL;
+
+    AstalWpProfiler *self = g_new0(AstalWpProfiler, 1);
+    self->func = func;
+    self->user_data = user_data;
+    self->drivers = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+    // WirePlumber has no proxy type for the profiler, so bind it through the registry directly
+    self->registry = pw_core_get_registry(pw_core, PW_VERSION_REGISTRY, 0);
+    pw_registry_add_listener(self->registry, &self->registry_listener,
+                             &astal_wp_profiler_registry_events, self);
+
+    // flushed in the context of the core, which is not necessarily the global default one
+    self->timeout = g_timeout_source_new(ASTAL_WP_PROFILER_INTERVAL_MS);
+    g_source_set_callback(self->timeout, (GSourceFunc)astal_wp_profiler_flush, self, NULL);
+    g_source_attach(self->timeout, wp_core_get_g_main_context(core));
+
+    return self;
+}
+
+void astal_wp_profiler_free(AstalWpProfiler *self) {
+    if (self == NULL) return;
+
+    astal_wp_profiler_unbind(self);
+    spa_hook_remove(&self->registry_listener);
+    pw_proxy_destroy((struct pw_proxy *)self->registry);
+
+    g_source_destroy(self->timeout);
+    g_source_unref(self->timeout);
+    g_hash_table_destroy(self->drivers);
+    g_free(self);
+}
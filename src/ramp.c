@@ -0,0 +1,171 @@
+#include "endpoint-private.h"
+#include "ramp-private.h"
+#include "wp-private.h"
+
+// Volume ramps of all endpoints of an instance are advanced by one shared timer which only runs
+// while a ramp is in progress. Ramps are keyed by node id, so ramping a default endpoint replaces
+// a ramp of the endpoint it currently represents and the other way round.
+
+typedef struct {
+    AstalWpEndpoint *endpoint;
+    gdouble from;
+    gdouble to;
+    gint64 start;
+    gint64 duration;
+    AstalWpRampCurve curve;
+    gdouble last;
+} AstalWpRamp;
+
+struct _AstalWpRamps {
+    AstalWpWp *wp;
+    // node id -> AstalWpRamp
+    GHashTable *ramps;
+    guint timer_id;
+};
+
+static gdouble astal_wp_ramp_curve(AstalWpRampCurve curve, gdouble t) {
+    switch (curve) {
+        case ASTAL_WP_RAMP_CURVE_EASE_IN:
+            return t * t;
+        case ASTAL_WP_RAMP_CURVE_EASE_OUT:
+            return 1 - (1 - t) * (1 - t);
+        case ASTAL_WP_RAMP_CURVE_EASE_IN_OUT:
+            return t * t * (3 - 2 * t);
+        case ASTAL_WP_RAMP_CURVE_LINEAR:
+        default:
+            return t;
+    }
+}
+
+// advances the ramp to now, returns TRUE once it is finished. changed is set when volume has to
+// be written, which is not the case when the step would not change the volume of the endpoint
+static gboolean astal_wp_ramp_step(AstalWpRamp *ramp, gint64 now, gdouble *volume,
+                                   gboolean *changed) {
+    gdouble t = ramp->duration > 0 ? (gdouble)(now - ramp->start) / ramp->duration : 1;
+    if (t < 0) t = 0;
+    gboolean finished = t >= 1;
+
+    gdouble target = finished ? ramp->to
+                              : ramp->from + (ramp->to - ramp->from) *
+                                                 astal_wp_ramp_curve(ramp->curve, t);
+    gdouble current = astal_wp_endpoint_get_volume(ramp->endpoint);
+
+    // steps too small to be audible are skipped, the last one is written unless the endpoint
+    // already reports a volume that close to it
+    *volume = target;
+    *changed = ABS(target - current) >= 1e-4 && (finished || ABS(target - ramp->last) >= 1e-4);
+    if (*changed) ramp->last = target;
+    return finished;
+}
+
+typedef struct {
+    AstalWpEndpoint *endpoint;
+    gdouble volume;
+} AstalWpRampWrite;
+
+static gboolean astal_wp_ramps_tick(AstalWpRamps *self) {
+    gint64 now = g_get_monotonic_time();
+    GArray *writes = g_array_sized_new(FALSE, FALSE, sizeof(AstalWpRampWrite),
+                                       g_hash_table_size(self->ramps));
+
+    // every ramp is advanced first and the volumes of the tick are written in one pass afterwards,
+    // a write may cause a handler to start or cancel ramps while the table is walked otherwise
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, self->ramps);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        AstalWpRamp *ramp = value;
+        AstalWpRampWrite write = {ramp->endpoint, 0};
+        gboolean changed;
+        gboolean finished = astal_wp_ramp_step(ramp, now, &write.volume, &changed);
+        if (changed) {
+            g_object_ref(write.endpoint);
+            g_array_append_val(writes, write);
+        }
+        if (finished) g_hash_table_iter_remove(&iter);
+    }
+
+    for (guint i = 0; i < writes->len; i++) {
+        AstalWpRampWrite *write = &g_array_index(writes, AstalWpRampWrite, i);
+        astal_wp_endpoint_write_volume(write->endpoint, write->volume);
+        g_object_unref(write->endpoint);
+    }
+    g_array_free(writes, TRUE);
+
+    if (g_hash_table_size(self->ramps) > 0) return G_SOURCE_CONTINUE;
+    self->timer_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+AstalWpRamps *astal_wp_ramps_new(AstalWpWp *wp) {
+    AstalWpRamps *self = g_new0(AstalWpRamps, 1);
+    self->wp = wp;
+    self->ramps = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    return self;
+}
+
+void astal_wp_ramps_free(AstalWpRamps *self) {
+    if (self == NULL) return;
+
+    astal_wp_wp_clear_source(self->wp, &self->timer_id);
+    g_hash_table_destroy(self->ramps);
+    g_free(self);
+}
+
+void astal_wp_ramp_start(AstalWpEndpoint *endpoint, gdouble volume, gint64 start,
+                         guint duration_ms, AstalWpRampCurve curve) {
+    AstalWpWp *wp = astal_wp_endpoint_get_wp(endpoint);
+    AstalWpRamps *self = wp != NULL ? astal_wp_wp_get_ramps(wp) : NULL;
+
+    volume = astal_wp_endpoint_clamp_volume(endpoint, volume);
+
+    // not bound to an instance yet, there is nothing to ramp
+    if (self == NULL) {
+        astal_wp_endpoint_write_volume(endpoint, volume);
+        return;
+    }
+
+    astal_wp_ramp_cancel(endpoint);
+
+    AstalWpRamp *ramp = g_new0(AstalWpRamp, 1);
+    ramp->endpoint = endpoint;
+    ramp->from = astal_wp_endpoint_get_volume(endpoint);
+    ramp->to = volume;
+    ramp->start = start;
+    ramp->duration = (gint64)duration_ms * 1000;
+    ramp->curve = curve;
+    ramp->last = ramp->from;
+
+    gdouble step;
+    gboolean changed;
+    gboolean finished = astal_wp_ramp_step(ramp, g_get_monotonic_time(), &step, &changed);
+    if (changed) astal_wp_endpoint_write_volume(endpoint, step);
+    if (finished) {
+        g_free(ramp);
+        return;
+    }
+
+    g_hash_table_replace(self->ramps, GUINT_TO_POINTER(astal_wp_endpoint_get_id(endpoint)), ramp);
+
+    if (self->timer_id == 0)
+        self->timer_id = astal_wp_wp_timeout_add(wp, ASTAL_WP_RAMP_INTERVAL_MS,
+                                                 (GSourceFunc)astal_wp_ramps_tick, self);
+}
+
+// cancels the ramp of the node of endpoint and any ramp still writing to endpoint, the id of a
+// default endpoint may have changed since its ramp started
+void astal_wp_ramp_cancel(AstalWpEndpoint *endpoint) {
+    AstalWpWp *wp = astal_wp_endpoint_get_wp(endpoint);
+    AstalWpRamps *self = wp != NULL ? astal_wp_wp_get_ramps(wp) : NULL;
+    if (self == NULL) return;
+
+    gpointer id = GUINT_TO_POINTER(astal_wp_endpoint_get_id(endpoint));
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&iter, self->ramps);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        AstalWpRamp *ramp = value;
+        if (key == id || ramp->endpoint == endpoint) g_hash_table_iter_remove(&iter);
+    }
+}
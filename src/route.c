@@ -0,0 +1,365 @@
+#include "route.h"
+
+#include <wp/wp.h>
+
+#include "route-private.h"
+
+struct _AstalWpRoute {
+    GObject parent_instance;
+
+    gint index;
+    gchar *name;
+    gchar *description;
+    AstalWpDirection direction;
+    guint priority;
+    AstalWpAvailability available;
+    gint device;
+    gboolean hardware_volume;
+};
+
+typedef struct {
+    // the card device this route applies to in each profile, parallel arrays of gint
+    GArray *profiles;
+    GArray *devices;
+} AstalWpRoutePrivate;
+
+G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpRoute, astal_wp_route, G_TYPE_OBJECT);
+
+G_DEFINE_ENUM_TYPE(AstalWpAvailability, astal_wp_availability,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_AVAILABILITY_UNKNOWN, "unknown"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_AVAILABILITY_NO, "no"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_AVAILABILITY_YES, "yes"));
+
+typedef enum {
+    ASTAL_WP_ROUTE_PROP_INDEX = 1,
+    ASTAL_WP_ROUTE_PROP_NAME,
+    ASTAL_WP_ROUTE_PROP_DESCRIPTION,
+    ASTAL_WP_ROUTE_PROP_DIRECTION,
+    ASTAL_WP_ROUTE_PROP_PRIORITY,
+    ASTAL_WP_ROUTE_PROP_AVAILABLE,
+    ASTAL_WP_ROUTE_PROP_ACTIVE,
+    ASTAL_WP_ROUTE_PROP_DEVICE,
+    ASTAL_WP_ROUTE_PROP_HARDWARE_VOLUME,
+    ASTAL_WP_ROUTE_N_PROPERTIES,
+} AstalWpRouteProperties;
+
+static GParamSpec *astal_wp_route_properties[ASTAL_WP_ROUTE_N_PROPERTIES] = {
+    NULL,
+};
+
+/**
+ * astal_wp_route_get_index
+ * @self: the AstalWpRoute object
+ *
+ * gets the index of this route on its device
+ *
+ */
+gint astal_wp_route_get_index(AstalWpRoute *self) { return self->index; }
+
+/**
+ * astal_wp_route_get_name
+ * @self: the AstalWpRoute object
+ *
+ * gets the name of this route, for example analog-output-headphones
+ *
+ */
+const gchar *astal_wp_route_get_name(AstalWpRoute *self) { return self->name; }
+
+/**
+ * astal_wp_route_get_description
+ * @self: the AstalWpRoute object
+ *
+ * gets the description of this route
+ *
+ */
+const gchar *astal_wp_route_get_description(AstalWpRoute *self) { return self->description; }
+
+/**
+ * astal_wp_route_get_direction
+ * @self: the AstalWpRoute object
+ *
+ * gets the direction of this route, output routes lead to speakers or headphones
+ *
+ */
+AstalWpDirection astal_wp_route_get_direction(AstalWpRoute *self) { return self->direction; }
+
+/**
+ * astal_wp_route_get_priority
+ * @self: the AstalWpRoute object
+ *
+ * gets the priority of this route, routes with a higher priority are preferred
+ *
+ */
+guint astal_wp_route_get_priority(AstalWpRoute *self) { return self->priority; }
+
+/**
+ * astal_wp_route_get_available
+ * @self: the AstalWpRoute object
+ *
+ * gets whether something is plugged into this route
+ *
+ */
+AstalWpAvailability astal_wp_route_get_available(AstalWpRoute *self) { return self->available; }
+
+/**
+ * astal_wp_route_get_active
+ * @self: the AstalWpRoute object
+ *
+ * gets whether this route is the active route of one of the card devices
+ *
+ */
+gboolean astal_wp_route_get_active(AstalWpRoute *self) { return self->device >= 0; }
+
+/**
+ * astal_wp_route_get_device
+ * @self: the AstalWpRoute object
+ *
+ * gets the card device this route is active on, or -1 when it is not active
+ *
+ */
+gint astal_wp_route_get_device(AstalWpRoute *self) { return self->device; }
+
+/**
+ * astal_wp_route_get_hardware_volume
+ * @self: the AstalWpRoute object
+ *
+ * gets whether the volume of this route is applied by the device itself instead of being mixed
+ * in software. Only known for active routes.
+ *
+ */
+gboolean astal_wp_route_get_hardware_volume(AstalWpRoute *self) { return self->hardware_volume; }
+
+// updates the fields reported by EnumRoute, only properties which changed are notified, returns
+// whether any did
+gboolean astal_wp_route_update(AstalWpRoute *self, const gchar *name, const gchar *description,
+                               AstalWpDirection direction, guint priority,
+                               AstalWpAvailability available) {
+    gboolean changed = FALSE;
+    g_object_freeze_notify(G_OBJECT(self));
+
+    if (g_strcmp0(self->name, name) != 0) {
+        changed = TRUE;
+        g_free(self->name);
+        self->name = g_strdup(name);
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_NAME]);
+    }
+    if (g_strcmp0(self->description, description) != 0) {
+        changed = TRUE;
+        g_free(self->description);
+        self->description = g_strdup(description);
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_DESCRIPTION]);
+    }
+    if (self->direction != direction) {
+        changed = TRUE;
+        self->direction = direction;
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_DIRECTION]);
+    }
+    if (self->priority != priority) {
+        changed = TRUE;
+        self->priority = priority;
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_PRIORITY]);
+    }
+    if (self->available != available) {
+        changed = TRUE;
+        self->available = available;
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_AVAILABLE]);
+    }
+
+    g_object_thaw_notify(G_OBJECT(self));
+    return changed;
+}
+
+// takes ownership of both arrays
+void astal_wp_route_set_devices(AstalWpRoute *self, GArray *profiles, GArray *devices) {
+    AstalWpRoutePrivate *priv = astal_wp_route_get_instance_private(self);
+
+    if (priv->profiles != NULL) g_array_unref(priv->profiles);
+    if (priv->devices != NULL) g_array_unref(priv->devices);
+    priv->profiles = profiles;
+    priv->devices = devices;
+}
+
+// the card device this route applies to in the given profile, -1 if it is not part of it
+gint astal_wp_route_find_device(AstalWpRoute *self, gint profile) {
+    AstalWpRoutePrivate *priv = astal_wp_route_get_instance_private(self);
+    if (priv->profiles == NULL || priv->devices == NULL) return -1;
+
+    for (guint i = 0; i < priv->profiles->len && i < priv->devices->len; i++) {
+        if (g_array_index(priv->profiles, gint, i) == profile)
+            return g_array_index(priv->devices, gint, i);
+    }
+    return -1;
+}
+
+// updates the fields reported by Route, a device of -1 marks the route inactive, returns whether
+// anything changed
+gboolean astal_wp_route_set_active(AstalWpRoute *self, gint device, gboolean hardware_volume) {
+    gboolean changed = FALSE;
+    g_object_freeze_notify(G_OBJECT(self));
+
+    if (self->device != device) {
+        gboolean was_active = self->device >= 0;
+        changed = TRUE;
+        self->device = device;
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_DEVICE]);
+        if (was_active != (device >= 0))
+            g_object_notify_by_pspec(G_OBJECT(self),
+                                     astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_ACTIVE]);
+    }
+    if (self->hardware_volume != hardware_volume) {
+        changed = TRUE;
+        self->hardware_volume = hardware_volume;
+        g_object_notify_by_pspec(G_OBJECT(self),
+                                 astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_HARDWARE_VOLUME]);
+    }
+
+    g_object_thaw_notify(G_OBJECT(self));
+    return changed;
+}
+
+AstalWpRoute *astal_wp_route_new(gint index) {
+    AstalWpRoute *self = g_object_new(ASTAL_WP_TYPE_ROUTE, NULL);
+    self->index = index;
+    return self;
+}
+
+static void astal_wp_route_get_property(GObject *object, guint property_id, GValue *value,
+                                        GParamSpec *pspec) {
+    AstalWpRoute *self = ASTAL_WP_ROUTE(object);
+
+    switch (property_id) {
+        case ASTAL_WP_ROUTE_PROP_INDEX:
+            g_value_set_int(value, self->index);
+            break;
+        case ASTAL_WP_ROUTE_PROP_NAME:
+            g_value_set_string(value, self->name);
+            break;
+        case ASTAL_WP_ROUTE_PROP_DESCRIPTION:
+            g_value_set_string(value, self->description);
+            break;
+        case ASTAL_WP_ROUTE_PROP_DIRECTION:
+            g_value_set_enum(value, self->direction);
+            break;
+        case ASTAL_WP_ROUTE_PROP_PRIORITY:
+            g_value_set_uint(value, self->priority);
+            break;
+        case ASTAL_WP_ROUTE_PROP_AVAILABLE:
+            g_value_set_enum(value, self->available);
+            break;
+        case ASTAL_WP_ROUTE_PROP_ACTIVE:
+            g_value_set_boolean(value, astal_wp_route_get_active(self));
+            break;
+        case ASTAL_WP_ROUTE_PROP_DEVICE:
+            g_value_set_int(value, self->device);
+            break;
+        case ASTAL_WP_ROUTE_PROP_HARDWARE_VOLUME:
+            g_value_set_boolean(value, self->hardware_volume);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+static void astal_wp_route_init(AstalWpRoute *self) {
+    AstalWpRoutePrivate *priv = astal_wp_route_get_instance_private(self);
+    priv->profiles = NULL;
+    priv->devices = NULL;
+
+    self->name = NULL;
+    self->description = NULL;
+    self->available = ASTAL_WP_AVAILABILITY_UNKNOWN;
+    self->device = -1;
+}
+
+static void astal_wp_route_finalize(GObject *object) {
+    AstalWpRoute *self = ASTAL_WP_ROUTE(object);
+    AstalWpRoutePrivate *priv = astal_wp_route_get_instance_private(self);
+
+    if (priv->profiles != NULL) g_array_unref(priv->profiles);
+    if (priv->devices != NULL) g_array_unref(priv->devices);
+    g_free(self->name);
+    g_free(self->description);
+}
+
+static void astal_wp_route_class_init(AstalWpRouteClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->finalize = astal_wp_route_finalize;
+    object_class->get_property = astal_wp_route_get_property;
+
+    /**
+     * AstalWpRoute:index
+     *
+     * The index of this route on its device.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_INDEX] =
+        g_param_spec_int("index", "index", "index", G_MININT, G_MAXINT, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:name
+     *
+     * The name of this route.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_NAME] =
+        g_param_spec_string("name", "name", "name", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:description
+     *
+     * The description of this route.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_DESCRIPTION] =
+        g_param_spec_string("description", "description", "description", NULL, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:direction: (type AstalWpDirection)
+     *
+     * The direction of this route.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_DIRECTION] =
+        g_param_spec_enum("direction", "direction", "direction", ASTAL_WP_TYPE_DIRECTION,
+                          ASTAL_WP_DIRECTION_INPUT, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:priority
+     *
+     * The priority of this route.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_PRIORITY] =
+        g_param_spec_uint("priority", "priority", "priority", 0, G_MAXUINT, 0, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:available: (type AstalWpAvailability)
+     *
+     * Whether something is plugged into this route.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_AVAILABLE] =
+        g_param_spec_enum("available", "available", "available", ASTAL_WP_TYPE_AVAILABILITY,
+                          ASTAL_WP_AVAILABILITY_UNKNOWN, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:active
+     *
+     * Whether this route is the active route of one of the card devices.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_ACTIVE] =
+        g_param_spec_boolean("active", "active", "active", FALSE, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:device
+     *
+     * The card device this route is active on, or -1.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_DEVICE] =
+        g_param_spec_int("device", "device", "device", -1, G_MAXINT, -1, G_PARAM_READABLE);
+    /**
+     * AstalWpRoute:hardware-volume
+     *
+     * Whether the volume of this route is applied by the device itself.
+     */
+    astal_wp_route_properties[ASTAL_WP_ROUTE_PROP_HARDWARE_VOLUME] =
+        g_param_spec_boolean("hardware-volume", "hardware-volume", "hardware-volume", FALSE,
+                             G_PARAM_READABLE);
+
+    g_object_class_install_properties(object_class, ASTAL_WP_ROUTE_N_PROPERTIES,
+                                      astal_wp_route_properties);
+}
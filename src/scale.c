@@ -0,0 +1,137 @@
+#include <math.h>
+#include <string.h>
+
+#include "scale-private.h"
+
+G_DEFINE_ENUM_TYPE(AstalWpScale, astal_wp_scale,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_SCALE_LINEAR, "linear"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_SCALE_CUBIC, "cubic"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_SCALE_DECIBEL, "decibel"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_SCALE_CUSTOM, "custom"));
+
+// The mixer always reports linear volumes, every other scale is computed from them here. The
+// array variants are plain loops over contiguous memory so the compiler can vectorize them.
+
+// the cubic volume of 1.5, the loudest volume the library writes by default
+#define ASTAL_WP_SCALE_DECIBEL_MAX 10.566
+
+gdouble astal_wp_scale_clamp(AstalWpScale scale, gdouble volume) {
+    if (scale == ASTAL_WP_SCALE_DECIBEL)
+        return CLAMP(volume, ASTAL_WP_SCALE_DECIBEL_MIN, ASTAL_WP_SCALE_DECIBEL_MAX);
+    return CLAMP(volume, 0, 1.5);
+}
+
+static inline gdouble astal_wp_scale_linear_to_decibel(gdouble volume) {
+    if (volume <= 0) return ASTAL_WP_SCALE_DECIBEL_MIN;
+    return MAX(20 * log10(volume), ASTAL_WP_SCALE_DECIBEL_MIN);
+}
+
+static inline gdouble astal_wp_scale_decibel_to_linear(gdouble volume) {
+    if (volume <= ASTAL_WP_SCALE_DECIBEL_MIN) return 0;
+    return pow(10, volume / 20);
+}
+
+gdouble astal_wp_scale_convert(AstalWpScale scale, AstalWpScaleFunc func, gpointer data,
+                               gdouble volume, gboolean to_linear) {
+    switch (scale) {
+        case ASTAL_WP_SCALE_CUBIC:
+            return to_linear ? volume * volume * volume : cbrt(volume);
+        case ASTAL_WP_SCALE_DECIBEL:
+            return to_linear ? astal_wp_scale_decibel_to_linear(volume)
+                             : astal_wp_scale_linear_to_decibel(volume);
+        case ASTAL_WP_SCALE_CUSTOM:
+            if (func != NULL) return func(volume, to_linear, data);
+            return volume;
+        case ASTAL_WP_SCALE_LINEAR:
+        default:
+            return volume;
+    }
+}
+
+void astal_wp_scale_convert_array(AstalWpScale scale, AstalWpScaleFunc func, gpointer data,
+                                  const gdouble *volumes, gdouble *out, guint n_volumes,
+                                  gboolean to_linear) {
+    switch (scale) {
+        case ASTAL_WP_SCALE_CUBIC:
+            if (to_linear) {
+                for (guint i = 0; i < n_volumes; i++) out[i] = volumes[i] * volumes[i] * volumes[i];
+            } else {
+                for (guint i = 0; i < n_volumes; i++) out[i] = cbrt(volumes[i]);
+            }
+            break;
+        case ASTAL_WP_SCALE_DECIBEL:
+            if (to_linear) {
+                for (guint i = 0; i < n_volumes; i++)
+                    out[i] = astal_wp_scale_decibel_to_linear(volumes[i]);
+            } else {
+                for (guint i = 0; i < n_volumes; i++)
+                    out[i] = astal_wp_scale_linear_to_decibel(volumes[i]);
+            }
+            break;
+        case ASTAL_WP_SCALE_CUSTOM:
+            if (func != NULL) {
+                for (guint i = 0; i < n_volumes; i++) out[i] = func(volumes[i], to_linear, data);
+                break;
+            }
+            // fallthrough
+        case ASTAL_WP_SCALE_LINEAR:
+        default:
+            if (out != volumes) memcpy(out, volumes, n_volumes * sizeof(gdouble));
+            break;
+    }
+}
+
+/**
+ * astal_wp_scale_from_linear:
+ * @scale: the scale to convert to
+ * @volume: a linear volume
+ *
+ * Converts a linear volume as reported by PipeWire to @scale. Custom scales are not known outside
+ * of the object they were set on and leave the volume unchanged.
+ *
+ * Returns: the volume in @scale
+ */
+gdouble astal_wp_scale_from_linear(AstalWpScale scale, gdouble volume) {
+    return astal_wp_scale_convert(scale, NULL, NULL, volume, FALSE);
+}
+
+/**
+ * astal_wp_scale_to_linear:
+ * @scale: the scale of @volume
+ * @volume: a volume in @scale
+ *
+ * Converts a volume in @scale to the linear volume PipeWire applies.
+ *
+ * Returns: the linear volume
+ */
+gdouble astal_wp_scale_to_linear(AstalWpScale scale, gdouble volume) {
+    return astal_wp_scale_convert(scale, NULL, NULL, volume, TRUE);
+}
+
+/**
+ * astal_wp_scale_from_linear_array:
+ * @scale: the scale to convert to
+ * @volumes: (array length=n_volumes): linear volumes
+ * @out: (out caller-allocates) (array length=n_volumes): the converted volumes, may be @volumes
+ * @n_volumes: the number of volumes
+ *
+ * Converts every volume of @volumes like astal_wp_scale_from_linear.
+ */
+void astal_wp_scale_from_linear_array(AstalWpScale scale, const gdouble *volumes, gdouble *out,
+                                      guint n_volumes) {
+    astal_wp_scale_convert_array(scale, NULL, NULL, volumes, out, n_volumes, FALSE);
+}
+
+/**
+ * astal_wp_scale_to_linear_array:
+ * @scale: the scale of @volumes
+ * @volumes: (array length=n_volumes): volumes in @scale
+ * @out: (out caller-allocates) (array length=n_volumes): the linear volumes, may be @volumes
+ * @n_volumes: the number of volumes
+ *
+ * Converts every volume of @volumes like astal_wp_scale_to_linear.
+ */
+void astal_wp_scale_to_linear_array(AstalWpScale scale, const gdouble *volumes, gdouble *out,
+                                    guint n_volumes) {
+    astal_wp_scale_convert_array(scale, NULL, NULL, volumes, out, n_volumes, TRUE);
+}
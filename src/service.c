@@ -0,0 +1,516 @@
+#include <gio/gio.h>
+
+#include "device-private.h"
+#include "endpoint-private.h"
+#include "service-private.h"
+#include "wp-private.h"
+#include "wp.h"
+
+// volumes are linear, each process converts them to its own scale
+static const gchar astal_wp_service_xml[] =
+    "<node>"
+    "  <interface name='" ASTAL_WP_DBUS_INTERFACE "'>"
+    "    <method name='GetState'>"
+    "      <arg type='a{sv}' name='defaults' direction='out'/>"
+    "      <arg type='aa{sv}' name='endpoints' direction='out'/>"
+    "      <arg type='aa{sv}' name='devices' direction='out'/>"
+    "    </method>"
+    "    <method name='SetVolume'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "      <arg type='d' name='volume' direction='in'/>"
+    "    </method>"
+    "    <method name='SetChannelVolumes'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "      <arg type='ad' name='volumes' direction='in'/>"
+    "    </method>"
+    "    <method name='SetMute'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "      <arg type='b' name='mute' direction='in'/>"
+    "    </method>"
+    "    <method name='SetDefault'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "    </method>"
+    "    <method name='SetTarget'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "      <arg type='u' name='target' direction='in'/>"
+    "    </method>"
+    "    <method name='SetTargets'>"
+    "      <arg type='au' name='ids' direction='in'/>"
+    "      <arg type='u' name='target' direction='in'/>"
+    "    </method>"
+    "    <method name='SetProfile'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "      <arg type='i' name='profile' direction='in'/>"
+    "    </method>"
+    "    <method name='SetRoute'>"
+    "      <arg type='u' name='id' direction='in'/>"
+    "      <arg type='i' name='route' direction='in'/>"
+    "    </method>"
+    "    <signal name='EndpointAdded'>"
+    "      <arg type='a{sv}' name='endpoint'/>"
+    "    </signal>"
+    "    <signal name='EndpointRemoved'>"
+    "      <arg type='u' name='id'/>"
+    "    </signal>"
+    "    <signal name='DeviceAdded'>"
+    "      <arg type='a{sv}' name='device'/>"
+    "    </signal>"
+    "    <signal name='DeviceRemoved'>"
+    "      <arg type='u' name='id'/>"
+    "    </signal>"
+    "    <property name='DefaultSpeaker' type='u' access='read'/>"
+    "    <property name='DefaultMicrophone' type='u' access='read'/>"
+    "  </interface>"
+    "  <interface name='" ASTAL_WP_DBUS_ENDPOINT_INTERFACE "'>"
+    "    <property name='Id' type='u' access='read'/>"
+    "    <property name='MediaClass' type='u' access='read'/>"
+    "    <property name='Description' type='s' access='read'/>"
+    "    <property name='Name' type='s' access='read'/>"
+    "    <property name='Icon' type='s' access='read'/>"
+    "    <property name='Volume' type='d' access='read'/>"
+    "    <property name='Mute' type='b' access='read'/>"
+    "    <property name='IsDefault' type='b' access='read'/>"
+    "    <property name='Target' type='u' access='read'/>"
+    "    <property name='ChannelMap' type='as' access='read'/>"
+    "    <property name='ChannelVolumes' type='ad' access='read'/>"
+    "    <property name='DeviceId' type='u' access='read'/>"
+    "  </interface>"
+    "  <interface name='" ASTAL_WP_DBUS_DEVICE_INTERFACE "'>"
+    "    <property name='Id' type='u' access='read'/>"
+    "    <property name='DeviceType' type='u' access='read'/>"
+    "    <property name='Description' type='s' access='read'/>"
+    "    <property name='Icon' type='s' access='read'/>"
+    "    <property name='ActiveProfile' type='i' access='read'/>"
+    "    <property name='Profiles' type='a(issiua(su))' access='read'/>"
+    "    <property name='Routes' type='a(issuuuib)' access='read'/>"
+    "  </interface>"
+    "</node>";
+
+typedef struct {
+    GObject *object;
+    const gchar *interface;
+    guint registration_id;
+    // D-Bus property names changed since the last flush, static strings
+    GHashTable *dirty;
+} AstalWpServiceObject;
+
+struct _AstalWpService {
+    AstalWpWp *wp;
+
+    GDBusNodeInfo *info;
+    GDBusConnection *connection;
+    guint owner_id;
+
+    // object path -> AstalWpServiceObject, including the root object
+    GHashTable *objects;
+    // object paths with pending PropertiesChanged
+    GHashTable *dirty;
+    guint flush_id;
+};
+
+static void astal_wp_service_object_free(AstalWpServiceObject *object) {
+    g_hash_table_destroy(object->dirty);
+    g_free(object);
+}
+
+static GVariant *astal_wp_service_serialize(AstalWpService *self, GObject *object) {
+    if (ASTAL_WP_IS_ENDPOINT(object)) return astal_wp_endpoint_serialize(ASTAL_WP_ENDPOINT(object));
+    if (ASTAL_WP_IS_DEVICE(object)) return astal_wp_device_serialize(ASTAL_WP_DEVICE(object));
+
+    GVariantBuilder b = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+    g_variant_builder_add(
+        &b, "{sv}", "DefaultSpeaker",
+        g_variant_new_uint32(astal_wp_endpoint_get_id(astal_wp_wp_get_default_speaker(self->wp))));
+    g_variant_builder_add(&b, "{sv}", "DefaultMicrophone",
+                          g_variant_new_uint32(astal_wp_endpoint_get_id(
+                              astal_wp_wp_get_default_microphone(self->wp))));
+    return g_variant_builder_end(&b);
+}
+
+// maps a GObject property to the D-Bus property it is exported as
+static const gchar *astal_wp_service_property_name(GObject *object, const gchar *name) {
+    if (g_strcmp0(name, "id") == 0) return "Id";
+    if (g_strcmp0(name, "description") == 0) return "Description";
+    if (g_strcmp0(name, "icon") == 0) return "Icon";
+
+    if (ASTAL_WP_IS_ENDPOINT(object)) {
+        if (g_strcmp0(name, "media-class") == 0) return "MediaClass";
+        if (g_strcmp0(name, "name") == 0) return "Name";
+        if (g_strcmp0(name, "volume") == 0) return "Volume";
+        if (g_strcmp0(name, "mute") == 0) return "Mute";
+        if (g_strcmp0(name, "is-default") == 0) return "IsDefault";
+        if (g_strcmp0(name, "target") == 0) return "Target";
+        if (g_strcmp0(name, "channel-map") == 0) return "ChannelMap";
+        if (g_strcmp0(name, "channel-volumes") == 0) return "ChannelVolumes";
+        if (g_strcmp0(name, "device") == 0) return "DeviceId";
+    } else if (ASTAL_WP_IS_DEVICE(object)) {
+        if (g_strcmp0(name, "device-type") == 0) return "DeviceType";
+        if (g_strcmp0(name, "active-profile-id") == 0) return "ActiveProfile";
+        if (g_strcmp0(name, "profiles") == 0) return "Profiles";
+        if (g_strcmp0(name, "routes") == 0) return "Routes";
+    }
+    return NULL;
+}
+
+static gboolean astal_wp_service_flush(AstalWpService *self) {
+    GHashTableIter iter;
+    gpointer key;
+
+    g_hash_table_iter_init(&iter, self->dirty);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        AstalWpServiceObject *object = g_hash_table_lookup(self->objects, key);
+        if (object == NULL) continue;
+
+        g_autoptr(GVariant) state =
+            g_variant_ref_sink(astal_wp_service_serialize(self, object->object));
+        GVariantBuilder changed = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE_VARDICT);
+
+        GHashTableIter props;
+        gpointer prop;
+
+        g_hash_table_iter_init(&props, object->dirty);
+        while (g_hash_table_iter_next(&props, &prop, NULL)) {
+            GVariant *value = g_variant_lookup_value(state, prop, NULL);
+            if (value == NULL) continue;
+            g_variant_builder_add(&changed, "{sv}", prop, value);
+            g_variant_unref(value);
+        }
+        g_hash_table_remove_all(object->dirty);
+
+        g_dbus_connection_emit_signal(self->connection, NULL, key,
+                                      "org.freedesktop.DBus.Properties", "PropertiesChanged",
+                                      g_variant_new("(sa{sv}as)", object->interface, &changed,
+                                                    NULL),
+                                      NULL);
+    }
+
+    g_hash_table_remove_all(self->dirty);
+    self->flush_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void astal_wp_service_mark_dirty(AstalWpService *self, const gchar *path,
+                                        const gchar *property) {
+    AstalWpServiceObject *object = g_hash_table_lookup(self->objects, path);
+    if (object == NULL) return;
+
+    g_hash_table_add(object->dirty, (gpointer)property);
+    g_hash_table_add(self->dirty, g_strdup(path));
+
+    // every change made during one main loop iteration is sent as one PropertiesChanged signal
+    if (self->flush_id == 0)
+        self->flush_id = astal_wp_wp_idle_add(self->wp, G_PRIORITY_DEFAULT_IDLE,
+                                              (GSourceFunc)astal_wp_service_flush, self);
+}
+
+static gchar *astal_wp_service_object_path(GObject *object) {
+    if (ASTAL_WP_IS_ENDPOINT(object))
+        return g_strdup_printf(ASTAL_WP_DBUS_ENDPOINT_PATH "%u",
+                               astal_wp_endpoint_get_id(ASTAL_WP_ENDPOINT(object)));
+    if (ASTAL_WP_IS_DEVICE(object))
+        return g_strdup_printf(ASTAL_WP_DBUS_DEVICE_PATH "%u",
+                               astal_wp_device_get_id(ASTAL_WP_DEVICE(object)));
+    return g_strdup(ASTAL_WP_DBUS_PATH);
+}
+
+static void astal_wp_service_notify(GObject *object, GParamSpec *pspec, AstalWpService *self) {
+    const gchar *property = astal_wp_service_property_name(object, pspec->name);
+    if (property == NULL) return;
+
+    g_autofree gchar *path = astal_wp_service_object_path(object);
+    astal_wp_service_mark_dirty(self, path, property);
+}
+
+static void astal_wp_service_default_changed(AstalWpService *self) {
+    astal_wp_service_mark_dirty(self, ASTAL_WP_DBUS_PATH, "DefaultSpeaker");
+    astal_wp_service_mark_dirty(self, ASTAL_WP_DBUS_PATH, "DefaultMicrophone");
+}
+
+static GVariant *astal_wp_service_get_property(GDBusConnection *connection, const gchar *sender,
+                                               const gchar *path, const gchar *interface,
+                                               const gchar *property, GError **error,
+                                               AstalWpService *self) {
+    AstalWpServiceObject *object = g_hash_table_lookup(self->objects, path);
+    if (object == NULL) return NULL;
+
+    g_autoptr(GVariant) state =
+        g_variant_ref_sink(astal_wp_service_serialize(self, object->object));
+    return g_variant_lookup_value(state, property, NULL);
+}
+
+static GVariant *astal_wp_service_get_state(AstalWpService *self) {
+    GVariantBuilder endpoints = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("aa{sv}"));
+    GVariantBuilder devices = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("aa{sv}"));
+
+    GList *list = astal_wp_wp_peek_endpoints(self->wp);
+    for (GList *l = list; l != NULL; l = l->next) {
+        g_variant_builder_add_value(&endpoints, astal_wp_endpoint_serialize(l->data));
+    }
+    g_list_free(list);
+
+    list = astal_wp_wp_get_devices(self->wp);
+    for (GList *l = list; l != NULL; l = l->next) {
+        g_variant_builder_add_value(&devices, astal_wp_device_serialize(l->data));
+    }
+    g_list_free(list);
+
+    return g_variant_new("(@a{sv}aa{sv}aa{sv})",
+                         astal_wp_service_serialize(self, G_OBJECT(self->wp)), &endpoints,
+                         &devices);
+}
+
+// runs a setter method of the service interface on the objects of wp
+gboolean astal_wp_service_run_command(AstalWpWp *wp, const gchar *method, GVariant *params,
+                                      GError **error) {
+    if (g_strcmp0(method, "SetTargets") == 0) {
+        g_autoptr(GVariantIter) ids = NULL;
+        guint id, target;
+        g_variant_get(params, "(auu)", &ids, &target);
+
+        GList *streams = NULL;
+        while (g_variant_iter_next(ids, "u", &id)) {
+            AstalWpEndpoint *endpoint = astal_wp_wp_get_endpoint(wp, id);
+            if (endpoint != NULL) streams = g_list_prepend(streams, endpoint);
+        }
+        streams = g_list_reverse(streams);
+
+        astal_wp_wp_move_streams(wp, streams,
+                                 target != 0 ? astal_wp_wp_get_endpoint(wp, target) : NULL);
+        g_list_free(streams);
+        return TRUE;
+    }
+
+    guint id;
+    g_variant_get_child(params, 0, "u", &id);
+
+    if (g_strcmp0(method, "SetProfile") == 0) {
+        gint profile;
+        g_variant_get(params, "(ui)", NULL, &profile);
+
+        AstalWpDevice *device = astal_wp_wp_get_device(wp, id);
+        if (device != NULL) astal_wp_device_set_active_profile(device, profile);
+        return TRUE;
+    }
+
+    if (g_strcmp0(method, "SetRoute") == 0) {
+        gint index;
+        g_variant_get(params, "(ui)", NULL, &index);
+
+        AstalWpDevice *device = astal_wp_wp_get_device(wp, id);
+        AstalWpRoute *route = device != NULL ? astal_wp_device_get_route(device, index) : NULL;
+        if (route == NULL) {
+            g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                        "no route %d on device %u", index, id);
+            return FALSE;
+        }
+        astal_wp_device_set_active_route(device, route);
+        return TRUE;
+    }
+
+    AstalWpEndpoint *endpoint = astal_wp_wp_get_endpoint(wp, id);
+    if (endpoint == NULL) {
+        g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS, "no endpoint with id %u", id);
+        return FALSE;
+    }
+
+    if (g_strcmp0(method, "SetVolume") == 0) {
+        gdouble volume;
+        g_variant_get(params, "(ud)", NULL, &volume);
+        astal_wp_endpoint_set_linear_volume(endpoint, volume);
+    } else if (g_strcmp0(method, "SetChannelVolumes") == 0) {
+        g_autoptr(GVariant) volumes = g_variant_get_child_value(params, 1);
+        gsize n;
+        const gdouble *v = g_variant_get_fixed_array(volumes, &n, sizeof(gdouble));
+        if (n != astal_wp_endpoint_get_n_channels(endpoint)) {
+            g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+                        "endpoint %u has %u channels", id,
+                        astal_wp_endpoint_get_n_channels(endpoint));
+            return FALSE;
+        }
+        astal_wp_endpoint_set_linear_channel_volumes(endpoint, v, n);
+    } else if (g_strcmp0(method, "SetMute") == 0) {
+        gboolean mute;
+        g_variant_get(params, "(ub)", NULL, &mute);
+        astal_wp_endpoint_set_mute(endpoint, mute);
+    } else if (g_strcmp0(method, "SetDefault") == 0) {
+        astal_wp_endpoint_set_is_default(endpoint, TRUE);
+    } else if (g_strcmp0(method, "SetTarget") == 0) {
+        guint target;
+        g_variant_get(params, "(uu)", NULL, &target);
+        astal_wp_endpoint_set_target(endpoint,
+                                     target != 0 ? astal_wp_wp_get_endpoint(wp, target) : NULL);
+    }
+    return TRUE;
+}
+
+static void astal_wp_service_method_call(GDBusConnection *connection, const gchar *sender,
+                                         const gchar *path, const gchar *interface,
+                                         const gchar *method, GVariant *params,
+                                         GDBusMethodInvocation *invocation,
+                                         AstalWpService *self) {
+    if (g_strcmp0(method, "GetState") == 0) {
+        g_dbus_method_invocation_return_value(invocation, astal_wp_service_get_state(self));
+        return;
+    }
+
+    GError *error = NULL;
+    if (astal_wp_service_run_command(self->wp, method, params, &error))
+        g_dbus_method_invocation_return_value(invocation, NULL);
+    else
+        g_dbus_method_invocation_take_error(invocation, error);
+}
+
+static const GDBusInterfaceVTable astal_wp_service_vtable = {
+    .method_call = (GDBusInterfaceMethodCallFunc)astal_wp_service_method_call,
+    .get_property = (GDBusInterfaceGetPropertyFunc)astal_wp_service_get_property,
+};
+
+static void astal_wp_service_register(AstalWpService *self, GObject *object) {
+    if (self->connection == NULL) return;
+
+    gchar *path = astal_wp_service_object_path(object);
+    GDBusInterfaceInfo *info = self->info->interfaces[0];
+    if (ASTAL_WP_IS_ENDPOINT(object))
+        info = self->info->interfaces[1];
+    else if (ASTAL_WP_IS_DEVICE(object))
+        info = self->info->interfaces[2];
+
+    GError *error = NULL;
+    guint id = g_dbus_connection_register_object(self->connection, path, info,
+                                                 &astal_wp_service_vtable, self, NULL, &error);
+    if (error != NULL) {
+        g_warning("could not export %s: %s", path, error->message);
+        g_error_free(error);
+        g_free(path);
+        return;
+    }
+
+    AstalWpServiceObject *entry = g_new0(AstalWpServiceObject, 1);
+    entry->object = object;
+    entry->interface = info->name;
+    entry->registration_id = id;
+    entry->dirty = g_hash_table_new(g_str_hash, g_str_equal);
+    g_hash_table_insert(self->objects, path, entry);
+
+    if (object != G_OBJECT(self->wp))
+        g_signal_connect(object, "notify", G_CALLBACK(astal_wp_service_notify), self);
+}
+
+static void astal_wp_service_unregister(AstalWpService *self, GObject *object) {
+    g_autofree gchar *path = astal_wp_service_object_path(object);
+    AstalWpServiceObject *entry = g_hash_table_lookup(self->objects, path);
+    if (entry == NULL) return;
+
+    if (object != G_OBJECT(self->wp)) g_signal_handlers_disconnect_by_data(object, self);
+    g_dbus_connection_unregister_object(self->connection, entry->registration_id);
+    g_hash_table_remove(self->dirty, path);
+    g_hash_table_remove(self->objects, path);
+}
+
+static void astal_wp_service_emit(AstalWpService *self, const gchar *signal, GVariant *params) {
+    if (self->connection == NULL) return;
+    g_dbus_connection_emit_signal(self->connection, NULL, ASTAL_WP_DBUS_PATH,
+                                  ASTAL_WP_DBUS_INTERFACE, signal, params, NULL);
+}
+
+static void astal_wp_service_endpoint_added(AstalWpService *self, AstalWpEndpoint *endpoint) {
+    astal_wp_service_register(self, G_OBJECT(endpoint));
+    astal_wp_service_emit(self, "EndpointAdded",
+                          g_variant_new("(@a{sv})", astal_wp_endpoint_serialize(endpoint)));
+}
+
+static void astal_wp_service_endpoint_removed(AstalWpService *self, AstalWpEndpoint *endpoint) {
+    astal_wp_service_unregister(self, G_OBJECT(endpoint));
+    astal_wp_service_emit(self, "EndpointRemoved",
+                          g_variant_new("(u)", astal_wp_endpoint_get_id(endpoint)));
+}
+
+static void astal_wp_service_device_added(AstalWpService *self, AstalWpDevice *device) {
+    astal_wp_service_register(self, G_OBJECT(device));
+    astal_wp_service_emit(self, "DeviceAdded",
+                          g_variant_new("(@a{sv})", astal_wp_device_serialize(device)));
+}
+
+static void astal_wp_service_device_removed(AstalWpService *self, AstalWpDevice *device) {
+    astal_wp_service_unregister(self, G_OBJECT(device));
+    astal_wp_service_emit(self, "DeviceRemoved",
+                          g_variant_new("(u)", astal_wp_device_get_id(device)));
+}
+
+static void astal_wp_service_bus_acquired(GDBusConnection *connection, const gchar *name,
+                                          AstalWpService *self) {
+    self->connection = g_object_ref(connection);
+
+    astal_wp_service_register(self, G_OBJECT(self->wp));
+
+    GList *list = astal_wp_wp_peek_endpoints(self->wp);
+    for (GList *l = list; l != NULL; l = l->next) astal_wp_service_register(self, l->data);
+    g_list_free(list);
+
+    list = astal_wp_wp_get_devices(self->wp);
+    for (GList *l = list; l != NULL; l = l->next) astal_wp_service_register(self, l->data);
+    g_list_free(list);
+
+    g_signal_connect_swapped(self->wp, "endpoint-added",
+                             G_CALLBACK(astal_wp_service_endpoint_added), self);
+    g_signal_connect_swapped(self->wp, "endpoint-removed",
+                             G_CALLBACK(astal_wp_service_endpoint_removed), self);
+    g_signal_connect_swapped(self->wp, "device-added", G_CALLBACK(astal_wp_service_device_added),
+                             self);
+    g_signal_connect_swapped(self->wp, "device-removed",
+                             G_CALLBACK(astal_wp_service_device_removed), self);
+    g_signal_connect_swapped(astal_wp_wp_get_default_speaker(self->wp), "notify::id",
+                             G_CALLBACK(astal_wp_service_default_changed), self);
+    g_signal_connect_swapped(astal_wp_wp_get_default_microphone(self->wp), "notify::id",
+                             G_CALLBACK(astal_wp_service_default_changed), self);
+
+    astal_wp_wp_sync_lazy_streams(self->wp);
+}
+
+static void astal_wp_service_name_lost(GDBusConnection *connection, const gchar *name,
+                                       AstalWpService *self) {
+    g_warning("could not own %s, is another service running?", name);
+}
+
+AstalWpService *astal_wp_service_new(AstalWpWp *wp) {
+    AstalWpService *self = g_new0(AstalWpService, 1);
+    self->wp = wp;
+    self->info = g_dbus_node_info_new_for_xml(astal_wp_service_xml, NULL);
+    self->objects = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                          (GDestroyNotify)astal_wp_service_object_free);
+    self->dirty = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    self->owner_id = g_bus_own_name(G_BUS_TYPE_SESSION, ASTAL_WP_DBUS_NAME,
+                                    G_BUS_NAME_OWNER_FLAGS_NONE,
+                                    (GBusAcquiredCallback)astal_wp_service_bus_acquired, NULL,
+                                    (GBusNameLostCallback)astal_wp_service_name_lost, self, NULL);
+    return self;
+}
+
+void astal_wp_service_free(AstalWpService *self) {
+    if (self == NULL) return;
+
+    g_bus_unown_name(self->owner_id);
+    astal_wp_wp_clear_source(self->wp, &self->flush_id);
+
+    g_signal_handlers_disconnect_by_data(self->wp, self);
+    g_signal_handlers_disconnect_by_data(astal_wp_wp_get_default_speaker(self->wp), self);
+    g_signal_handlers_disconnect_by_data(astal_wp_wp_get_default_microphone(self->wp), self);
+
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&iter, self->objects);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        AstalWpServiceObject *entry = value;
+        if (entry->object != G_OBJECT(self->wp))
+            g_signal_handlers_disconnect_by_data(entry->object, self);
+        g_dbus_connection_unregister_object(self->connection, entry->registration_id);
+    }
+
+    g_hash_table_destroy(self->objects);
+    g_hash_table_destroy(self->dirty);
+    g_clear_object(&self->connection);
+    g_dbus_node_info_unref(self->info);
+    g_free(self);
+}
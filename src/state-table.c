@@ -0,0 +1,175 @@
+#include <errno.h>
+#include <sys/file.h>
+
+#include "endpoint.h"
+#include "state-table-private.h"
+#include "state-table.h"
+#include "wp-private.h"
+#include "wp.h"
+
+// Publishes the endpoint state into the file described in astal/wireplumber/state-table.h.
+// Changes are coalesced and the whole table is rewritten once per main loop iteration, readers
+// retry while the sequence is odd or changed during their copy.
+
+struct _AstalWpStateTableWriter {
+    AstalWpWp *wp;
+
+    gchar *path;
+    gint fd;
+    AstalWpStateTable *table;
+
+    guint flush_id;
+};
+
+static gboolean astal_wp_state_table_writer_flush(AstalWpStateTableWriter *self) {
+    AstalWpStateTable *table = self->table;
+    self->flush_id = 0;
+
+    __atomic_store_n(&table->sequence, table->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    guint32 flags = ASTAL_WP_STATE_TABLE_ALIVE;
+    guint32 n = 0;
+
+    GList *list = astal_wp_wp_peek_endpoints(self->wp);
+    for (GList *l = list; l != NULL; l = l->next) {
+        if (n == ASTAL_WP_STATE_TABLE_MAX_ENTRIES) {
+            flags |= ASTAL_WP_STATE_TABLE_TRUNCATED;
+            break;
+        }
+
+        AstalWpEndpoint *endpoint = l->data;
+        AstalWpStateEntry *entry = &table->entries[n++];
+        entry->id = astal_wp_endpoint_get_id(endpoint);
+        entry->media_class = astal_wp_endpoint_get_media_class(endpoint);
+        entry->volume = astal_wp_endpoint_get_volume_in_scale(endpoint, ASTAL_WP_SCALE_LINEAR);
+        entry->mute = astal_wp_endpoint_get_mute(endpoint);
+        entry->reserved = 0;
+    }
+    g_list_free(list);
+
+    table->n_entries = n;
+    table->default_speaker = astal_wp_endpoint_get_id(astal_wp_wp_get_default_speaker(self->wp));
+    table->default_microphone =
+        astal_wp_endpoint_get_id(astal_wp_wp_get_default_microphone(self->wp));
+    table->flags = flags;
+
+    __atomic_store_n(&table->sequence, table->sequence + 1, __ATOMIC_RELEASE);
+    return G_SOURCE_REMOVE;
+}
+
+static void astal_wp_state_table_writer_queue(AstalWpStateTableWriter *self) {
+    if (self->flush_id == 0)
+        self->flush_id = astal_wp_wp_idle_add(self->wp, G_PRIORITY_DEFAULT_IDLE,
+                                              (GSourceFunc)astal_wp_state_table_writer_flush,
+                                              self);
+}
+
+static void astal_wp_state_table_writer_watch(AstalWpStateTableWriter *self,
+                                              AstalWpEndpoint *endpoint) {
+    g_signal_connect_swapped(endpoint, "notify::volume",
+                             G_CALLBACK(astal_wp_state_table_writer_queue), self);
+    g_signal_connect_swapped(endpoint, "notify::mute",
+                             G_CALLBACK(astal_wp_state_table_writer_queue), self);
+    g_signal_connect_swapped(endpoint, "notify::media-class",
+                             G_CALLBACK(astal_wp_state_table_writer_queue), self);
+}
+
+static void astal_wp_state_table_writer_endpoint_added(AstalWpStateTableWriter *self,
+                                                       AstalWpEndpoint *endpoint) {
+    astal_wp_state_table_writer_watch(self, endpoint);
+    astal_wp_state_table_writer_queue(self);
+}
+
+static void astal_wp_state_table_writer_endpoint_removed(AstalWpStateTableWriter *self,
+                                                         AstalWpEndpoint *endpoint) {
+    g_signal_handlers_disconnect_by_data(endpoint, self);
+    astal_wp_state_table_writer_queue(self);
+}
+
+AstalWpStateTableWriter *astal_wp_state_table_writer_new(AstalWpWp *wp) {
+    g_autofree gchar *path =
+        g_build_filename(g_get_user_runtime_dir(), ASTAL_WP_STATE_TABLE_FILE, NULL);
+
+    gint fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        g_warning("could not open %s: %s", path, g_strerror(errno));
+        return NULL;
+    }
+
+    // the lock is held for as long as the table is published, there can only be one writer
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        g_warning("could not lock %s, is another process publishing its state?", path);
+        close(fd);
+        return NULL;
+    }
+
+    if (ftruncate(fd, sizeof(AstalWpStateTable)) < 0) {
+        g_warning("could not resize %s: %s", path, g_strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    AstalWpStateTable *table =
+        mmap(NULL, sizeof(AstalWpStateTable), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (table == MAP_FAILED) {
+        g_warning("could not map %s: %s", path, g_strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    memset(table, 0, sizeof(AstalWpStateTable));
+    table->magic = ASTAL_WP_STATE_TABLE_MAGIC;
+    table->version = ASTAL_WP_STATE_TABLE_VERSION;
+
+    AstalWpStateTableWriter *self = g_new0(AstalWpStateTableWriter, 1);
+    self->wp = wp;
+    self->path = g_steal_pointer(&path);
+    self->fd = fd;
+    self->table = table;
+
+    GList *list = astal_wp_wp_peek_endpoints(wp);
+    for (GList *l = list; l != NULL; l = l->next) astal_wp_state_table_writer_watch(self, l->data);
+    g_list_free(list);
+
+    g_signal_connect_swapped(wp, "endpoint-added",
+                             G_CALLBACK(astal_wp_state_table_writer_endpoint_added), self);
+    g_signal_connect_swapped(wp, "endpoint-removed",
+                             G_CALLBACK(astal_wp_state_table_writer_endpoint_removed), self);
+    g_signal_connect_swapped(astal_wp_wp_get_default_speaker(wp), "notify::id",
+                             G_CALLBACK(astal_wp_state_table_writer_queue), self);
+    g_signal_connect_swapped(astal_wp_wp_get_default_microphone(wp), "notify::id",
+                             G_CALLBACK(astal_wp_state_table_writer_queue), self);
+
+    astal_wp_wp_sync_lazy_streams(wp);
+    astal_wp_state_table_writer_flush(self);
+    return self;
+}
+
+void astal_wp_state_table_writer_free(AstalWpStateTableWriter *self) {
+    if (self == NULL) return;
+
+    astal_wp_wp_clear_source(self->wp, &self->flush_id);
+
+    g_signal_handlers_disconnect_by_data(self->wp, self);
+    g_signal_handlers_disconnect_by_data(astal_wp_wp_get_default_speaker(self->wp), self);
+    g_signal_handlers_disconnect_by_data(astal_wp_wp_get_default_microphone(self->wp), self);
+
+    GList *list = astal_wp_wp_peek_endpoints(self->wp);
+    for (GList *l = list; l != NULL; l = l->next)
+        g_signal_handlers_disconnect_by_data(l->data, self);
+    g_list_free(list);
+
+    // readers which still have the table mapped see that it is no longer updated
+    AstalWpStateTable *table = self->table;
+    __atomic_store_n(&table->sequence, table->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    table->flags &= ~ASTAL_WP_STATE_TABLE_ALIVE;
+    __atomic_store_n(&table->sequence, table->sequence + 1, __ATOMIC_RELEASE);
+
+    unlink(self->path);
+    munmap(table, sizeof(AstalWpStateTable));
+    close(self->fd);
+    g_free(self->path);
+    g_free(self);
+}
@@ -4,6 +4,8 @@
 
 #include "device.h"
 #include "endpoint.h"
+#include "video-private.h"
+#include "wp-private.h"
 #include "wp.h"
 
 struct _AstalWpVideo {
@@ -135,7 +137,7 @@ AstalWpDevice *astal_wp_video_get_device(AstalWpVideo *self, guint id) {
  */
 GList *astal_wp_video_get_sources(AstalWpVideo *self) {
     AstalWpVideoPrivate *priv = astal_wp_video_get_instance_private(self);
-    GList *eps = astal_wp_wp_get_endpoints(priv->wp);
+    GList *eps = astal_wp_wp_peek_endpoints(priv->wp);
     GList *list = NULL;
 
     for (GList *l = eps; l != NULL; l = l->next) {
@@ -156,7 +158,7 @@ GList *astal_wp_video_get_sources(AstalWpVideo *self) {
  */
 GList *astal_wp_video_get_sinks(AstalWpVideo *self) {
     AstalWpVideoPrivate *priv = astal_wp_video_get_instance_private(self);
-    GList *eps = astal_wp_wp_get_endpoints(priv->wp);
+    GList *eps = astal_wp_wp_peek_endpoints(priv->wp);
     GList *list = NULL;
 
     for (GList *l = eps; l != NULL; l = l->next) {
@@ -257,82 +259,98 @@ static void astal_wp_video_get_property(GObject *object, guint property_id, GVal
     }
 }
 
-void astal_wp_video_device_added(AstalWpVideo *self, gpointer object) {
-    AstalWpDevice *device = ASTAL_WP_DEVICE(object);
+// collection notifies are held back while the instance is in a batch
+static void astal_wp_video_notify_collection(AstalWpVideo *self, const gchar *property) {
+    AstalWpVideoPrivate *priv = astal_wp_video_get_instance_private(self);
+    astal_wp_wp_notify_collection(priv->wp, G_OBJECT(self), property);
+}
+
+void astal_wp_video_device_added(AstalWpVideo *self, AstalWpDevice *device) {
     if (astal_wp_device_get_device_type(device) == ASTAL_WP_DEVICE_TYPE_VIDEO) {
         g_signal_emit_by_name(self, "device-added", device);
-        g_object_notify(G_OBJECT(self), "devices");
+        astal_wp_video_notify_collection(self, "devices");
     }
 }
 
-static void astal_wp_video_device_removed(AstalWpVideo *self, gpointer object) {
-    AstalWpDevice *device = ASTAL_WP_DEVICE(object);
+void astal_wp_video_device_removed(AstalWpVideo *self, AstalWpDevice *device) {
     if (astal_wp_device_get_device_type(device) == ASTAL_WP_DEVICE_TYPE_VIDEO) {
         g_signal_emit_by_name(self, "device-removed", device);
-        g_object_notify(G_OBJECT(self), "devices");
+        astal_wp_video_notify_collection(self, "devices");
     }
 }
 
-static void astal_wp_video_object_added(AstalWpVideo *self, gpointer object) {
-    AstalWpEndpoint *endpoint = ASTAL_WP_ENDPOINT(object);
+void astal_wp_video_endpoint_added(AstalWpVideo *self, AstalWpEndpoint *endpoint) {
     switch (astal_wp_endpoint_get_media_class(endpoint)) {
         case ASTAL_WP_MEDIA_CLASS_VIDEO_SOURCE:
             g_signal_emit_by_name(self, "source-added", endpoint);
-            g_object_notify(G_OBJECT(self), "sources");
+            astal_wp_video_notify_collection(self, "sources");
             break;
         case ASTAL_WP_MEDIA_CLASS_VIDEO_SINK:
             g_signal_emit_by_name(self, "sink-added", endpoint);
-            g_object_notify(G_OBJECT(self), "sinks");
+            astal_wp_video_notify_collection(self, "sinks");
             break;
         case ASTAL_WP_MEDIA_CLASS_VIDEO_STREAM:
             g_signal_emit_by_name(self, "stream-added", endpoint);
-            g_object_notify(G_OBJECT(self), "streams");
+            astal_wp_video_notify_collection(self, "streams");
             break;
         case ASTAL_WP_MEDIA_CLASS_VIDEO_RECORDER:
             g_signal_emit_by_name(self, "recorder-added", endpoint);
-            g_object_notify(G_OBJECT(self), "recorders");
+            astal_wp_video_notify_collection(self, "recorders");
             break;
         default:
             break;
     }
 }
 
-static void astal_wp_video_object_removed(AstalWpAudio *self, gpointer object) {
-    AstalWpEndpoint *endpoint = ASTAL_WP_ENDPOINT(object);
+void astal_wp_video_endpoint_removed(AstalWpVideo *self, AstalWpEndpoint *endpoint) {
     switch (astal_wp_endpoint_get_media_class(endpoint)) {
         case ASTAL_WP_MEDIA_CLASS_VIDEO_SOURCE:
             g_signal_emit_by_name(self, "source-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "sources");
+            astal_wp_video_notify_collection(self, "sources");
             break;
         case ASTAL_WP_MEDIA_CLASS_VIDEO_SINK:
             g_signal_emit_by_name(self, "sink-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "sinks");
+            astal_wp_video_notify_collection(self, "sinks");
             break;
         case ASTAL_WP_MEDIA_CLASS_VIDEO_STREAM:
             g_signal_emit_by_name(self, "stream-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "streams");
+            astal_wp_video_notify_collection(self, "streams");
             break;
         case ASTAL_WP_MEDIA_CLASS_VIDEO_RECORDER:
             g_signal_emit_by_name(self, "recorder-removed", endpoint);
-            g_object_notify(G_OBJECT(self), "recorders");
+            astal_wp_video_notify_collection(self, "recorders");
             break;
         default:
             break;
     }
 }
 
+// whether anyone listens for streams or recorders being added or removed, or for the streams
+// and recorders properties to change
+gboolean astal_wp_video_has_stream_handlers(AstalWpVideo *self) {
+    static const guint signals[] = {
+        ASTAL_WP_VIDEO_SIGNAL_STREAM_ADDED,
+        ASTAL_WP_VIDEO_SIGNAL_STREAM_REMOVED,
+        ASTAL_WP_VIDEO_SIGNAL_RECORDER_ADDED,
+        ASTAL_WP_VIDEO_SIGNAL_RECORDER_REMOVED,
+    };
+
+    for (guint i = 0; i < G_N_ELEMENTS(signals); i++) {
+        if (g_signal_has_handler_pending(self, astal_wp_video_signals[signals[i]], 0, FALSE))
+            return TRUE;
+    }
+
+    guint notify = g_signal_lookup("notify", G_TYPE_OBJECT);
+    return g_signal_has_handler_pending(self, notify, g_quark_from_static_string("streams"),
+                                        FALSE) ||
+           g_signal_has_handler_pending(self, notify, g_quark_from_static_string("recorders"),
+                                        FALSE);
+}
+
 AstalWpVideo *astal_wp_video_new(AstalWpWp *wp) {
     AstalWpVideo *self = g_object_new(ASTAL_WP_TYPE_VIDEO, NULL);
     AstalWpVideoPrivate *priv = astal_wp_video_get_instance_private(self);
     priv->wp = g_object_ref(wp);
-    g_signal_connect_swapped(priv->wp, "endpoint-added", G_CALLBACK(astal_wp_video_object_added),
-                             self);
-    g_signal_connect_swapped(priv->wp, "endpoint-removed",
-                             G_CALLBACK(astal_wp_video_object_removed), self);
-    g_signal_connect_swapped(priv->wp, "device-added", G_CALLBACK(astal_wp_video_device_added),
-                             self);
-    g_signal_connect_swapped(priv->wp, "device-removed", G_CALLBACK(astal_wp_video_device_removed),
-                             self);
 
     return self;
 }
@@ -0,0 +1,83 @@
+#include <stdlib.h>
+
+#include "watchdog-private.h"
+#include "watchdog.h"
+
+G_DEFINE_BOXED_TYPE(AstalWpStall, astal_wp_stall, astal_wp_stall_copy, astal_wp_stall_free);
+
+AstalWpStall *astal_wp_stall_copy(const AstalWpStall *self) {
+    AstalWpStall *copy = g_new(AstalWpStall, 1);
+    *copy = *self;
+    return copy;
+}
+
+void astal_wp_stall_free(AstalWpStall *self) { g_free(self); }
+
+// Times the synchronous calls an instance makes on its own thread. Only the longest stalls are
+// kept, a new one replaces the shortest kept one once the table is full.
+struct _AstalWpWatchdog {
+    gint64 threshold;
+
+    AstalWpStall stalls[ASTAL_WP_WATCHDOG_SIZE];
+    guint n_stalls;
+};
+
+AstalWpWatchdog *astal_wp_watchdog_new(void) {
+    AstalWpWatchdog *self = g_new0(AstalWpWatchdog, 1);
+    self->threshold = ASTAL_WP_WATCHDOG_THRESHOLD_MS * 1000;
+    return self;
+}
+
+void astal_wp_watchdog_free(AstalWpWatchdog *self) { g_free(self); }
+
+guint astal_wp_watchdog_get_threshold(AstalWpWatchdog *self) { return self->threshold / 1000; }
+
+void astal_wp_watchdog_set_threshold(AstalWpWatchdog *self, guint threshold_ms) {
+    self->threshold = (gint64)threshold_ms * 1000;
+}
+
+void astal_wp_watchdog_report(AstalWpWatchdog *self, const gchar *call, const gchar *location,
+                              const gchar *function, guint id, gint64 start) {
+    gint64 duration = g_get_monotonic_time() - start;
+    if (self->threshold == 0 || duration < self->threshold) return;
+
+    AstalWpStall stall = {
+        .call = call,
+        .location = location,
+        .function = function,
+        .id = id,
+        .timestamp = start,
+        .duration = duration / 1000.0,
+    };
+
+    g_warning("%s: %s for %u in %s blocked for %.1f ms", location, call, id, function,
+              stall.duration);
+
+    if (self->n_stalls < ASTAL_WP_WATCHDOG_SIZE) {
+        self->stalls[self->n_stalls++] = stall;
+        return;
+    }
+
+    guint shortest = 0;
+    for (guint i = 1; i < self->n_stalls; i++) {
+        if (self->stalls[i].duration < self->stalls[shortest].duration) shortest = i;
+    }
+    if (self->stalls[shortest].duration < stall.duration) self->stalls[shortest] = stall;
+}
+
+static gint astal_wp_stall_compare(gconstpointer a, gconstpointer b) {
+    const AstalWpStall *stall_a = a, *stall_b = b;
+    if (stall_a->duration == stall_b->duration) return 0;
+    return stall_a->duration < stall_b->duration ? 1 : -1;
+}
+
+AstalWpStall *astal_wp_watchdog_get_stalls(AstalWpWatchdog *self, guint *n_stalls) {
+    *n_stalls = self->n_stalls;
+    if (self->n_stalls == 0) return NULL;
+
+    AstalWpStall *stalls = g_memdup2(self->stalls, self->n_stalls * sizeof(AstalWpStall));
+    qsort(stalls, self->n_stalls, sizeof(AstalWpStall), astal_wp_stall_compare);
+    return stalls;
+}
+
+void astal_wp_watchdog_clear(AstalWpWatchdog *self) { self->n_stalls = 0; }
@@ -1,11 +1,25 @@
 #include <wp/wp.h>
 
-#include "audio.h"
+#include "audio-private.h"
+#include "client-private.h"
 #include "device-private.h"
 #include "endpoint-private.h"
 #include "glib-object.h"
 #include "glib.h"
-#include "video.h"
+#include "histogram-private.h"
+#include "journal-private.h"
+#include "link-private.h"
+#include "mirror-private.h"
+#include "pending-private.h"
+#include "port-private.h"
+#include "profiler-private.h"
+#include "ramp-private.h"
+#include "service-private.h"
+#include "state-table-private.h"
+#include "video-private.h"
+#include "watchdog-private.h"
+#include "worker-private.h"
+#include "wp-private.h"
 #include "wp.h"
 
 struct _AstalWpWp {
@@ -18,9 +32,25 @@ struct _AstalWpWp {
     AstalWpVideo *video;
 
     AstalWpScale scale;
+    gboolean profiler_enabled;
+    gboolean shared_state;
+    gboolean lazy_streams;
+    AstalWpSubsystems subsystems;
+    gboolean optimistic;
+    AstalWpBackend backend;
+    gchar *journal;
+    gdouble replay_speed;
+    gchar *remote;
+
+    guint force_quantum;
+    guint force_rate;
+    gchar *allowed_rates;
 };
 
 typedef struct {
+    // the context every source of this instance is attached to, NULL for the global default
+    GMainContext *context;
+
     WpCore *core;
     WpObjectManager *obj_manager;
 
@@ -28,21 +58,132 @@ typedef struct {
     WpPlugin *defaults;
     gint pending_plugins;
 
+    WpMetadata *default_metadata;
+    gulong default_metadata_signal_handler_id;
+    WpMetadata *settings_metadata;
+    gulong settings_metadata_signal_handler_id;
+
+    AstalWpProfiler *profiler;
+    // times synchronous calls, see AstalWpWp:stall-threshold
+    AstalWpWatchdog *watchdog;
+
+    // running volume ramps, advanced by one timer
+    AstalWpRamps *ramps;
+
+    // outcome of tracked writes per AstalWpWriteKind, see astal_wp_wp_get_confirmation_latency
+    AstalWpHistogram write_latency[ASTAL_WP_WRITE_N_KINDS];
+    guint write_rolled_back[ASTAL_WP_WRITE_N_KINDS];
+
+    // time from an event of PipeWire to the last notify it caused per AstalWpEventKind, see
+    // astal_wp_wp_get_event_latency
+    AstalWpHistogram event_latency[ASTAL_WP_EVENT_N_KINDS];
+    // when the event currently being handled was delivered, 0 outside of one
+    gint64 event_start[ASTAL_WP_EVENT_N_KINDS];
+
+    // converts volumes while the scale is ASTAL_WP_SCALE_CUSTOM
+    AstalWpScaleFunc scale_func;
+    gpointer scale_data;
+    GDestroyNotify scale_destroy;
+
+    // publishes the endpoint state for other processes, see astal/wireplumber/state-table.h
+    AstalWpStateTableWriter *state_table;
+
+    // records the inputs of every handled event, see astal_wp_wp_start_recording
+    AstalWpJournal *recording;
+    // feeds a journal through the handlers of the PipeWire backend, see ASTAL_WP_BACKEND_REPLAY
+    AstalWpReplay *replay;
+    // feeds the state of a core on another thread through them, see ASTAL_WP_BACKEND_THREADED
+    AstalWpWorker *worker;
+
+    // exports this instance on the session bus
+    AstalWpService *service;
+    // mirrors a service instead of connecting to PipeWire, see AstalWpBackend
+    AstalWpMirror *mirror;
+    guint mirror_default_speaker;
+    guint mirror_default_microphone;
+
+    // objects added or removed within one main loop iteration form a batch, collection notifies
+    // are held back in pending_notifies until it ends
+    gboolean in_batch;
+    GArray *pending_notifies;
+    // keeps the batch open until the object manager is installed
+    gboolean hold_batch;
+    guint batch_id;
+
     GHashTable *endpoints;
+    // node id -> AstalWpDeferredStream of streams no AstalWpEndpoint has been created for, see
+    // lazy-streams
+    GHashTable *pending_streams;
     GHashTable *devices;
+    // device id -> GPtrArray of the endpoints with that device.id, also while the device itself is
+    // not known yet. Shared with the AstalWpDevice once it is.
+    GHashTable *device_endpoints;
+    GHashTable *links;
+    GHashTable *ports;
+    GHashTable *clients;
+
+    // object.serial -> AstalWpEndpoint, used to resolve stream targets
+    GHashTable *serials;
+
+    // node id -> AstalWpNodeAdjacency
+    GHashTable *adjacency;
 } AstalWpWpPrivate;
 
+typedef struct {
+    // links whose input node is this node
+    GPtrArray *inputs;
+    // links whose output node is this node
+    GPtrArray *outputs;
+    GPtrArray *ports;
+} AstalWpNodeAdjacency;
+
 G_DEFINE_FINAL_TYPE_WITH_PRIVATE(AstalWpWp, astal_wp_wp, G_TYPE_OBJECT);
 
-G_DEFINE_ENUM_TYPE(AstalWpScale, astal_wp_scale,
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_SCALE_LINEAR, "linear"),
-                   G_DEFINE_ENUM_VALUE(ASTAL_WP_SCALE_CUBIC, "cubic"));
+G_DEFINE_ENUM_TYPE(AstalWpBackend, astal_wp_backend,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_BACKEND_PIPEWIRE, "pipewire"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_BACKEND_DBUS, "dbus"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_BACKEND_REPLAY, "replay"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_BACKEND_THREADED, "threaded"));
+
+G_DEFINE_FLAGS_TYPE(AstalWpSubsystems, astal_wp_subsystems,
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_NONE, "none"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS, "audio-endpoints"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_AUDIO_STREAMS, "audio-streams"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_VIDEO, "video"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_DEVICES, "devices"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_MIXER, "mixer"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_DEFAULTS, "defaults"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_GRAPH, "graph"),
+                    G_DEFINE_ENUM_VALUE(ASTAL_WP_SUBSYSTEM_ALL, "all"));
+
+G_DEFINE_ENUM_TYPE(AstalWpWriteKind, astal_wp_write_kind,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_WRITE_VOLUME, "volume"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_WRITE_MUTE, "mute"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_WRITE_DEFAULT, "default"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_WRITE_PROFILE, "profile"));
+
+G_DEFINE_ENUM_TYPE(AstalWpEventKind, astal_wp_event_kind,
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_EVENT_OBJECT, "object"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_EVENT_MIXER, "mixer"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_EVENT_DEFAULT, "default"),
+                   G_DEFINE_ENUM_VALUE(ASTAL_WP_EVENT_PARAMS, "params"));
 
 typedef enum {
     ASTAL_WP_WP_SIGNAL_ENDPOINT_ADDED,
     ASTAL_WP_WP_SIGNAL_ENDPOINT_REMOVED,
     ASTAL_WP_WP_SIGNAL_DEVICE_ADDED,
     ASTAL_WP_WP_SIGNAL_DEVICE_REMOVED,
+    ASTAL_WP_WP_SIGNAL_LINK_ADDED,
+    ASTAL_WP_WP_SIGNAL_LINK_REMOVED,
+    ASTAL_WP_WP_SIGNAL_PORT_ADDED,
+    ASTAL_WP_WP_SIGNAL_PORT_REMOVED,
+    ASTAL_WP_WP_SIGNAL_CLIENT_ADDED,
+    ASTAL_WP_WP_SIGNAL_CLIENT_REMOVED,
+    ASTAL_WP_WP_SIGNAL_DRIVER_STATS,
+    ASTAL_WP_WP_SIGNAL_READY,
+    ASTAL_WP_WP_SIGNAL_REPLAY_FINISHED,
+    ASTAL_WP_WP_SIGNAL_BATCH_BEGIN,
+    ASTAL_WP_WP_SIGNAL_BATCH_END,
     ASTAL_WP_WP_N_SIGNALS
 } AstalWpWpSignals;
 
@@ -55,9 +196,24 @@ typedef enum {
     ASTAL_WP_WP_PROP_VIDEO,
     ASTAL_WP_WP_PROP_ENDPOINTS,
     ASTAL_WP_WP_PROP_DEVICES,
+    ASTAL_WP_WP_PROP_CLIENTS,
     ASTAL_WP_WP_PROP_DEFAULT_SPEAKER,
     ASTAL_WP_WP_PROP_DEFAULT_MICROPHONE,
     ASTAL_WP_WP_PROP_SCALE,
+    ASTAL_WP_WP_PROP_PROFILER_ENABLED,
+    ASTAL_WP_WP_PROP_FORCE_QUANTUM,
+    ASTAL_WP_WP_PROP_FORCE_RATE,
+    ASTAL_WP_WP_PROP_ALLOWED_RATES,
+    ASTAL_WP_WP_PROP_BACKEND,
+    ASTAL_WP_WP_PROP_SHARED_STATE,
+    ASTAL_WP_WP_PROP_JOURNAL,
+    ASTAL_WP_WP_PROP_REPLAY_SPEED,
+    ASTAL_WP_WP_PROP_LAZY_STREAMS,
+    ASTAL_WP_WP_PROP_REMOTE,
+    ASTAL_WP_WP_PROP_MAIN_CONTEXT,
+    ASTAL_WP_WP_PROP_OPTIMISTIC,
+    ASTAL_WP_WP_PROP_STALL_THRESHOLD,
+    ASTAL_WP_WP_PROP_SUBSYSTEMS,
     ASTAL_WP_WP_N_PROPERTIES,
 } AstalWpWpProperties;
 
@@ -65,6 +221,9 @@ static GParamSpec *astal_wp_wp_properties[ASTAL_WP_WP_N_PROPERTIES] = {
     NULL,
 };
 
+static AstalWpEndpoint *astal_wp_wp_materialize_stream(AstalWpWp *self, guint id);
+static void astal_wp_wp_materialize_streams(AstalWpWp *self);
+
 /**
  * astal_wp_wp_get_endpoint:
  * @self: the AstalWpWp object
@@ -76,6 +235,7 @@ AstalWpEndpoint *astal_wp_wp_get_endpoint(AstalWpWp *self, guint id) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
     AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id));
+    if (endpoint == NULL) endpoint = astal_wp_wp_materialize_stream(self, id);
     return endpoint;
 }
 
@@ -87,6 +247,12 @@ AstalWpEndpoint *astal_wp_wp_get_endpoint(AstalWpWp *self, guint id) {
  * endpoints
  */
 GList *astal_wp_wp_get_endpoints(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    astal_wp_wp_materialize_streams(self);
+    return g_hash_table_get_values(priv->endpoints);
+}
+
+GList *astal_wp_wp_peek_endpoints(AstalWpWp *self) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
     return g_hash_table_get_values(priv->endpoints);
 }
@@ -117,6 +283,297 @@ GList *astal_wp_wp_get_devices(AstalWpWp *self) {
     return g_hash_table_get_values(priv->devices);
 }
 
+/**
+ * astal_wp_wp_get_client:
+ * @self: the AstalWpWp object
+ * @id: the id of the client
+ *
+ * Returns: (transfer none) (nullable): the client with the given id
+ */
+AstalWpClient *astal_wp_wp_get_client(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    // the streams of a client have to be complete
+    astal_wp_wp_materialize_streams(self);
+
+    AstalWpClient *client = g_hash_table_lookup(priv->clients, GUINT_TO_POINTER(id));
+    return client;
+}
+
+/**
+ * astal_wp_wp_get_clients:
+ * @self: the AstalWpWp object
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpClient)): a GList containing the
+ * clients
+ */
+GList *astal_wp_wp_get_clients(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    astal_wp_wp_materialize_streams(self);
+    return g_hash_table_get_values(priv->clients);
+}
+
+static gboolean astal_wp_wp_is_client_stream(AstalWpEndpoint *endpoint) {
+    switch (astal_wp_endpoint_get_media_class(endpoint)) {
+        case ASTAL_WP_MEDIA_CLASS_AUDIO_STREAM:
+        case ASTAL_WP_MEDIA_CLASS_AUDIO_RECORDER:
+            return astal_wp_endpoint_get_client_id(endpoint) != 0;
+        default:
+            return FALSE;
+    }
+}
+
+/**
+ * astal_wp_wp_get_link:
+ * @self: the AstalWpWp object
+ * @id: the id of the link
+ *
+ * Returns: (transfer none) (nullable): the link with the given id
+ */
+AstalWpLink *astal_wp_wp_get_link(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpLink *link = g_hash_table_lookup(priv->links, GUINT_TO_POINTER(id));
+    return link;
+}
+
+/**
+ * astal_wp_wp_get_links:
+ * @self: the AstalWpWp object
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpLink)): a GList containing the
+ * links
+ */
+GList *astal_wp_wp_get_links(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return g_hash_table_get_values(priv->links);
+}
+
+/**
+ * astal_wp_wp_get_port:
+ * @self: the AstalWpWp object
+ * @id: the id of the port
+ *
+ * Returns: (transfer none) (nullable): the port with the given id
+ */
+AstalWpPort *astal_wp_wp_get_port(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpPort *port = g_hash_table_lookup(priv->ports, GUINT_TO_POINTER(id));
+    return port;
+}
+
+/**
+ * astal_wp_wp_get_ports:
+ * @self: the AstalWpWp object
+ *
+ * Returns: (transfer container) (nullable) (type GList(AstalWpPort)): a GList containing the
+ * ports
+ */
+GList *astal_wp_wp_get_ports(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return g_hash_table_get_values(priv->ports);
+}
+
+static void astal_wp_node_adjacency_free(AstalWpNodeAdjacency *adj) {
+    g_ptr_array_unref(adj->inputs);
+    g_ptr_array_unref(adj->outputs);
+    g_ptr_array_unref(adj->ports);
+    g_free(adj);
+}
+
+static AstalWpNodeAdjacency *astal_wp_wp_ensure_adjacency(AstalWpWp *self, guint node_id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpNodeAdjacency *adj = g_hash_table_lookup(priv->adjacency, GUINT_TO_POINTER(node_id));
+    if (adj == NULL) {
+        adj = g_new0(AstalWpNodeAdjacency, 1);
+        adj->inputs = g_ptr_array_new();
+        adj->outputs = g_ptr_array_new();
+        adj->ports = g_ptr_array_new();
+        g_hash_table_insert(priv->adjacency, GUINT_TO_POINTER(node_id), adj);
+    }
+    return adj;
+}
+
+static void astal_wp_wp_release_adjacency(AstalWpWp *self, guint node_id,
+                                          AstalWpNodeAdjacency *adj) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (adj->inputs->len == 0 && adj->outputs->len == 0 && adj->ports->len == 0)
+        g_hash_table_remove(priv->adjacency, GUINT_TO_POINTER(node_id));
+}
+
+GPtrArray *astal_wp_wp_get_node_links(AstalWpWp *self, guint node_id,
+                                      AstalWpDirection direction) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpNodeAdjacency *adj = g_hash_table_lookup(priv->adjacency, GUINT_TO_POINTER(node_id));
+    if (adj == NULL) return NULL;
+    return direction == ASTAL_WP_DIRECTION_INPUT ? adj->inputs : adj->outputs;
+}
+
+GPtrArray *astal_wp_wp_get_node_ports(AstalWpWp *self, guint node_id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpNodeAdjacency *adj = g_hash_table_lookup(priv->adjacency, GUINT_TO_POINTER(node_id));
+    if (adj == NULL) return NULL;
+    return adj->ports;
+}
+
+static void astal_wp_wp_node_links_changed(AstalWpWp *self, guint node_id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(node_id));
+    if (endpoint != NULL) g_signal_emit_by_name(endpoint, "links-changed");
+
+    if (astal_wp_endpoint_get_id(self->default_speaker) == node_id)
+        g_signal_emit_by_name(self->default_speaker, "links-changed");
+    if (astal_wp_endpoint_get_id(self->default_microphone) == node_id)
+        g_signal_emit_by_name(self->default_microphone, "links-changed");
+}
+
+static void astal_wp_wp_link_added(AstalWpWp *self, AstalWpLink *link) {
+    guint output_node = astal_wp_link_get_output_node(link);
+    guint input_node = astal_wp_link_get_input_node(link);
+
+    g_ptr_array_add(astal_wp_wp_ensure_adjacency(self, output_node)->outputs, link);
+    g_ptr_array_add(astal_wp_wp_ensure_adjacency(self, input_node)->inputs, link);
+
+    astal_wp_wp_node_links_changed(self, output_node);
+    astal_wp_wp_node_links_changed(self, input_node);
+}
+
+static void astal_wp_wp_link_removed(AstalWpWp *self, AstalWpLink *link) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint output_node = astal_wp_link_get_output_node(link);
+    guint input_node = astal_wp_link_get_input_node(link);
+    AstalWpNodeAdjacency *adj;
+
+    adj = g_hash_table_lookup(priv->adjacency, GUINT_TO_POINTER(output_node));
+    if (adj != NULL) {
+        g_ptr_array_remove_fast(adj->outputs, link);
+        astal_wp_wp_release_adjacency(self, output_node, adj);
+    }
+
+    adj = g_hash_table_lookup(priv->adjacency, GUINT_TO_POINTER(input_node));
+    if (adj != NULL) {
+        g_ptr_array_remove_fast(adj->inputs, link);
+        astal_wp_wp_release_adjacency(self, input_node, adj);
+    }
+
+    astal_wp_wp_node_links_changed(self, output_node);
+    astal_wp_wp_node_links_changed(self, input_node);
+}
+
+WpMetadata *astal_wp_wp_get_default_metadata(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return priv->default_metadata;
+}
+
+AstalWpEndpoint *astal_wp_wp_find_target(AstalWpWp *self, const gchar *target) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (target == NULL) return NULL;
+
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->serials, target);
+    if (endpoint != NULL) return endpoint;
+
+    // target.object may also hold a node name
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&iter, priv->endpoints);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        if (g_strcmp0(astal_wp_endpoint_get_node_name(value), target) == 0) return value;
+    }
+    return NULL;
+}
+
+/**
+ * astal_wp_wp_move_streams:
+ * @self: the AstalWpWp object
+ * @streams: (element-type AstalWpEndpoint): the streams to move
+ * @target: (nullable): the endpoint the streams should be routed to
+ *
+ * Routes all given streams to @target. Passing NULL makes them follow the default endpoint again.
+ * All metadata updates are queued before returning to the main loop, so they reach PipeWire in a
+ * single round trip. Mirrors forward the whole list as one command to the instance they mirror.
+ */
+void astal_wp_wp_move_streams(AstalWpWp *self, GList *streams, AstalWpEndpoint *target) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->mirror != NULL || priv->worker != NULL) {
+        GVariantBuilder ids = G_VARIANT_BUILDER_INIT(G_VARIANT_TYPE("au"));
+        for (GList *l = streams; l != NULL; l = l->next)
+            g_variant_builder_add(&ids, "u", astal_wp_endpoint_get_id(l->data));
+        astal_wp_wp_remote_command(
+            self, "SetTargets",
+            g_variant_new("(auu)", &ids, target != NULL ? astal_wp_endpoint_get_id(target) : 0));
+        return;
+    }
+
+    if (priv->default_metadata == NULL) {
+        g_warning("can not move streams: default metadata is not available");
+        return;
+    }
+
+    for (GList *l = streams; l != NULL; l = l->next) {
+        astal_wp_endpoint_write_target(l->data, priv->default_metadata, target);
+    }
+}
+
+/**
+ * astal_wp_wp_ramp_volume:
+ * @self: the AstalWpWp object
+ * @endpoints: (element-type AstalWpEndpoint): the endpoints to ramp
+ * @volume: the volume to ramp to
+ * @duration_ms: the duration of the ramps in milliseconds
+ * @curve: how the volume progresses over the duration
+ *
+ * Ramps the volume of every given endpoint to @volume like astal_wp_endpoint_ramp_volume. The
+ * ramps share their start time, so they stay in step and finish together.
+ */
+void astal_wp_wp_ramp_volume(AstalWpWp *self, GList *endpoints, gdouble volume, guint duration_ms,
+                             AstalWpRampCurve curve) {
+    gint64 start = g_get_monotonic_time();
+    for (GList *l = endpoints; l != NULL; l = l->next) {
+        astal_wp_ramp_start(l->data, volume, start, duration_ms, curve);
+    }
+}
+
+static void astal_wp_wp_sync_endpoint_target(AstalWpWp *self, AstalWpEndpoint *endpoint) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->default_metadata == NULL) return;
+
+    guint id = astal_wp_endpoint_get_id(endpoint);
+    astal_wp_endpoint_update_target(
+        endpoint, "target.object",
+        wp_metadata_find(priv->default_metadata, id, "target.object", NULL));
+    astal_wp_endpoint_update_target(
+        endpoint, "target.node", wp_metadata_find(priv->default_metadata, id, "target.node", NULL));
+}
+
+static void astal_wp_wp_default_metadata_changed(AstalWpWp *self, guint subject, const gchar *key,
+                                                 const gchar *type, const gchar *value) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (key != NULL && g_strcmp0(key, "target.object") != 0 && g_strcmp0(key, "target.node") != 0)
+        return;
+
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(subject));
+    if (endpoint != NULL) astal_wp_endpoint_update_target(endpoint, key, value);
+}
+
+/**
+ * astal_wp_wp_get_subsystems
+ *
+ * gets the parts of the graph this instance tracks, see AstalWpWp:subsystems
+ */
+AstalWpSubsystems astal_wp_wp_get_subsystems(AstalWpWp *self) { return self->subsystems; }
+
 /**
  * astal_wp_wp_get_audio
  *
@@ -141,151 +598,1704 @@ AstalWpEndpoint *astal_wp_wp_get_default_speaker(AstalWpWp *self) { return self-
 /**
  * astal_wp_wp_get_default_microphone
  *
- * Returns: (nullable) (transfer none): gets the default microphone object
+ * Returns: (nullable) (transfer none): gets the default microphone object
+ */
+AstalWpEndpoint *astal_wp_wp_get_default_microphone(AstalWpWp *self) {
+    return self->default_microphone;
+}
+
+AstalWpScale astal_wp_wp_get_scale(AstalWpWp *self) { return self->scale; }
+
+// recomputes the volumes of every endpoint from the cached linear volumes
+static void astal_wp_wp_update_scale(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    GHashTableIter iter;
+    gpointer key, value;
+
+    g_hash_table_iter_init(&iter, priv->endpoints);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        astal_wp_endpoint_update_scale(ASTAL_WP_ENDPOINT(value));
+    }
+
+    astal_wp_endpoint_update_scale(self->default_speaker);
+    astal_wp_endpoint_update_scale(self->default_microphone);
+}
+
+/**
+ * astal_wp_wp_set_scale:
+ * @self: the AstalWpWp object
+ * @scale: the scale volumes are reported and set in
+ *
+ * Sets the scale of every endpoint which has no scale of its own. The conversion is done by the
+ * library from cached linear volumes, switching the scale does not involve PipeWire.
+ */
+void astal_wp_wp_set_scale(AstalWpWp *self, AstalWpScale scale) {
+    if (self->scale == scale) return;
+    self->scale = scale;
+    astal_wp_wp_update_scale(self);
+    g_object_notify(G_OBJECT(self), "scale");
+}
+
+/**
+ * astal_wp_wp_set_scale_func:
+ * @self: the AstalWpWp object
+ * @func: (scope notified) (closure data) (destroy destroy): converts between linear volumes and
+ * the custom scale
+ * @data: data passed to @func
+ * @destroy: frees @data
+ *
+ * Sets the scale to ASTAL_WP_SCALE_CUSTOM, converting volumes with @func.
+ */
+void astal_wp_wp_set_scale_func(AstalWpWp *self, AstalWpScaleFunc func, gpointer data,
+                                GDestroyNotify destroy) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->scale_destroy != NULL) priv->scale_destroy(priv->scale_data);
+    priv->scale_func = func;
+    priv->scale_data = data;
+    priv->scale_destroy = destroy;
+
+    if (self->scale == ASTAL_WP_SCALE_CUSTOM)
+        astal_wp_wp_update_scale(self);
+    else
+        astal_wp_wp_set_scale(self, ASTAL_WP_SCALE_CUSTOM);
+}
+
+// the function converting volumes of endpoints without a scale of their own
+AstalWpScaleFunc astal_wp_wp_get_scale_func(AstalWpWp *self, gpointer *data) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    *data = priv->scale_data;
+    return priv->scale_func;
+}
+
+AstalWpRamps *astal_wp_wp_get_ramps(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return priv->ramps;
+}
+
+static guint astal_wp_wp_attach(AstalWpWp *self, GSource *source, gint priority,
+                                GSourceFunc func, gpointer data) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    g_source_set_priority(source, priority);
+    g_source_set_callback(source, func, data, NULL);
+    guint id = g_source_attach(source, priv->context);
+    g_source_unref(source);
+    return id;
+}
+
+guint astal_wp_wp_idle_add(AstalWpWp *self, gint priority, GSourceFunc func, gpointer data) {
+    return astal_wp_wp_attach(self, g_idle_source_new(), priority, func, data);
+}
+
+guint astal_wp_wp_timeout_add(AstalWpWp *self, guint interval, GSourceFunc func, gpointer data) {
+    return astal_wp_wp_attach(self, g_timeout_source_new(interval), G_PRIORITY_DEFAULT, func,
+                              data);
+}
+
+// ids are only unique within one context, g_source_remove would look in the global default one
+void astal_wp_wp_clear_source(AstalWpWp *self, guint *id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (*id == 0) return;
+    GSource *source = g_main_context_find_source_by_id(priv->context, *id);
+    if (source != NULL) g_source_destroy(source);
+    *id = 0;
+}
+
+/**
+ * astal_wp_wp_get_remote:
+ * @self: the AstalWpWp object
+ *
+ * Returns: (nullable): the name or socket path of the PipeWire remote this instance is connected
+ * to, NULL for the default remote
+ */
+const gchar *astal_wp_wp_get_remote(AstalWpWp *self) { return self->remote; }
+
+/**
+ * astal_wp_wp_get_main_context:
+ * @self: the AstalWpWp object
+ *
+ * Returns: (nullable) (transfer none): the main context the sources of this instance are attached
+ * to, NULL for the global default context
+ */
+GMainContext *astal_wp_wp_get_main_context(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return priv->context;
+}
+
+guint astal_wp_wp_get_force_quantum(AstalWpWp *self) { return self->force_quantum; }
+
+guint astal_wp_wp_get_force_rate(AstalWpWp *self) { return self->force_rate; }
+
+const gchar *astal_wp_wp_get_allowed_rates(AstalWpWp *self) { return self->allowed_rates; }
+
+static void astal_wp_wp_write_setting(AstalWpWp *self, const gchar *key, const gchar *value) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->settings_metadata == NULL) {
+        g_warning("can not set %s: settings metadata is not available", key);
+        return;
+    }
+
+    wp_metadata_set(priv->settings_metadata, 0, key, NULL, value);
+}
+
+/**
+ * astal_wp_wp_set_force_quantum:
+ * @self: the AstalWpWp object
+ * @quantum: the quantum to force, or 0 to stop forcing it
+ *
+ * Sets clock.force-quantum in the settings metadata. The force-quantum property is updated once
+ * PipeWire confirms the change.
+ */
+void astal_wp_wp_set_force_quantum(AstalWpWp *self, guint quantum) {
+    g_autofree gchar *value = quantum != 0 ? g_strdup_printf("%u", quantum) : NULL;
+    astal_wp_wp_write_setting(self, "clock.force-quantum", value);
+}
+
+/**
+ * astal_wp_wp_set_force_rate:
+ * @self: the AstalWpWp object
+ * @rate: the sample rate to force, or 0 to stop forcing it
+ *
+ * Sets clock.force-rate in the settings metadata. The force-rate property is updated once
+ * PipeWire confirms the change.
+ */
+void astal_wp_wp_set_force_rate(AstalWpWp *self, guint rate) {
+    g_autofree gchar *value = rate != 0 ? g_strdup_printf("%u", rate) : NULL;
+    astal_wp_wp_write_setting(self, "clock.force-rate", value);
+}
+
+/**
+ * astal_wp_wp_set_allowed_rates:
+ * @self: the AstalWpWp object
+ * @rates: (nullable): the allowed rates as a PipeWire array, e.g. "[ 44100 48000 ]"
+ *
+ * Sets clock.allowed-rates in the settings metadata. The allowed-rates property is updated once
+ * PipeWire confirms the change.
+ */
+void astal_wp_wp_set_allowed_rates(AstalWpWp *self, const gchar *rates) {
+    astal_wp_wp_write_setting(self, "clock.allowed-rates", rates);
+}
+
+static void astal_wp_wp_update_setting(AstalWpWp *self, const gchar *key, const gchar *value) {
+    // a NULL key means every key was removed
+    if (key == NULL || g_strcmp0(key, "clock.force-quantum") == 0) {
+        guint quantum = value != NULL ? g_ascii_strtoull(value, NULL, 10) : 0;
+        if (quantum != self->force_quantum) {
+            self->force_quantum = quantum;
+            g_object_notify(G_OBJECT(self), "force-quantum");
+        }
+    }
+    if (key == NULL || g_strcmp0(key, "clock.force-rate") == 0) {
+        guint rate = value != NULL ? g_ascii_strtoull(value, NULL, 10) : 0;
+        if (rate != self->force_rate) {
+            self->force_rate = rate;
+            g_object_notify(G_OBJECT(self), "force-rate");
+        }
+    }
+    if (key == NULL || g_strcmp0(key, "clock.allowed-rates") == 0) {
+        if (g_strcmp0(value, self->allowed_rates) != 0) {
+            g_free(self->allowed_rates);
+            self->allowed_rates = g_strdup(value);
+            g_object_notify(G_OBJECT(self), "allowed-rates");
+        }
+    }
+}
+
+static void astal_wp_wp_settings_metadata_changed(AstalWpWp *self, guint subject,
+                                                  const gchar *key, const gchar *type,
+                                                  const gchar *value) {
+    if (subject != 0) return;
+    astal_wp_wp_update_setting(self, key, value);
+}
+
+static void astal_wp_wp_driver_stats(const AstalWpDriverStats *stats, guint n_stats,
+                                     AstalWpWp *self) {
+    for (guint i = 0; i < n_stats; i++) {
+        g_signal_emit(self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_DRIVER_STATS], 0, &stats[i]);
+    }
+}
+
+gboolean astal_wp_wp_get_profiler_enabled(AstalWpWp *self) { return self->profiler_enabled; }
+
+/**
+ * astal_wp_wp_set_profiler_enabled:
+ * @self: the AstalWpWp object
+ * @enabled: whether to bind the PipeWire profiler
+ *
+ * Binds or unbinds the PipeWire profiler. While it is bound driver statistics are collected and
+ * the driver-stats signal is emitted. This requires the profiler module to be loaded by the
+ * PipeWire daemon, which it is by default.
+ */
+void astal_wp_wp_set_profiler_enabled(AstalWpWp *self, gboolean enabled) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (self->profiler_enabled == enabled) return;
+    self->profiler_enabled = enabled;
+
+    if (enabled && priv->core != NULL) {
+        priv->profiler = astal_wp_profiler_new(
+            priv->core, (AstalWpProfilerFunc)astal_wp_wp_driver_stats, self);
+    } else {
+        g_clear_pointer(&priv->profiler, astal_wp_profiler_free);
+    }
+
+    g_object_notify(G_OBJECT(self), "profiler-enabled");
+}
+
+gboolean astal_wp_wp_get_shared_state(AstalWpWp *self) { return self->shared_state; }
+
+/**
+ * astal_wp_wp_set_shared_state:
+ * @self: the AstalWpWp object
+ * @shared: whether to publish the endpoint state
+ *
+ * Publishes the ids, media classes, volumes and mute states of all endpoints together with the
+ * default endpoints into a shared memory table in `$XDG_RUNTIME_DIR`. Other processes can read it
+ * without a connection to PipeWire or D-Bus using the functions in
+ * `astal/wireplumber/state-table.h`.
+ * Only one process can publish the table at a time.
+ */
+void astal_wp_wp_set_shared_state(AstalWpWp *self, gboolean shared) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (self->shared_state == shared) return;
+
+    if (shared) {
+        priv->state_table = astal_wp_state_table_writer_new(self);
+        if (priv->state_table == NULL) return;
+    } else {
+        g_clear_pointer(&priv->state_table, astal_wp_state_table_writer_free);
+    }
+
+    self->shared_state = shared;
+    g_object_notify(G_OBJECT(self), "shared-state");
+}
+
+gboolean astal_wp_wp_get_optimistic(AstalWpWp *self) { return self->optimistic; }
+
+/**
+ * astal_wp_wp_set_optimistic:
+ * @self: the AstalWpWp object
+ * @optimistic: whether setters apply their change right away
+ *
+ * Makes the volume, mute, default and profile setters of objects bound to PipeWire update and
+ * notify the local state right away instead of when PipeWire reports the change. Reported values
+ * which do not match a pending write are echoes of earlier writes and are ignored, unless the write
+ * is not confirmed within a second, in which case the reported state is restored.
+ */
+void astal_wp_wp_set_optimistic(AstalWpWp *self, gboolean optimistic) {
+    if (self->optimistic == optimistic) return;
+    self->optimistic = optimistic;
+    g_object_notify(G_OBJECT(self), "optimistic");
+}
+
+void astal_wp_wp_record_confirmation(AstalWpWp *self, AstalWpWriteKind kind, gint64 latency) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    astal_wp_histogram_record(&priv->write_latency[kind], latency);
+}
+
+void astal_wp_wp_record_rollback(AstalWpWp *self, AstalWpWriteKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    priv->write_rolled_back[kind]++;
+}
+
+/**
+ * astal_wp_wp_get_confirmation_count:
+ * @self: the AstalWpWp object
+ * @kind: the kind of write
+ *
+ * gets how many tracked writes of @kind PipeWire confirmed since the instance was created or
+ * astal_wp_wp_reset_confirmation_latency was called. Writes are tracked when they are optimistic,
+ * see AstalWpWp:optimistic, or made through an asynchronous setter.
+ */
+guint64 astal_wp_wp_get_confirmation_count(AstalWpWp *self, AstalWpWriteKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_WRITE_N_KINDS, 0);
+
+    return priv->write_latency[kind].total;
+}
+
+/**
+ * astal_wp_wp_get_confirmation_latency:
+ * @self: the AstalWpWp object
+ * @kind: the kind of write
+ * @percentile: the percentile between 0 and 100
+ *
+ * gets how long PipeWire took to confirm tracked writes of @kind, see
+ * astal_wp_wp_get_confirmation_count. Like astal_wp_wp_get_event_latency the result may be up to
+ * 1/16 too high.
+ *
+ * Returns: the latency in milliseconds of which @percentile percent of the writes were at most,
+ * or 0 if no write of @kind was confirmed
+ */
+gdouble astal_wp_wp_get_confirmation_latency(AstalWpWp *self, AstalWpWriteKind kind,
+                                             gdouble percentile) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_WRITE_N_KINDS, 0);
+
+    return astal_wp_histogram_percentile(&priv->write_latency[kind], percentile) / 1000.0;
+}
+
+/**
+ * astal_wp_wp_get_confirmation_latency_max:
+ * @self: the AstalWpWp object
+ * @kind: the kind of write
+ *
+ * gets the longest time in milliseconds PipeWire took to confirm a tracked write of @kind
+ */
+gdouble astal_wp_wp_get_confirmation_latency_max(AstalWpWp *self, AstalWpWriteKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_WRITE_N_KINDS, 0);
+
+    return priv->write_latency[kind].max / 1000.0;
+}
+
+/**
+ * astal_wp_wp_reset_confirmation_latency:
+ * @self: the AstalWpWp object
+ *
+ * Forgets the confirmation latencies of every write kind recorded so far.
+ */
+void astal_wp_wp_reset_confirmation_latency(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    for (guint i = 0; i < ASTAL_WP_WRITE_N_KINDS; i++)
+        astal_wp_histogram_reset(&priv->write_latency[i]);
+}
+
+/**
+ * astal_wp_wp_get_rollbacks:
+ * @self: the AstalWpWp object
+ * @kind: the kind of write
+ *
+ * gets the number of optimistic writes of @kind which were not confirmed in time and rolled back
+ */
+guint astal_wp_wp_get_rollbacks(AstalWpWp *self, AstalWpWriteKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_WRITE_N_KINDS, 0);
+
+    return priv->write_rolled_back[kind];
+}
+
+void astal_wp_wp_record_event(AstalWpWp *self, AstalWpEventKind kind, gint64 start) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    astal_wp_histogram_record(&priv->event_latency[kind], g_get_monotonic_time() - start);
+}
+
+// Signals which fan out to many handlers are timestamped by a handler connected before all others
+// and recorded by one connected after all of them, so every notify they cause is covered.
+static void astal_wp_wp_event_begin(AstalWpWp *self, AstalWpEventKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    priv->event_start[kind] = g_get_monotonic_time();
+}
+
+static void astal_wp_wp_event_end(AstalWpWp *self, AstalWpEventKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    if (priv->event_start[kind] == 0) return;
+    astal_wp_wp_record_event(self, kind, priv->event_start[kind]);
+    priv->event_start[kind] = 0;
+}
+
+static void astal_wp_wp_object_event_begin(AstalWpWp *self) {
+    astal_wp_wp_event_begin(self, ASTAL_WP_EVENT_OBJECT);
+}
+
+static void astal_wp_wp_object_event_end(AstalWpWp *self) {
+    astal_wp_wp_event_end(self, ASTAL_WP_EVENT_OBJECT);
+}
+
+static void astal_wp_wp_mixer_event_begin(AstalWpWp *self) {
+    astal_wp_wp_event_begin(self, ASTAL_WP_EVENT_MIXER);
+}
+
+static void astal_wp_wp_mixer_event_end(AstalWpWp *self) {
+    astal_wp_wp_event_end(self, ASTAL_WP_EVENT_MIXER);
+}
+
+static void astal_wp_wp_default_event_begin(AstalWpWp *self) {
+    astal_wp_wp_event_begin(self, ASTAL_WP_EVENT_DEFAULT);
+}
+
+static void astal_wp_wp_default_event_end(AstalWpWp *self) {
+    astal_wp_wp_event_end(self, ASTAL_WP_EVENT_DEFAULT);
+}
+
+/**
+ * astal_wp_wp_get_event_count:
+ * @self: the AstalWpWp object
+ * @kind: the kind of event
+ *
+ * gets how many events of @kind were handled since the instance was created or
+ * astal_wp_wp_reset_event_latency was called. Events are only timed on instances which are
+ * connected to PipeWire in their own main context, see ASTAL_WP_BACKEND_PIPEWIRE, and on replays
+ * of a journal, which time the handlers the same way.
+ */
+guint64 astal_wp_wp_get_event_count(AstalWpWp *self, AstalWpEventKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_EVENT_N_KINDS, 0);
+
+    return priv->event_latency[kind].total;
+}
+
+/**
+ * astal_wp_wp_get_event_latency:
+ * @self: the AstalWpWp object
+ * @kind: the kind of event
+ * @percentile: the percentile between 0 and 100
+ *
+ * gets how long it took from PipeWire delivering an event of @kind to the object manager or a
+ * plugin until every notify it caused was emitted. The values are kept in a histogram whose
+ * buckets are within 1/16 of the values they count, so the result may be that much too high.
+ * Collection notifies, like AstalWpWp:endpoints, are held back until a batch of added or removed
+ * objects ends and are not included.
+ *
+ * Returns: the latency in milliseconds of which @percentile percent of the events were at most, or
+ * 0 if no event of @kind was handled
+ */
+gdouble astal_wp_wp_get_event_latency(AstalWpWp *self, AstalWpEventKind kind, gdouble percentile) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_EVENT_N_KINDS, 0);
+
+    return astal_wp_histogram_percentile(&priv->event_latency[kind], percentile) / 1000.0;
+}
+
+/**
+ * astal_wp_wp_get_event_latency_max:
+ * @self: the AstalWpWp object
+ * @kind: the kind of event
+ *
+ * gets the longest latency in milliseconds of an event of @kind, see
+ * astal_wp_wp_get_event_latency
+ */
+gdouble astal_wp_wp_get_event_latency_max(AstalWpWp *self, AstalWpEventKind kind) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_return_val_if_fail(kind < ASTAL_WP_EVENT_N_KINDS, 0);
+
+    return priv->event_latency[kind].max / 1000.0;
+}
+
+/**
+ * astal_wp_wp_reset_event_latency:
+ * @self: the AstalWpWp object
+ *
+ * Forgets the latencies of every event kind recorded so far.
+ */
+void astal_wp_wp_reset_event_latency(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    for (guint i = 0; i < ASTAL_WP_EVENT_N_KINDS; i++)
+        astal_wp_histogram_reset(&priv->event_latency[i]);
+}
+
+/**
+ * astal_wp_wp_get_stall_threshold:
+ * @self: the AstalWpWp object
+ *
+ * gets the time in milliseconds after which a synchronous call is considered a stall
+ */
+guint astal_wp_wp_get_stall_threshold(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return astal_wp_watchdog_get_threshold(priv->watchdog);
+}
+
+/**
+ * astal_wp_wp_set_stall_threshold:
+ * @self: the AstalWpWp object
+ * @threshold: the threshold in milliseconds, 0 to disable the watchdog
+ *
+ * Sets the time after which a synchronous call, like connecting to PipeWire, enumerating the
+ * params of a device or the action signals of the mixer and default nodes plugins, is logged as a
+ * warning tagged with its call site and kept, see astal_wp_wp_get_stalls.
+ */
+void astal_wp_wp_set_stall_threshold(AstalWpWp *self, guint threshold) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    if (astal_wp_watchdog_get_threshold(priv->watchdog) == threshold) return;
+    astal_wp_watchdog_set_threshold(priv->watchdog, threshold);
+    g_object_notify(G_OBJECT(self), "stall-threshold");
+}
+
+void astal_wp_wp_report_call(AstalWpWp *self, const gchar *call, const gchar *location,
+                             const gchar *function, guint id, gint64 start) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    astal_wp_watchdog_report(priv->watchdog, call, location, function, id, start);
+}
+
+/**
+ * astal_wp_wp_get_stalls:
+ * @self: the AstalWpWp object
+ * @n_stalls: (out): the number of stalls
+ *
+ * gets the longest synchronous calls made by this instance which took longer than
+ * AstalWpWp:stall-threshold, at most 32 of them
+ *
+ * Returns: (transfer full) (array length=n_stalls) (nullable): the stalls, longest first
+ */
+AstalWpStall *astal_wp_wp_get_stalls(AstalWpWp *self, guint *n_stalls) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return astal_wp_watchdog_get_stalls(priv->watchdog, n_stalls);
+}
+
+/**
+ * astal_wp_wp_clear_stalls:
+ * @self: the AstalWpWp object
+ *
+ * Forgets the stalls recorded so far.
+ */
+void astal_wp_wp_clear_stalls(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    astal_wp_watchdog_clear(priv->watchdog);
+}
+
+/**
+ * astal_wp_wp_get_driver_stats:
+ * @self: the AstalWpWp object
+ * @driver_id: the node id of the driver
+ * @stats: (out caller-allocates): the most recent statistics of the driver
+ *
+ * Gets the statistics of the last cycle of the given driver. This is only available while the
+ * profiler is enabled.
+ *
+ * Returns: whether statistics were found for the driver
+ */
+gboolean astal_wp_wp_get_driver_stats(AstalWpWp *self, guint driver_id,
+                                      AstalWpDriverStats *stats) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->profiler == NULL) return FALSE;
+    return astal_wp_profiler_get_stats(priv->profiler, driver_id, stats);
+}
+
+/**
+ * astal_wp_wp_get_driver_history:
+ * @self: the AstalWpWp object
+ * @driver_id: the node id of the driver
+ * @n_samples: (out): the number of samples
+ *
+ * Gets the recent statistics of the given driver, oldest first. Every sample covers one
+ * driver-stats interval and carries the peak dsp load of that interval.
+ *
+ * Returns: (transfer full) (array length=n_samples) (nullable): the samples
+ */
+AstalWpDriverStats *astal_wp_wp_get_driver_history(AstalWpWp *self, guint driver_id,
+                                                   guint *n_samples) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->profiler == NULL) {
+        *n_samples = 0;
+        return NULL;
+    }
+    return astal_wp_profiler_get_history(priv->profiler, driver_id, n_samples);
+}
+
+/**
+ * astal_wp_wp_get_drivers:
+ * @self: the AstalWpWp object
+ * @n_drivers: (out): the number of drivers
+ *
+ * Gets the node ids of the drivers the profiler has reported on.
+ *
+ * Returns: (transfer full) (array length=n_drivers) (nullable): the ids of the drivers
+ */
+guint *astal_wp_wp_get_drivers(AstalWpWp *self, guint *n_drivers) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->profiler == NULL) {
+        *n_drivers = 0;
+        return NULL;
+    }
+    return astal_wp_profiler_get_drivers(priv->profiler, n_drivers);
+}
+
+static void astal_wp_wp_get_property(GObject *object, guint property_id, GValue *value,
+                                     GParamSpec *pspec) {
+    AstalWpWp *self = ASTAL_WP_WP(object);
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    switch (property_id) {
+        case ASTAL_WP_WP_PROP_AUDIO:
+            g_value_set_object(value, astal_wp_wp_get_audio(self));
+            break;
+        case ASTAL_WP_WP_PROP_VIDEO:
+            g_value_set_object(value, astal_wp_wp_get_video(self));
+            break;
+        case ASTAL_WP_WP_PROP_ENDPOINTS:
+            g_value_set_pointer(value, astal_wp_wp_get_endpoints(self));
+            break;
+        case ASTAL_WP_WP_PROP_DEVICES:
+            g_value_set_pointer(value, g_hash_table_get_values(priv->devices));
+            break;
+        case ASTAL_WP_WP_PROP_CLIENTS:
+            g_value_set_pointer(value, astal_wp_wp_get_clients(self));
+            break;
+        case ASTAL_WP_WP_PROP_DEFAULT_SPEAKER:
+            g_value_set_object(value, self->default_speaker);
+            break;
+        case ASTAL_WP_WP_PROP_DEFAULT_MICROPHONE:
+            g_value_set_object(value, self->default_microphone);
+            break;
+        case ASTAL_WP_WP_PROP_SCALE:
+            g_value_set_enum(value, self->scale);
+            break;
+        case ASTAL_WP_WP_PROP_PROFILER_ENABLED:
+            g_value_set_boolean(value, self->profiler_enabled);
+            break;
+        case ASTAL_WP_WP_PROP_FORCE_QUANTUM:
+            g_value_set_uint(value, self->force_quantum);
+            break;
+        case ASTAL_WP_WP_PROP_FORCE_RATE:
+            g_value_set_uint(value, self->force_rate);
+            break;
+        case ASTAL_WP_WP_PROP_ALLOWED_RATES:
+            g_value_set_string(value, self->allowed_rates);
+            break;
+        case ASTAL_WP_WP_PROP_BACKEND:
+            g_value_set_enum(value, self->backend);
+            break;
+        case ASTAL_WP_WP_PROP_SHARED_STATE:
+            g_value_set_boolean(value, self->shared_state);
+            break;
+        case ASTAL_WP_WP_PROP_JOURNAL:
+            g_value_set_string(value, self->journal);
+            break;
+        case ASTAL_WP_WP_PROP_REPLAY_SPEED:
+            g_value_set_double(value, self->replay_speed);
+            break;
+        case ASTAL_WP_WP_PROP_LAZY_STREAMS:
+            g_value_set_boolean(value, self->lazy_streams);
+            break;
+        case ASTAL_WP_WP_PROP_REMOTE:
+            g_value_set_string(value, self->remote);
+            break;
+        case ASTAL_WP_WP_PROP_MAIN_CONTEXT:
+            g_value_set_boxed(value, astal_wp_wp_get_main_context(self));
+            break;
+        case ASTAL_WP_WP_PROP_OPTIMISTIC:
+            g_value_set_boolean(value, self->optimistic);
+            break;
+        case ASTAL_WP_WP_PROP_STALL_THRESHOLD:
+            g_value_set_uint(value, astal_wp_wp_get_stall_threshold(self));
+            break;
+        case ASTAL_WP_WP_PROP_SUBSYSTEMS:
+            g_value_set_flags(value, self->subsystems);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+static void astal_wp_wp_set_property(GObject *object, guint property_id, const GValue *value,
+                                     GParamSpec *pspec) {
+    AstalWpWp *self = ASTAL_WP_WP(object);
+
+    switch (property_id) {
+        case ASTAL_WP_WP_PROP_SCALE:
+            astal_wp_wp_set_scale(self, g_value_get_enum(value));
+            break;
+        case ASTAL_WP_WP_PROP_PROFILER_ENABLED:
+            astal_wp_wp_set_profiler_enabled(self, g_value_get_boolean(value));
+            break;
+        case ASTAL_WP_WP_PROP_FORCE_QUANTUM:
+            astal_wp_wp_set_force_quantum(self, g_value_get_uint(value));
+            break;
+        case ASTAL_WP_WP_PROP_FORCE_RATE:
+            astal_wp_wp_set_force_rate(self, g_value_get_uint(value));
+            break;
+        case ASTAL_WP_WP_PROP_ALLOWED_RATES:
+            astal_wp_wp_set_allowed_rates(self, g_value_get_string(value));
+            break;
+        case ASTAL_WP_WP_PROP_BACKEND:
+            self->backend = g_value_get_enum(value);
+            break;
+        case ASTAL_WP_WP_PROP_SHARED_STATE:
+            astal_wp_wp_set_shared_state(self, g_value_get_boolean(value));
+            break;
+        case ASTAL_WP_WP_PROP_JOURNAL:
+            g_free(self->journal);
+            self->journal = g_value_dup_string(value);
+            break;
+        case ASTAL_WP_WP_PROP_REPLAY_SPEED:
+            self->replay_speed = g_value_get_double(value);
+            break;
+        case ASTAL_WP_WP_PROP_LAZY_STREAMS:
+            self->lazy_streams = g_value_get_boolean(value);
+            break;
+        case ASTAL_WP_WP_PROP_REMOTE:
+            g_free(self->remote);
+            self->remote = g_value_dup_string(value);
+            break;
+        case ASTAL_WP_WP_PROP_MAIN_CONTEXT: {
+            AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+            GMainContext *context = g_value_get_boxed(value);
+            if (context != NULL) priv->context = g_main_context_ref(context);
+            break;
+        }
+        case ASTAL_WP_WP_PROP_OPTIMISTIC:
+            astal_wp_wp_set_optimistic(self, g_value_get_boolean(value));
+            break;
+        case ASTAL_WP_WP_PROP_STALL_THRESHOLD:
+            astal_wp_wp_set_stall_threshold(self, g_value_get_uint(value));
+            break;
+        case ASTAL_WP_WP_PROP_SUBSYSTEMS:
+            self->subsystems = g_value_get_flags(value);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+            break;
+    }
+}
+
+typedef struct {
+    GObject *object;
+    GParamSpec *pspec;
+} AstalWpPendingNotify;
+
+// notifies a collection property of this instance, its AstalWpAudio or its AstalWpVideo. While a
+// batch is open the notify is held back until it ends and emitted once however often it was asked
+// for, other properties of these objects are notified right away
+void astal_wp_wp_notify_collection(AstalWpWp *self, GObject *object, const gchar *property) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    GParamSpec *pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(object), property);
+
+    if (!priv->in_batch) {
+        g_object_notify_by_pspec(object, pspec);
+        return;
+    }
+
+    for (guint i = 0; i < priv->pending_notifies->len; i++) {
+        AstalWpPendingNotify *pending =
+            &g_array_index(priv->pending_notifies, AstalWpPendingNotify, i);
+        if (pending->object == object && pending->pspec == pspec) return;
+    }
+
+    AstalWpPendingNotify pending = {object, pspec};
+    g_array_append_val(priv->pending_notifies, pending);
+}
+
+static gboolean astal_wp_wp_batch_end(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    astal_wp_wp_clear_source(self, &priv->batch_id);
+    if (!priv->in_batch) return G_SOURCE_REMOVE;
+    priv->in_batch = FALSE;
+
+    // the batch is closed already, so a notify asked for by a handler is emitted right away
+    for (guint i = 0; i < priv->pending_notifies->len; i++) {
+        AstalWpPendingNotify *pending =
+            &g_array_index(priv->pending_notifies, AstalWpPendingNotify, i);
+        g_object_notify_by_pspec(pending->object, pending->pspec);
+    }
+    g_array_set_size(priv->pending_notifies, 0);
+
+    g_signal_emit(self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_BATCH_END], 0);
+    return G_SOURCE_REMOVE;
+}
+
+// opens a batch unless one is open already
+static void astal_wp_wp_batch(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->in_batch) return;
+    priv->in_batch = TRUE;
+
+    g_signal_emit(self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_BATCH_BEGIN], 0);
+
+    // a burst of PipeWire events is dispatched at default priority, this runs once it is drained
+    // but before the next frame is drawn
+    if (!priv->hold_batch)
+        priv->batch_id = astal_wp_wp_idle_add(self, G_PRIORITY_HIGH_IDLE,
+                                              (GSourceFunc)astal_wp_wp_batch_end, self);
+}
+
+// adds the endpoint to the index of its device and links the device if it is known already
+static void astal_wp_wp_index_endpoint(AstalWpWp *self, AstalWpEndpoint *endpoint) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint id = astal_wp_endpoint_get_device_id(endpoint);
+    if (id == 0) return;
+
+    GPtrArray *endpoints = g_hash_table_lookup(priv->device_endpoints, GUINT_TO_POINTER(id));
+    if (endpoints == NULL) {
+        endpoints = g_ptr_array_new();
+        g_hash_table_insert(priv->device_endpoints, GUINT_TO_POINTER(id), endpoints);
+    }
+    g_ptr_array_add(endpoints, endpoint);
+
+    AstalWpDevice *device = g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id));
+    if (device == NULL) return;
+    astal_wp_endpoint_set_device(endpoint, device);
+    astal_wp_device_endpoints_changed(device);
+}
+
+static void astal_wp_wp_unindex_endpoint(AstalWpWp *self, AstalWpEndpoint *endpoint) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint id = astal_wp_endpoint_get_device_id(endpoint);
+    GPtrArray *endpoints = g_hash_table_lookup(priv->device_endpoints, GUINT_TO_POINTER(id));
+    if (endpoints == NULL || !g_ptr_array_remove(endpoints, endpoint)) return;
+
+    astal_wp_endpoint_set_device(endpoint, NULL);
+    AstalWpDevice *device = g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id));
+    if (device != NULL)
+        astal_wp_device_endpoints_changed(device);
+    else if (endpoints->len == 0)
+        g_hash_table_remove(priv->device_endpoints, GUINT_TO_POINTER(id));
+}
+
+// links the endpoints which were added before their device, including the default ones
+static void astal_wp_wp_index_device(AstalWpWp *self, AstalWpDevice *device) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint id = astal_wp_device_get_id(device);
+    GPtrArray *endpoints = g_hash_table_lookup(priv->device_endpoints, GUINT_TO_POINTER(id));
+    if (endpoints == NULL) {
+        endpoints = g_ptr_array_new();
+        g_hash_table_insert(priv->device_endpoints, GUINT_TO_POINTER(id), endpoints);
+    }
+
+    for (guint i = 0; i < endpoints->len; i++)
+        astal_wp_endpoint_set_device(endpoints->pdata[i], device);
+    if (astal_wp_endpoint_get_device_id(self->default_speaker) == id)
+        astal_wp_endpoint_set_device(self->default_speaker, device);
+    if (astal_wp_endpoint_get_device_id(self->default_microphone) == id)
+        astal_wp_endpoint_set_device(self->default_microphone, device);
+
+    astal_wp_device_set_endpoints(device, endpoints);
+}
+
+static void astal_wp_wp_unindex_device(AstalWpWp *self, AstalWpDevice *device) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint id = astal_wp_device_get_id(device);
+    GPtrArray *endpoints = g_hash_table_lookup(priv->device_endpoints, GUINT_TO_POINTER(id));
+    if (endpoints != NULL) {
+        for (guint i = 0; i < endpoints->len; i++)
+            astal_wp_endpoint_set_device(endpoints->pdata[i], NULL);
+        if (endpoints->len == 0)
+            g_hash_table_remove(priv->device_endpoints, GUINT_TO_POINTER(id));
+    }
+    if (astal_wp_endpoint_get_device(self->default_speaker) == device)
+        astal_wp_endpoint_set_device(self->default_speaker, NULL);
+    if (astal_wp_endpoint_get_device(self->default_microphone) == device)
+        astal_wp_endpoint_set_device(self->default_microphone, NULL);
+
+    astal_wp_device_set_endpoints(device, NULL);
+}
+
+static void astal_wp_wp_add_endpoint(AstalWpWp *self, AstalWpEndpoint *endpoint) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    astal_wp_wp_batch(self);
+
+    g_hash_table_insert(priv->endpoints, GUINT_TO_POINTER(astal_wp_endpoint_get_id(endpoint)),
+                        endpoint);
+    if (astal_wp_endpoint_get_serial(endpoint) != NULL)
+        g_hash_table_insert(priv->serials, (gpointer)astal_wp_endpoint_get_serial(endpoint),
+                            endpoint);
+    astal_wp_wp_sync_endpoint_target(self, endpoint);
+    astal_wp_wp_index_endpoint(self, endpoint);
+
+    if (astal_wp_wp_is_client_stream(endpoint)) {
+        AstalWpClient *client = g_hash_table_lookup(
+            priv->clients, GUINT_TO_POINTER(astal_wp_endpoint_get_client_id(endpoint)));
+        if (client != NULL) astal_wp_client_add_stream(client, endpoint);
+    }
+
+    if (self->audio != NULL) astal_wp_audio_endpoint_added(self->audio, endpoint);
+    if (self->video != NULL) astal_wp_video_endpoint_added(self->video, endpoint);
+    g_signal_emit_by_name(self, "endpoint-added", endpoint);
+    astal_wp_wp_notify_collection(self, G_OBJECT(self), "endpoints");
+}
+
+static void astal_wp_wp_remove_endpoint(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id));
+    if (endpoint == NULL) return;
+    astal_wp_wp_batch(self);
+    g_object_ref(endpoint);
+
+    if (astal_wp_endpoint_get_serial(endpoint) != NULL)
+        g_hash_table_remove(priv->serials, astal_wp_endpoint_get_serial(endpoint));
+    if (astal_wp_wp_is_client_stream(endpoint)) {
+        AstalWpClient *client = g_hash_table_lookup(
+            priv->clients, GUINT_TO_POINTER(astal_wp_endpoint_get_client_id(endpoint)));
+        if (client != NULL) astal_wp_client_remove_stream(client, endpoint);
+    }
+    astal_wp_wp_unindex_endpoint(self, endpoint);
+    g_hash_table_remove(priv->endpoints, GUINT_TO_POINTER(id));
+
+    if (self->audio != NULL) astal_wp_audio_endpoint_removed(self->audio, endpoint);
+    if (self->video != NULL) astal_wp_video_endpoint_removed(self->video, endpoint);
+    g_signal_emit_by_name(self, "endpoint-removed", endpoint);
+    astal_wp_wp_notify_collection(self, G_OBJECT(self), "endpoints");
+    g_object_unref(endpoint);
+}
+
+static void astal_wp_wp_add_device(AstalWpWp *self, AstalWpDevice *device) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    astal_wp_wp_batch(self);
+
+    g_hash_table_insert(priv->devices, GUINT_TO_POINTER(astal_wp_device_get_id(device)), device);
+    astal_wp_wp_index_device(self, device);
+    if (self->audio != NULL) astal_wp_audio_device_added(self->audio, device);
+    if (self->video != NULL) astal_wp_video_device_added(self->video, device);
+    g_signal_emit_by_name(self, "device-added", device);
+    astal_wp_wp_notify_collection(self, G_OBJECT(self), "devices");
+}
+
+static void astal_wp_wp_remove_device(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpDevice *device = g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id));
+    if (device == NULL) return;
+    astal_wp_wp_batch(self);
+    g_object_ref(device);
+    astal_wp_wp_unindex_device(self, device);
+    g_hash_table_remove(priv->devices, GUINT_TO_POINTER(id));
+
+    if (self->audio != NULL) astal_wp_audio_device_removed(self->audio, device);
+    if (self->video != NULL) astal_wp_video_device_removed(self->video, device);
+    g_signal_emit_by_name(self, "device-removed", device);
+    astal_wp_wp_notify_collection(self, G_OBJECT(self), "devices");
+    g_object_unref(device);
+}
+
+// a stream kept back by lazy-streams, node is NULL for streams added by a replay
+typedef struct {
+    WpNode *node;
+    WpProperties *properties;
+} AstalWpDeferredStream;
+
+static void astal_wp_deferred_stream_free(AstalWpDeferredStream *stream) {
+    g_clear_object(&stream->node);
+    wp_properties_unref(stream->properties);
+    g_free(stream);
+}
+
+static gboolean astal_wp_wp_has_stream_handlers(AstalWpWp *self) {
+    return g_signal_has_handler_pending(
+               self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_ENDPOINT_ADDED], 0, FALSE) ||
+           g_signal_has_handler_pending(
+               self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_ENDPOINT_REMOVED], 0, FALSE) ||
+           g_signal_has_handler_pending(self, g_signal_lookup("notify", G_TYPE_OBJECT),
+                                        g_quark_from_static_string("endpoints"), FALSE) ||
+           (self->audio != NULL && astal_wp_audio_has_stream_handlers(self->audio)) ||
+           (self->video != NULL && astal_wp_video_has_stream_handlers(self->video));
+}
+
+// keeps only the node of a stream nobody is going to look at yet
+static gboolean astal_wp_wp_defer_stream(AstalWpWp *self, guint id, WpNode *node,
+                                         WpProperties *properties) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (!self->lazy_streams) return FALSE;
+
+    const gchar *media_class = wp_properties_get(properties, "media.class");
+    if (media_class == NULL || !g_str_has_prefix(media_class, "Stream/")) return FALSE;
+    if (astal_wp_wp_has_stream_handlers(self)) return FALSE;
+
+    AstalWpDeferredStream *stream = g_new0(AstalWpDeferredStream, 1);
+    stream->node = node != NULL ? g_object_ref(node) : NULL;
+    stream->properties = wp_properties_ref(properties);
+    g_hash_table_insert(priv->pending_streams, GUINT_TO_POINTER(id), stream);
+    return TRUE;
+}
+
+static AstalWpEndpoint *astal_wp_wp_materialize_stream(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpDeferredStream *stream = NULL;
+    if (priv->pending_streams == NULL ||
+        !g_hash_table_steal_extended(priv->pending_streams, GUINT_TO_POINTER(id), NULL,
+                                     (gpointer *)&stream))
+        return NULL;
+
+    AstalWpEndpoint *endpoint = astal_wp_endpoint_create(id, stream->node, stream->properties,
+                                                         priv->mixer, priv->defaults, self);
+    astal_wp_wp_add_endpoint(self, endpoint);
+    astal_wp_deferred_stream_free(stream);
+    return endpoint;
+}
+
+static void astal_wp_wp_materialize_streams(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->pending_streams == NULL || g_hash_table_size(priv->pending_streams) == 0) return;
+
+    GList *ids = g_hash_table_get_keys(priv->pending_streams);
+    for (GList *l = ids; l != NULL; l = l->next)
+        astal_wp_wp_materialize_stream(self, GPOINTER_TO_UINT(l->data));
+    g_list_free(ids);
+}
+
+void astal_wp_wp_sync_lazy_streams(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->pending_streams == NULL || g_hash_table_size(priv->pending_streams) == 0) return;
+    if (astal_wp_wp_has_stream_handlers(self)) astal_wp_wp_materialize_streams(self);
+}
+
+// node is NULL for nodes added by a replay
+static void astal_wp_wp_node_added(AstalWpWp *self, guint id, WpNode *node,
+                                   WpProperties *properties) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (astal_wp_wp_defer_stream(self, id, node, properties)) return;
+    astal_wp_wp_add_endpoint(self, astal_wp_endpoint_create(id, node, properties, priv->mixer,
+                                                            priv->defaults, self));
+}
+
+static void astal_wp_wp_node_removed(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (g_hash_table_remove(priv->pending_streams, GUINT_TO_POINTER(id))) return;
+    astal_wp_wp_remove_endpoint(self, id);
+}
+
+// a copy of the properties of a proxy, they wrap its info which is replaced on the next update
+static WpProperties *astal_wp_wp_copy_properties(gpointer object) {
+    WpProperties *properties = wp_pipewire_object_get_properties(WP_PIPEWIRE_OBJECT(object));
+    if (properties == NULL) return wp_properties_new_empty();
+    return wp_properties_ensure_unique_owner(properties);
+}
+
+// journals the volume of a node ahead of the node itself, the endpoint asks for it once created
+static void astal_wp_wp_record_volume(AstalWpWp *self, guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    GVariant *variant = NULL;
+
+    if (priv->mixer == NULL) return;
+    g_signal_emit_by_name(priv->mixer, "get-volume", id, &variant);
+    if (variant == NULL) return;
+
+    astal_wp_journal_input(priv->recording, ASTAL_WP_JOURNAL_MIXER_VOLUME,
+                           g_variant_new("(u@a{sv})", id, variant));
+    g_variant_unref(variant);
+}
+
+static void astal_wp_wp_object_added(AstalWpWp *self, gpointer object) {
+    // print pipewire properties
+    // WpIterator *iter = wp_pipewire_object_new_properties_iterator(WP_PIPEWIRE_OBJECT(object));
+    // GValue item = G_VALUE_INIT;
+    // const gchar *key, *value;
+    //
+    // g_print("\n\n");
+    // while (wp_iterator_next (iter, &item)) {
+    //     WpPropertiesItem *pi = g_value_get_boxed (&item);
+    //     key = wp_properties_item_get_key (pi);
+    //     value = wp_properties_item_get_value (pi);
+    //     g_print("%s: %s\n", key, value);
+    //     g_value_unset(&item);
+    // }
+
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    // handlers connected since the last event want the pending streams
+    astal_wp_wp_sync_lazy_streams(self);
+
+    if (WP_IS_NODE(object) || WP_IS_DEVICE(object)) {
+        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
+        WpProperties *properties = astal_wp_wp_copy_properties(object);
+
+        if (WP_IS_NODE(object)) {
+            if (priv->recording != NULL) {
+                astal_wp_wp_record_volume(self, id);
+                astal_wp_journal_input(priv->recording, ASTAL_WP_JOURNAL_PW_NODE_ADDED,
+                                       astal_wp_journal_properties(id, properties));
+            }
+            astal_wp_wp_node_added(self, id, WP_NODE(object), properties);
+        } else {
+            if (priv->recording != NULL)
+                astal_wp_journal_input(priv->recording, ASTAL_WP_JOURNAL_PW_DEVICE_ADDED,
+                                       astal_wp_journal_properties(id, properties));
+            astal_wp_wp_add_device(self,
+                                   astal_wp_device_create(id, WP_DEVICE(object), properties, self));
+        }
+        wp_properties_unref(properties);
+    } else if (WP_IS_LINK(object)) {
+        AstalWpLink *link = astal_wp_link_create(WP_LINK(object));
+        g_hash_table_insert(priv->links, GUINT_TO_POINTER(astal_wp_link_get_id(link)), link);
+        astal_wp_wp_link_added(self, link);
+        g_signal_emit_by_name(self, "link-added", link);
+    } else if (WP_IS_PORT(object)) {
+        AstalWpPort *port = astal_wp_port_create(WP_PORT(object));
+        g_hash_table_insert(priv->ports, GUINT_TO_POINTER(astal_wp_port_get_id(port)), port);
+        g_ptr_array_add(
+            astal_wp_wp_ensure_adjacency(self, astal_wp_port_get_node_id(port))->ports, port);
+        g_signal_emit_by_name(self, "port-added", port);
+    } else if (WP_IS_CLIENT(object)) {
+        astal_wp_wp_batch(self);
+        AstalWpClient *client = astal_wp_client_create(WP_CLIENT(object), self);
+        guint id = astal_wp_client_get_id(client);
+        g_hash_table_insert(priv->clients, GUINT_TO_POINTER(id), client);
+
+        // streams are usually announced after their client, this only catches the stragglers
+        GHashTableIter iter;
+        gpointer key, value;
+
+        g_hash_table_iter_init(&iter, priv->endpoints);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            if (astal_wp_wp_is_client_stream(value) &&
+                astal_wp_endpoint_get_client_id(value) == id)
+                astal_wp_client_add_stream(client, value);
+        }
+
+        g_signal_emit_by_name(self, "client-added", client);
+        astal_wp_wp_notify_collection(self, G_OBJECT(self), "clients");
+    } else if (WP_IS_METADATA(object)) {
+        WpProperties *props = wp_global_proxy_get_global_properties(WP_GLOBAL_PROXY(object));
+        const gchar *name = props != NULL ? wp_properties_get(props, "metadata.name") : NULL;
+
+        if (g_strcmp0(name, "default") == 0) {
+            g_clear_object(&priv->default_metadata);
+            priv->default_metadata = g_object_ref(WP_METADATA(object));
+            priv->default_metadata_signal_handler_id =
+                g_signal_connect_swapped(priv->default_metadata, "changed",
+                                         G_CALLBACK(astal_wp_wp_default_metadata_changed), self);
+
+            GHashTableIter iter;
+            gpointer key, value;
+
+            g_hash_table_iter_init(&iter, priv->endpoints);
+            while (g_hash_table_iter_next(&iter, &key, &value)) {
+                astal_wp_wp_sync_endpoint_target(self, value);
+            }
+        } else if (g_strcmp0(name, "settings") == 0) {
+            g_clear_object(&priv->settings_metadata);
+            priv->settings_metadata = g_object_ref(WP_METADATA(object));
+            priv->settings_metadata_signal_handler_id =
+                g_signal_connect_swapped(priv->settings_metadata, "changed",
+                                         G_CALLBACK(astal_wp_wp_settings_metadata_changed), self);
+
+            const gchar *keys[] = {"clock.force-quantum", "clock.force-rate",
+                                   "clock.allowed-rates"};
+            for (guint i = 0; i < G_N_ELEMENTS(keys); i++) {
+                astal_wp_wp_update_setting(
+                    self, keys[i], wp_metadata_find(priv->settings_metadata, 0, keys[i], NULL));
+            }
+        }
+
+        if (props != NULL) wp_properties_unref(props);
+    }
+}
+
+static void astal_wp_wp_object_removed(AstalWpWp *self, gpointer object) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    astal_wp_wp_sync_lazy_streams(self);
+
+    if (WP_IS_NODE(object)) {
+        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
+        if (priv->recording != NULL)
+            astal_wp_journal_input(priv->recording, ASTAL_WP_JOURNAL_PW_NODE_REMOVED,
+                                   g_variant_new_uint32(id));
+        astal_wp_wp_node_removed(self, id);
+    } else if (WP_IS_DEVICE(object)) {
+        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
+        if (priv->recording != NULL)
+            astal_wp_journal_input(priv->recording, ASTAL_WP_JOURNAL_PW_DEVICE_REMOVED,
+                                   g_variant_new_uint32(id));
+        astal_wp_wp_remove_device(self, id);
+    } else if (WP_IS_LINK(object)) {
+        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
+        AstalWpLink *link = g_hash_table_lookup(priv->links, GUINT_TO_POINTER(id));
+        if (link == NULL) return;
+
+        g_object_ref(link);
+        astal_wp_wp_link_removed(self, link);
+        g_hash_table_remove(priv->links, GUINT_TO_POINTER(id));
+
+        g_signal_emit_by_name(self, "link-removed", link);
+        g_object_unref(link);
+    } else if (WP_IS_PORT(object)) {
+        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
+        AstalWpPort *port = g_hash_table_lookup(priv->ports, GUINT_TO_POINTER(id));
+        if (port == NULL) return;
+
+        g_object_ref(port);
+        guint node_id = astal_wp_port_get_node_id(port);
+        AstalWpNodeAdjacency *adj =
+            g_hash_table_lookup(priv->adjacency, GUINT_TO_POINTER(node_id));
+        if (adj != NULL) {
+            g_ptr_array_remove_fast(adj->ports, port);
+            astal_wp_wp_release_adjacency(self, node_id, adj);
+        }
+        g_hash_table_remove(priv->ports, GUINT_TO_POINTER(id));
+
+        g_signal_emit_by_name(self, "port-removed", port);
+        g_object_unref(port);
+    } else if (WP_IS_CLIENT(object)) {
+        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
+        AstalWpClient *client = g_hash_table_lookup(priv->clients, GUINT_TO_POINTER(id));
+        if (client == NULL) return;
+
+        astal_wp_wp_batch(self);
+        g_object_ref(client);
+        g_hash_table_remove(priv->clients, GUINT_TO_POINTER(id));
+
+        g_signal_emit_by_name(self, "client-removed", client);
+        astal_wp_wp_notify_collection(self, G_OBJECT(self), "clients");
+        g_object_unref(client);
+    } else if (WP_IS_METADATA(object)) {
+        if (WP_METADATA(object) == priv->default_metadata) {
+            g_signal_handler_disconnect(priv->default_metadata,
+                                        priv->default_metadata_signal_handler_id);
+            g_clear_object(&priv->default_metadata);
+        } else if (WP_METADATA(object) == priv->settings_metadata) {
+            g_signal_handler_disconnect(priv->settings_metadata,
+                                        priv->settings_metadata_signal_handler_id);
+            g_clear_object(&priv->settings_metadata);
+        }
+    }
+}
+
+void astal_wp_wp_remote_command(AstalWpWp *self, const gchar *method, GVariant *args) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (priv->worker != NULL) {
+        astal_wp_worker_call(priv->worker, method, args);
+        return;
+    }
+    if (priv->mirror == NULL) {
+        g_variant_unref(g_variant_ref_sink(args));
+        return;
+    }
+    astal_wp_mirror_call(priv->mirror, method, args);
+}
+
+static void astal_wp_wp_mirror_sync_default(AstalWpWp *self, AstalWpEndpoint *endpoint,
+                                            guint id) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpEndpoint *target = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id));
+    if (target == NULL) return;
+
+    GVariant *state = g_variant_ref_sink(astal_wp_endpoint_serialize(target));
+    astal_wp_endpoint_apply(endpoint, state);
+    g_variant_unref(state);
+}
+
+void astal_wp_wp_mirror_defaults(AstalWpWp *self, GVariant *state) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (g_variant_lookup(state, "DefaultSpeaker", "u", &priv->mirror_default_speaker))
+        astal_wp_wp_mirror_sync_default(self, self->default_speaker,
+                                        priv->mirror_default_speaker);
+    if (g_variant_lookup(state, "DefaultMicrophone", "u", &priv->mirror_default_microphone))
+        astal_wp_wp_mirror_sync_default(self, self->default_microphone,
+                                        priv->mirror_default_microphone);
+}
+
+void astal_wp_wp_mirror_endpoint(AstalWpWp *self, GVariant *state) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint id;
+    if (!g_variant_lookup(state, "Id", "u", &id)) return;
+
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id));
+    if (endpoint != NULL) {
+        astal_wp_wp_mirror_endpoint_changed(self, id, state);
+        return;
+    }
+
+    endpoint = astal_wp_endpoint_init_remote(g_object_new(ASTAL_WP_TYPE_ENDPOINT, NULL), self,
+                                             FALSE);
+    astal_wp_endpoint_apply(endpoint, state);
+    astal_wp_wp_add_endpoint(self, endpoint);
+
+    if (id == priv->mirror_default_speaker)
+        astal_wp_wp_mirror_sync_default(self, self->default_speaker, id);
+    if (id == priv->mirror_default_microphone)
+        astal_wp_wp_mirror_sync_default(self, self->default_microphone, id);
+}
+
+void astal_wp_wp_mirror_endpoint_removed(AstalWpWp *self, guint id) {
+    astal_wp_wp_remove_endpoint(self, id);
+}
+
+void astal_wp_wp_mirror_endpoint_changed(AstalWpWp *self, guint id, GVariant *changed) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id));
+    if (endpoint == NULL) return;
+
+    astal_wp_endpoint_apply(endpoint, changed);
+
+    if (id == priv->mirror_default_speaker) astal_wp_endpoint_apply(self->default_speaker, changed);
+    if (id == priv->mirror_default_microphone)
+        astal_wp_endpoint_apply(self->default_microphone, changed);
+}
+
+void astal_wp_wp_mirror_device(AstalWpWp *self, GVariant *state) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    guint id;
+    if (!g_variant_lookup(state, "Id", "u", &id)) return;
+
+    AstalWpDevice *device = g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id));
+    if (device != NULL) {
+        astal_wp_device_apply(device, state);
+        return;
+    }
+
+    astal_wp_wp_add_device(self, astal_wp_device_create_remote(self, state));
+}
+
+void astal_wp_wp_mirror_device_removed(AstalWpWp *self, guint id) {
+    astal_wp_wp_remove_device(self, id);
+}
+
+void astal_wp_wp_mirror_device_changed(AstalWpWp *self, guint id, GVariant *changed) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    AstalWpDevice *device = g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id));
+    if (device != NULL) astal_wp_device_apply(device, changed);
+}
+
+static gboolean astal_wp_wp_state_contains(GVariant *states, guint id) {
+    GVariantIter iter;
+    GVariant *state;
+    guint state_id;
+
+    g_variant_iter_init(&iter, states);
+    while ((state = g_variant_iter_next_value(&iter)) != NULL) {
+        gboolean found = g_variant_lookup(state, "Id", "u", &state_id) && state_id == id;
+        g_variant_unref(state);
+        if (found) return TRUE;
+    }
+    return FALSE;
+}
+
+// replaces the mirrored state with a complete snapshot of the service
+void astal_wp_wp_mirror_state(AstalWpWp *self, GVariant *defaults, GVariant *endpoints,
+                              GVariant *devices) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    GList *stale = g_hash_table_get_keys(priv->endpoints);
+    for (GList *l = stale; l != NULL; l = l->next) {
+        if (!astal_wp_wp_state_contains(endpoints, GPOINTER_TO_UINT(l->data)))
+            astal_wp_wp_remove_endpoint(self, GPOINTER_TO_UINT(l->data));
+    }
+    g_list_free(stale);
+
+    stale = g_hash_table_get_keys(priv->devices);
+    for (GList *l = stale; l != NULL; l = l->next) {
+        if (!astal_wp_wp_state_contains(devices, GPOINTER_TO_UINT(l->data)))
+            astal_wp_wp_remove_device(self, GPOINTER_TO_UINT(l->data));
+    }
+    g_list_free(stale);
+
+    GVariantIter iter;
+    GVariant *state;
+
+    g_variant_iter_init(&iter, devices);
+    while ((state = g_variant_iter_next_value(&iter)) != NULL) {
+        astal_wp_wp_mirror_device(self, state);
+        g_variant_unref(state);
+    }
+
+    g_variant_iter_init(&iter, endpoints);
+    while ((state = g_variant_iter_next_value(&iter)) != NULL) {
+        astal_wp_wp_mirror_endpoint(self, state);
+        g_variant_unref(state);
+    }
+
+    astal_wp_wp_mirror_defaults(self, defaults);
+
+    astal_wp_wp_batch_end(self);
+    g_signal_emit(self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_READY], 0);
+}
+
+// drops every mirrored object, used when the service went away
+void astal_wp_wp_mirror_clear(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    GList *ids = g_hash_table_get_keys(priv->endpoints);
+    for (GList *l = ids; l != NULL; l = l->next)
+        astal_wp_wp_remove_endpoint(self, GPOINTER_TO_UINT(l->data));
+    g_list_free(ids);
+
+    ids = g_hash_table_get_keys(priv->devices);
+    for (GList *l = ids; l != NULL; l = l->next)
+        astal_wp_wp_remove_device(self, GPOINTER_TO_UINT(l->data));
+    g_list_free(ids);
+
+    priv->mirror_default_speaker = 0;
+    priv->mirror_default_microphone = 0;
+}
+
+/**
+ * astal_wp_wp_get_backend
+ *
+ * Returns: how this instance obtains its state
+ */
+AstalWpBackend astal_wp_wp_get_backend(AstalWpWp *self) { return self->backend; }
+
+/**
+ * astal_wp_wp_export:
+ * @self: the AstalWpWp object
+ *
+ * Exports endpoints, devices and the defaults of this instance on the session bus, so other
+ * processes can mirror them using ASTAL_WP_BACKEND_DBUS instead of connecting to PipeWire
+ * themselves. Property changes made within one main loop iteration are sent as one
+ * PropertiesChanged signal per object.
+ */
+void astal_wp_wp_export(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (self->backend != ASTAL_WP_BACKEND_PIPEWIRE) {
+        g_warning("only an instance connected to PipeWire can be exported");
+        return;
+    }
+    if (priv->service != NULL) return;
+
+    // the connection and its signal subscriptions dispatch in the thread-default context
+    g_main_context_push_thread_default(priv->context);
+    priv->service = astal_wp_service_new(self);
+    g_main_context_pop_thread_default(priv->context);
+}
+
+/**
+ * astal_wp_wp_start_recording:
+ * @self: the AstalWpWp object
+ * @path: the file to write the journal to
+ * @error: return location for a GError
+ *
+ * Records what PipeWire reports into a binary journal, starting with a snapshot of the current
+ * state: the properties of the nodes and devices that are added, removed or change, the params
+ * of the devices and the volumes and default nodes the mixer and default nodes plugins report.
+ * Links, ports, clients and metadata are not recorded. The journal can be fed back through the
+ * same handlers with astal_wp_wp_new_for_journal.
+ *
+ * Only instances of ASTAL_WP_BACKEND_PIPEWIRE can be recorded.
+ *
+ * Returns: whether the journal could be created
+ */
+gboolean astal_wp_wp_start_recording(AstalWpWp *self, const gchar *path, GError **error) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    GHashTableIter iter;
+    gpointer key, value;
+
+    if (self->backend != ASTAL_WP_BACKEND_PIPEWIRE) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                    "only an instance connected to PipeWire can be recorded");
+        return FALSE;
+    }
+
+    AstalWpJournal *journal = astal_wp_journal_new(self, path, error);
+    if (journal == NULL) return FALSE;
+
+    g_clear_pointer(&priv->recording, astal_wp_journal_free);
+    priv->recording = journal;
+
+    // the snapshot is ordered like the replay needs it, the default nodes and devices before the
+    // nodes which refer to them
+    if (priv->defaults != NULL) {
+        GEnumClass *enum_class = g_type_class_ref(ASTAL_WP_TYPE_MEDIA_CLASS);
+        for (guint i = 0; i < enum_class->n_values; i++) {
+            const gchar *media_class = enum_class->values[i].value_nick;
+            guint id;
+            g_signal_emit_by_name(priv->defaults, "get-default-node", media_class, &id);
+            astal_wp_journal_input(journal, ASTAL_WP_JOURNAL_DEFAULT_NODE,
+                                   g_variant_new("(su)", media_class, id));
+        }
+        g_type_class_unref(enum_class);
+    }
+    astal_wp_journal_flush(journal);
+
+    g_hash_table_iter_init(&iter, priv->devices);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) astal_wp_device_record(value);
+    astal_wp_journal_flush(journal);
+
+    g_hash_table_iter_init(&iter, priv->endpoints);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        WpProperties *properties = astal_wp_endpoint_get_node_properties(value);
+        astal_wp_wp_record_volume(self, GPOINTER_TO_UINT(key));
+        astal_wp_journal_input(journal, ASTAL_WP_JOURNAL_PW_NODE_ADDED,
+                               astal_wp_journal_properties(GPOINTER_TO_UINT(key), properties));
+    }
+    g_hash_table_iter_init(&iter, priv->pending_streams);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        AstalWpDeferredStream *stream = value;
+        astal_wp_wp_record_volume(self, GPOINTER_TO_UINT(key));
+        astal_wp_journal_input(journal, ASTAL_WP_JOURNAL_PW_NODE_ADDED,
+                               astal_wp_journal_properties(GPOINTER_TO_UINT(key),
+                                                           stream->properties));
+    }
+
+    if (!priv->hold_batch) {
+        astal_wp_journal_flush(journal);
+        astal_wp_journal_input(journal, ASTAL_WP_JOURNAL_INSTALLED, g_variant_new("()"));
+    }
+    return TRUE;
+}
+
+/**
+ * astal_wp_wp_stop_recording:
+ * @self: the AstalWpWp object
+ *
+ * Stops the recording started with astal_wp_wp_start_recording and closes the journal.
  */
-AstalWpEndpoint *astal_wp_wp_get_default_microphone(AstalWpWp *self) {
-    return self->default_microphone;
+void astal_wp_wp_stop_recording(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    g_clear_pointer(&priv->recording, astal_wp_journal_free);
 }
 
-AstalWpScale astal_wp_wp_get_scale(AstalWpWp *self) { return self->scale; }
+gboolean astal_wp_wp_is_recording(AstalWpWp *self) {
+    if (self == NULL) return FALSE;
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    return priv->recording != NULL;
+}
 
-void astal_wp_wp_set_scale(AstalWpWp *self, AstalWpScale scale) {
+void astal_wp_wp_record_input(AstalWpWp *self, AstalWpJournalRecordType type, GVariant *value) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
-    self->scale = scale;
 
-    if (priv->mixer == NULL) return;
+    if (priv->recording != NULL)
+        astal_wp_journal_input(priv->recording, type, value);
+    else
+        g_variant_unref(g_variant_ref_sink(value));
+}
 
-    g_object_set(priv->mixer, "scale", self->scale, NULL);
+static void astal_wp_wp_objm_installed(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
-    GHashTableIter iter;
-    gpointer key, value;
+    astal_wp_endpoint_init_as_default(self->default_speaker, priv->mixer, priv->defaults,
+                                      ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER, self);
+    astal_wp_endpoint_init_as_default(self->default_microphone, priv->mixer, priv->defaults,
+                                      ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE, self);
 
-    g_hash_table_iter_init(&iter, priv->endpoints);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        AstalWpEndpoint *ep = ASTAL_WP_ENDPOINT(value);
-        astal_wp_endpoint_update_volume(ep);
+    // opens the initial batch if no object did, so ready always follows a batch-begin and end
+    astal_wp_wp_batch(self);
+    priv->hold_batch = FALSE;
+    astal_wp_wp_batch_end(self);
+
+    // everything journaled so far is the initial state
+    if (priv->recording != NULL) {
+        astal_wp_journal_flush(priv->recording);
+        astal_wp_journal_input(priv->recording, ASTAL_WP_JOURNAL_INSTALLED, g_variant_new("()"));
     }
 
-    astal_wp_endpoint_update_volume(self->default_speaker);
-    astal_wp_endpoint_update_volume(self->default_microphone);
+    g_signal_emit(self, astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_READY], 0);
 }
 
-static void astal_wp_wp_get_property(GObject *object, guint property_id, GValue *value,
-                                     GParamSpec *pspec) {
-    AstalWpWp *self = ASTAL_WP_WP(object);
+// the endpoints connect to the plugins later, so the event handlers run first and last
+static void astal_wp_wp_connect_plugins(AstalWpWp *self) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
-    switch (property_id) {
-        case ASTAL_WP_WP_PROP_AUDIO:
-            g_value_set_object(value, astal_wp_wp_get_audio(self));
-            break;
-        case ASTAL_WP_WP_PROP_VIDEO:
-            g_value_set_object(value, astal_wp_wp_get_video(self));
-            break;
-        case ASTAL_WP_WP_PROP_ENDPOINTS:
-            g_value_set_pointer(value, g_hash_table_get_values(priv->endpoints));
-            break;
-        case ASTAL_WP_WP_PROP_DEVICES:
-            g_value_set_pointer(value, g_hash_table_get_values(priv->devices));
-            break;
-        case ASTAL_WP_WP_PROP_DEFAULT_SPEAKER:
-            g_value_set_object(value, self->default_speaker);
-            break;
-        case ASTAL_WP_WP_PROP_DEFAULT_MICROPHONE:
-            g_value_set_object(value, self->default_microphone);
-            break;
-        case ASTAL_WP_WP_PROP_SCALE:
-            g_value_set_enum(value, self->scale);
-            break;
-        default:
-            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
-            break;
+    if (priv->defaults != NULL) {
+        g_signal_connect_swapped(priv->defaults, "changed",
+                                 G_CALLBACK(astal_wp_wp_default_event_begin), self);
+        g_signal_connect_data(priv->defaults, "changed", G_CALLBACK(astal_wp_wp_default_event_end),
+                              self, NULL, G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+    }
+
+    if (priv->mixer != NULL) {
+        g_signal_connect_swapped(priv->mixer, "changed",
+                                 G_CALLBACK(astal_wp_wp_mixer_event_begin), self);
+        g_signal_connect_data(priv->mixer, "changed", G_CALLBACK(astal_wp_wp_mixer_event_end),
+                              self, NULL, G_CONNECT_SWAPPED | G_CONNECT_AFTER);
     }
 }
 
-static void astal_wp_wp_set_property(GObject *object, guint property_id, const GValue *value,
-                                     GParamSpec *pspec) {
-    AstalWpWp *self = ASTAL_WP_WP(object);
+// installs the object manager once the plugins of the selected subsystems are active
+static void astal_wp_wp_install(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
-    switch (property_id) {
-        case ASTAL_WP_WP_PROP_SCALE:
-            astal_wp_wp_set_scale(self, g_value_get_enum(value));
-            break;
-        default:
-            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
-            break;
+    if (self->subsystems & ASTAL_WP_SUBSYSTEM_DEFAULTS)
+        priv->defaults = wp_plugin_find(priv->core, "default-nodes-api");
+
+    if (self->subsystems & ASTAL_WP_SUBSYSTEM_MIXER) {
+        priv->mixer = wp_plugin_find(priv->core, "mixer-api");
+        // volumes are converted to the requested scale by the endpoints themselves
+        if (priv->mixer != NULL) g_object_set(priv->mixer, "scale", ASTAL_WP_SCALE_LINEAR, NULL);
     }
-}
 
-static void astal_wp_wp_object_added(AstalWpWp *self, gpointer object) {
-    // print pipewire properties
-    // WpIterator *iter = wp_pipewire_object_new_properties_iterator(WP_PIPEWIRE_OBJECT(object));
-    // GValue item = G_VALUE_INIT;
-    // const gchar *key, *value;
-    //
-    // g_print("\n\n");
-    // while (wp_iterator_next (iter, &item)) {
-    //     WpPropertiesItem *pi = g_value_get_boxed (&item);
-    //     key = wp_properties_item_get_key (pi);
-    //     value = wp_properties_item_get_value (pi);
-    //     g_print("%s: %s\n", key, value);
-    //     g_value_unset(&item);
-    // }
+    astal_wp_wp_connect_plugins(self);
+
+    g_signal_connect_swapped(priv->obj_manager, "object-added",
+                             G_CALLBACK(astal_wp_wp_object_event_begin), self);
+    g_signal_connect_swapped(priv->obj_manager, "object-added",
+                             G_CALLBACK(astal_wp_wp_object_added), self);
+    g_signal_connect_data(priv->obj_manager, "object-added",
+                          G_CALLBACK(astal_wp_wp_object_event_end), self, NULL,
+                          G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+    g_signal_connect_swapped(priv->obj_manager, "object-removed",
+                             G_CALLBACK(astal_wp_wp_object_event_begin), self);
+    g_signal_connect_swapped(priv->obj_manager, "object-removed",
+                             G_CALLBACK(astal_wp_wp_object_removed), self);
+    g_signal_connect_data(priv->obj_manager, "object-removed",
+                          G_CALLBACK(astal_wp_wp_object_event_end), self, NULL,
+                          G_CONNECT_SWAPPED | G_CONNECT_AFTER);
+
+    wp_core_install_object_manager(priv->core, priv->obj_manager);
+}
 
+void astal_wp_wp_replay_begin(AstalWpWp *self, WpPlugin *mixer, WpPlugin *defaults) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
-    if (WP_IS_NODE(object)) {
-        WpNode *node = WP_NODE(object);
-        AstalWpEndpoint *endpoint =
-            astal_wp_endpoint_create(node, priv->mixer, priv->defaults, self);
+    if (self->subsystems & ASTAL_WP_SUBSYSTEM_DEFAULTS) priv->defaults = g_object_ref(defaults);
+    if (self->subsystems & ASTAL_WP_SUBSYSTEM_MIXER) priv->mixer = g_object_ref(mixer);
+    astal_wp_wp_connect_plugins(self);
+}
 
-        g_hash_table_insert(priv->endpoints,
-                            GUINT_TO_POINTER(wp_proxy_get_bound_id(WP_PROXY(node))), endpoint);
+void astal_wp_wp_replay_installed(AstalWpWp *self) { astal_wp_wp_objm_installed(self); }
 
-        g_signal_emit_by_name(self, "endpoint-added", endpoint);
-        g_object_notify(G_OBJECT(self), "endpoints");
-    } else if (WP_IS_DEVICE(object)) {
-        WpDevice *node = WP_DEVICE(object);
-        AstalWpDevice *device = astal_wp_device_create(node);
-        g_hash_table_insert(priv->devices, GUINT_TO_POINTER(wp_proxy_get_bound_id(WP_PROXY(node))),
-                            device);
-        g_signal_emit_by_name(self, "device-added", device);
-        g_object_notify(G_OBJECT(self), "devices");
-    }
+void astal_wp_wp_replay_node_added(AstalWpWp *self, guint id, WpProperties *properties) {
+    astal_wp_wp_object_event_begin(self);
+    astal_wp_wp_sync_lazy_streams(self);
+    astal_wp_wp_node_added(self, id, NULL, properties);
+    astal_wp_wp_object_event_end(self);
 }
 
-static void astal_wp_wp_object_removed(AstalWpWp *self, gpointer object) {
+void astal_wp_wp_replay_node_removed(AstalWpWp *self, guint id) {
+    astal_wp_wp_object_event_begin(self);
+    astal_wp_wp_sync_lazy_streams(self);
+    astal_wp_wp_node_removed(self, id);
+    astal_wp_wp_object_event_end(self);
+}
+
+void astal_wp_wp_replay_node_properties(AstalWpWp *self, guint id, WpProperties *properties) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
-    if (WP_IS_NODE(object)) {
-        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
-        AstalWpEndpoint *endpoint =
-            g_object_ref(g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id)));
+    AstalWpDeferredStream *stream = g_hash_table_lookup(priv->pending_streams,
+                                                        GUINT_TO_POINTER(id));
+    if (stream != NULL) {
+        wp_properties_unref(stream->properties);
+        stream->properties = wp_properties_ref(properties);
+        return;
+    }
 
-        g_hash_table_remove(priv->endpoints, GUINT_TO_POINTER(id));
+    AstalWpEndpoint *endpoint = g_hash_table_lookup(priv->endpoints, GUINT_TO_POINTER(id));
+    if (endpoint != NULL) astal_wp_endpoint_set_properties(endpoint, properties);
+}
 
-        g_signal_emit_by_name(self, "endpoint-removed", endpoint);
-        g_object_notify(G_OBJECT(self), "endpoints");
-        g_object_unref(endpoint);
-    } else if (WP_IS_DEVICE(object)) {
-        guint id = wp_proxy_get_bound_id(WP_PROXY(object));
-        AstalWpDevice *device =
-            g_object_ref(g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id)));
-        g_hash_table_remove(priv->devices, GUINT_TO_POINTER(id));
+void astal_wp_wp_replay_device_added(AstalWpWp *self, guint id, WpProperties *properties) {
+    astal_wp_wp_object_event_begin(self);
+    astal_wp_wp_sync_lazy_streams(self);
+    astal_wp_wp_add_device(self, astal_wp_device_create(id, NULL, properties, self));
+    astal_wp_wp_object_event_end(self);
+}
 
-        g_signal_emit_by_name(self, "device-removed", device);
-        g_object_notify(G_OBJECT(self), "devices");
-        g_object_unref(device);
-    }
+void astal_wp_wp_replay_device_removed(AstalWpWp *self, guint id) {
+    astal_wp_wp_object_event_begin(self);
+    astal_wp_wp_sync_lazy_streams(self);
+    astal_wp_wp_remove_device(self, id);
+    astal_wp_wp_object_event_end(self);
 }
 
-static void astal_wp_wp_objm_installed(AstalWpWp *self) {
+void astal_wp_wp_replay_device_params(AstalWpWp *self, guint id, const gchar *name,
+                                      GPtrArray *pods) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
-    astal_wp_endpoint_init_as_default(self->default_speaker, priv->mixer, priv->defaults,
-                                      ASTAL_WP_MEDIA_CLASS_AUDIO_SPEAKER, self);
-    astal_wp_endpoint_init_as_default(self->default_microphone, priv->mixer, priv->defaults,
-                                      ASTAL_WP_MEDIA_CLASS_AUDIO_MICROPHONE, self);
+    AstalWpDevice *device = g_hash_table_lookup(priv->devices, GUINT_TO_POINTER(id));
+    if (device != NULL)
+        astal_wp_device_replay_params(device, name, pods);
+    else
+        g_ptr_array_unref(pods);
 }
 
 static void astal_wp_wp_plugin_activated(WpObject *obj, GAsyncResult *result, AstalWpWp *self) {
@@ -298,18 +2308,7 @@ static void astal_wp_wp_plugin_activated(WpObject *obj, GAsyncResult *result, As
         return;
     }
 
-    if (--priv->pending_plugins == 0) {
-        priv->defaults = wp_plugin_find(priv->core, "default-nodes-api");
-        priv->mixer = wp_plugin_find(priv->core, "mixer-api");
-        g_object_set(priv->mixer, "scale", self->scale, NULL);
-
-        g_signal_connect_swapped(priv->obj_manager, "object-added",
-                                 G_CALLBACK(astal_wp_wp_object_added), self);
-        g_signal_connect_swapped(priv->obj_manager, "object-removed",
-                                 G_CALLBACK(astal_wp_wp_object_removed), self);
-
-        wp_core_install_object_manager(priv->core, priv->obj_manager);
-    }
+    if (--priv->pending_plugins == 0) astal_wp_wp_install(self);
 }
 
 static void astal_wp_wp_plugin_loaded(WpObject *obj, GAsyncResult *result, AstalWpWp *self) {
@@ -326,19 +2325,127 @@ static void astal_wp_wp_plugin_loaded(WpObject *obj, GAsyncResult *result, Astal
                        (GAsyncReadyCallback)astal_wp_wp_plugin_activated, self);
 }
 
+// parses a comma separated list of AstalWpSubsystems nicks, like "audio-endpoints,mixer"
+static AstalWpSubsystems astal_wp_wp_parse_subsystems(const gchar *list) {
+    if (list == NULL) return ASTAL_WP_SUBSYSTEM_ALL;
+
+    GFlagsClass *flags_class = g_type_class_ref(ASTAL_WP_TYPE_SUBSYSTEMS);
+    AstalWpSubsystems subsystems = ASTAL_WP_SUBSYSTEM_NONE;
+    gchar **names = g_strsplit(list, ",", -1);
+
+    for (gchar **name = names; *name != NULL; name++) {
+        GFlagsValue *value = g_flags_get_value_by_nick(flags_class, g_strstrip(*name));
+        if (value != NULL)
+            subsystems |= value->value;
+        else
+            g_warning("unknown subsystem %s", *name);
+    }
+
+    g_strfreev(names);
+    g_type_class_unref(flags_class);
+    return subsystems;
+}
+
 /**
  * astal_wp_wp_get_default
  *
+ * The default instance is created on the first call and configured from the environment, so
+ * every consumer of a session can be switched without code changes:
+ *
+ * - `ASTAL_WP_BACKEND`: `dbus` or `threaded` selects AstalWpWp:backend, anything else connects to
+ *   PipeWire directly
+ * - `ASTAL_WP_LAZY_STREAMS`: `1` enables AstalWpWp:lazy-streams
+ * - `ASTAL_WP_OPTIMISTIC`: `1` enables AstalWpWp:optimistic
+ * - `ASTAL_WP_SUBSYSTEMS`: a comma separated list of AstalWpSubsystems nicks, like
+ *   `audio-endpoints,mixer`, selects AstalWpWp:subsystems. Every subsystem is set up if it is
+ *   unset
+ *
+ * Instances which do not depend on the environment are constructed with g_object_new and these
+ * properties.
+ *
  * Returns: (nullable) (transfer none): gets the default wireplumber object.
  */
 AstalWpWp *astal_wp_wp_get_default() {
     static AstalWpWp *self = NULL;
 
-    if (self == NULL) self = g_object_new(ASTAL_WP_TYPE_WP, NULL);
+    if (self == NULL) {
+        const gchar *env = g_getenv("ASTAL_WP_BACKEND");
+        AstalWpBackend backend = ASTAL_WP_BACKEND_PIPEWIRE;
+        if (g_strcmp0(env, "dbus") == 0)
+            backend = ASTAL_WP_BACKEND_DBUS;
+        else if (g_strcmp0(env, "threaded") == 0)
+            backend = ASTAL_WP_BACKEND_THREADED;
+        self = g_object_new(ASTAL_WP_TYPE_WP, "backend", backend, "lazy-streams",
+                            g_strcmp0(g_getenv("ASTAL_WP_LAZY_STREAMS"), "1") == 0, "optimistic",
+                            g_strcmp0(g_getenv("ASTAL_WP_OPTIMISTIC"), "1") == 0, "subsystems",
+                            astal_wp_wp_parse_subsystems(g_getenv("ASTAL_WP_SUBSYSTEMS")), NULL);
+    }
 
     return self;
 }
 
+/**
+ * astal_wp_wp_new
+ * @backend: how the new instance obtains its state
+ *
+ * Returns: (transfer full): a new wireplumber object
+ */
+AstalWpWp *astal_wp_wp_new(AstalWpBackend backend) {
+    return g_object_new(ASTAL_WP_TYPE_WP, "backend", backend, NULL);
+}
+
+/**
+ * astal_wp_wp_new_for_journal
+ * @path: a journal written by astal_wp_wp_start_recording
+ * @speed: the factor the recorded timing is scaled by, 0 replays as fast as possible
+ *
+ * Creates an instance which replays a recorded journal instead of connecting to PipeWire. Every
+ * recorded input is fed through the same handlers as in ASTAL_WP_BACKEND_PIPEWIRE, one per main
+ * loop iteration, with the mixer and default nodes plugins answering from the journal. Setters
+ * have no effect. Once the journal is exhausted the replay-finished signal is emitted.
+ *
+ * Returns: (transfer full): a new wireplumber object
+ */
+AstalWpWp *astal_wp_wp_new_for_journal(const gchar *path, gdouble speed) {
+    return g_object_new(ASTAL_WP_TYPE_WP, "backend", ASTAL_WP_BACKEND_REPLAY, "journal", path,
+                        "replay-speed", speed, NULL);
+}
+
+/**
+ * astal_wp_wp_new_for_remote
+ * @remote: (nullable): the name of a PipeWire remote or the absolute path of its socket, NULL for
+ * the default remote
+ * @context: (nullable): the main context to dispatch in, NULL for the global default context
+ *
+ * Creates an instance connected to another PipeWire daemon than the default one, for example of
+ * a nested session or a container. Every instance has its own core, objects and sources, only the
+ * one-time initialization of WirePlumber is shared between them. When @context is given, it has
+ * to be iterated while it is the thread-default context of the thread iterating it, signals and
+ * notifications of this instance are emitted from there.
+ *
+ * Returns: (transfer full): a new wireplumber object
+ */
+AstalWpWp *astal_wp_wp_new_for_remote(const gchar *remote, GMainContext *context) {
+    return g_object_new(ASTAL_WP_TYPE_WP, "backend", ASTAL_WP_BACKEND_PIPEWIRE, "remote", remote,
+                        "main-context", context, NULL);
+}
+
+/**
+ * astal_wp_wp_new_for_subsystems
+ * @subsystems: the parts of the graph to track
+ *
+ * Creates an instance connected to PipeWire which only tracks @subsystems, see
+ * AstalWpWp:subsystems. A camera indicator for example only needs ASTAL_WP_SUBSYSTEM_VIDEO and a
+ * volume indicator ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS, ASTAL_WP_SUBSYSTEM_MIXER and
+ * ASTAL_WP_SUBSYSTEM_DEFAULTS.
+ *
+ * Returns: (transfer full): a new wireplumber object
+ */
+AstalWpWp *astal_wp_wp_new_for_subsystems(AstalWpSubsystems subsystems) {
+    return g_object_new(ASTAL_WP_TYPE_WP, "backend", ASTAL_WP_BACKEND_PIPEWIRE, "subsystems",
+                        subsystems, NULL);
+}
+
 /**
  * astal_wp_get_default_wp
  *
@@ -350,14 +2457,37 @@ static void astal_wp_wp_dispose(GObject *object) {
     AstalWpWp *self = ASTAL_WP_WP(object);
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
+    astal_wp_wp_clear_source(self, &priv->batch_id);
+    g_array_set_size(priv->pending_notifies, 0);
+    g_clear_pointer(&priv->ramps, astal_wp_ramps_free);
     g_clear_object(&self->video);
     g_clear_object(&self->audio);
 
-    wp_core_disconnect(priv->core);
+    g_clear_pointer(&priv->service, astal_wp_service_free);
+    g_clear_pointer(&priv->mirror, astal_wp_mirror_free);
+    g_clear_pointer(&priv->state_table, astal_wp_state_table_writer_free);
+    g_clear_pointer(&priv->recording, astal_wp_journal_free);
+    g_clear_pointer(&priv->replay, astal_wp_replay_free);
+    g_clear_pointer(&priv->worker, astal_wp_worker_free);
+
+    // the profiler holds raw PipeWire proxies which die with the connection
+    g_clear_pointer(&priv->profiler, astal_wp_profiler_free);
+    if (priv->core != NULL) wp_core_disconnect(priv->core);
     g_clear_object(&self->default_speaker);
     g_clear_object(&self->default_microphone);
+    // the plugins belong to the core, which may outlive this instance
+    if (priv->mixer != NULL) g_signal_handlers_disconnect_by_data(priv->mixer, self);
+    if (priv->defaults != NULL) g_signal_handlers_disconnect_by_data(priv->defaults, self);
     g_clear_object(&priv->mixer);
     g_clear_object(&priv->defaults);
+    if (priv->default_metadata != NULL)
+        g_signal_handler_disconnect(priv->default_metadata,
+                                    priv->default_metadata_signal_handler_id);
+    g_clear_object(&priv->default_metadata);
+    if (priv->settings_metadata != NULL)
+        g_signal_handler_disconnect(priv->settings_metadata,
+                                    priv->settings_metadata_signal_handler_id);
+    g_clear_object(&priv->settings_metadata);
     g_clear_object(&priv->obj_manager);
     g_clear_object(&priv->core);
 
@@ -365,79 +2495,214 @@ static void astal_wp_wp_dispose(GObject *object) {
         g_hash_table_destroy(priv->endpoints);
         priv->endpoints = NULL;
     }
+
+    g_clear_pointer(&priv->pending_streams, g_hash_table_destroy);
+    g_clear_pointer(&priv->device_endpoints, g_hash_table_destroy);
+    g_clear_pointer(&priv->clients, g_hash_table_destroy);
+    g_clear_pointer(&priv->serials, g_hash_table_destroy);
+    g_clear_pointer(&priv->adjacency, g_hash_table_destroy);
+    g_clear_pointer(&priv->links, g_hash_table_destroy);
+    g_clear_pointer(&priv->ports, g_hash_table_destroy);
 }
 
 static void astal_wp_wp_finalize(GObject *object) {
     AstalWpWp *self = ASTAL_WP_WP(object);
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    g_free(self->allowed_rates);
+    g_free(self->journal);
+    g_free(self->remote);
+    if (priv->context != NULL) g_main_context_unref(priv->context);
+    if (priv->scale_destroy != NULL) priv->scale_destroy(priv->scale_data);
+    astal_wp_watchdog_free(priv->watchdog);
+    g_array_free(priv->pending_notifies, TRUE);
 }
 
 static void astal_wp_wp_init(AstalWpWp *self) {
     AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
 
+    priv->pending_notifies = g_array_new(FALSE, FALSE, sizeof(AstalWpPendingNotify));
     priv->endpoints = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->pending_streams = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                  (GDestroyNotify)astal_wp_deferred_stream_free);
     priv->devices = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->device_endpoints = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                   (GDestroyNotify)g_ptr_array_unref);
+    priv->links = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->ports = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->clients = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_object_unref);
+    priv->serials = g_hash_table_new(g_str_hash, g_str_equal);
+    priv->adjacency = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                            (GDestroyNotify)astal_wp_node_adjacency_free);
+
+    self->default_speaker = g_object_new(ASTAL_WP_TYPE_ENDPOINT, NULL);
+    self->default_microphone = g_object_new(ASTAL_WP_TYPE_ENDPOINT, NULL);
+    priv->ramps = astal_wp_ramps_new(self);
+    priv->watchdog = astal_wp_watchdog_new();
+}
+
+// wp_init only has to run once per process, every instance shares it
+static void astal_wp_wp_init_wireplumber(void) {
+    static gsize initialized = 0;
+
+    if (g_once_init_enter(&initialized)) {
+        wp_init(7);
+        g_once_init_leave(&initialized, 1);
+    }
+}
+
+static void astal_wp_wp_add_node_interest(AstalWpWp *self, const gchar *media_class) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
+                                   "media.class", "=s", media_class, NULL);
+}
+
+static void astal_wp_wp_connect_pipewire(AstalWpWp *self) {
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    astal_wp_wp_init_wireplumber();
 
-    wp_init(7);
-    priv->core = wp_core_new(NULL, NULL, NULL);
+    // remote.name also accepts the absolute path of a socket
+    WpProperties *props = NULL;
+    if (self->remote != NULL) props = wp_properties_new("remote.name", self->remote, NULL);
+    priv->core = wp_core_new(priv->context, NULL, props);
 
-    if (!wp_core_connect(priv->core)) {
-        g_critical("could not connect to PipeWire\n");
+    gint64 start = g_get_monotonic_time();
+    gboolean connected = wp_core_connect(priv->core);
+    ASTAL_WP_WP_REPORT_CALL(self, "wp_core_connect", 0, start);
+
+    if (!connected) {
+        g_critical("could not connect to PipeWire remote %s\n",
+                   self->remote != NULL ? self->remote : "(default)");
         return;
     }
 
+    // everything that exists already is announced as one batch which ends with ready, it is
+    // opened by the first object or by installed so nobody misses its batch-begin
+    priv->hold_batch = TRUE;
+
     priv->obj_manager = wp_object_manager_new();
     wp_object_manager_request_object_features(priv->obj_manager, WP_TYPE_NODE,
                                               WP_OBJECT_FEATURES_ALL);
     wp_object_manager_request_object_features(priv->obj_manager, WP_TYPE_GLOBAL_PROXY,
                                               WP_OBJECT_FEATURES_ALL);
 
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Audio/Sink", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Audio/Source", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Stream/Output/Audio", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Stream/Input/Audio", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_DEVICE,
-                                   WP_CONSTRAINT_TYPE_PW_GLOBAL_PROPERTY, "media.class", "=s",
-                                   "Audio/Device", NULL);
+    AstalWpSubsystems subsystems = self->subsystems;
+    gboolean audio =
+        subsystems & (ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS | ASTAL_WP_SUBSYSTEM_AUDIO_STREAMS);
 
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Video/Sink", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Video/Source", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Stream/Output/Video", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_NODE, WP_CONSTRAINT_TYPE_PW_PROPERTY,
-                                   "media.class", "=s", "Stream/Input/Video", NULL);
-    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_DEVICE,
-                                   WP_CONSTRAINT_TYPE_PW_GLOBAL_PROPERTY, "media.class", "=s",
-                                   "Video/Device", NULL);
-    // wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_CLIENT, NULL);
+    if (subsystems & ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS) {
+        astal_wp_wp_add_node_interest(self, "Audio/Sink");
+        astal_wp_wp_add_node_interest(self, "Audio/Source");
+    }
+    if (subsystems & ASTAL_WP_SUBSYSTEM_AUDIO_STREAMS) {
+        astal_wp_wp_add_node_interest(self, "Stream/Output/Audio");
+        astal_wp_wp_add_node_interest(self, "Stream/Input/Audio");
+    }
+    if (subsystems & ASTAL_WP_SUBSYSTEM_VIDEO) {
+        astal_wp_wp_add_node_interest(self, "Video/Sink");
+        astal_wp_wp_add_node_interest(self, "Video/Source");
+        astal_wp_wp_add_node_interest(self, "Stream/Output/Video");
+        astal_wp_wp_add_node_interest(self, "Stream/Input/Video");
+    }
+    if ((subsystems & ASTAL_WP_SUBSYSTEM_DEVICES) && audio)
+        wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_DEVICE,
+                                       WP_CONSTRAINT_TYPE_PW_GLOBAL_PROPERTY, "media.class", "=s",
+                                       "Audio/Device", NULL);
+    if ((subsystems & ASTAL_WP_SUBSYSTEM_DEVICES) && (subsystems & ASTAL_WP_SUBSYSTEM_VIDEO))
+        wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_DEVICE,
+                                       WP_CONSTRAINT_TYPE_PW_GLOBAL_PROPERTY, "media.class", "=s",
+                                       "Video/Device", NULL);
+    if (subsystems & ASTAL_WP_SUBSYSTEM_GRAPH) {
+        wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_CLIENT, NULL);
+        wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_LINK, NULL);
+        wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_PORT, NULL);
+    }
+    // both are single objects, stream targets and clock settings are kept regardless
+    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_METADATA,
+                                   WP_CONSTRAINT_TYPE_PW_GLOBAL_PROPERTY, "metadata.name", "=s",
+                                   "default", NULL);
+    wp_object_manager_add_interest(priv->obj_manager, WP_TYPE_METADATA,
+                                   WP_CONSTRAINT_TYPE_PW_GLOBAL_PROPERTY, "metadata.name", "=s",
+                                   "settings", NULL);
 
     g_signal_connect_swapped(priv->obj_manager, "installed", (GCallback)astal_wp_wp_objm_installed,
                              self);
 
-    self->default_speaker = g_object_new(ASTAL_WP_TYPE_ENDPOINT, NULL);
-    self->default_microphone = g_object_new(ASTAL_WP_TYPE_ENDPOINT, NULL);
+    priv->pending_plugins = 0;
+    if (subsystems & ASTAL_WP_SUBSYSTEM_DEFAULTS) priv->pending_plugins++;
+    if (subsystems & ASTAL_WP_SUBSYSTEM_MIXER) priv->pending_plugins++;
 
-    self->audio = astal_wp_audio_new(self);
-    self->video = astal_wp_video_new(self);
+    if (priv->pending_plugins == 0) {
+        astal_wp_wp_install(self);
+        return;
+    }
+
+    if (subsystems & ASTAL_WP_SUBSYSTEM_DEFAULTS)
+        wp_core_load_component(priv->core, "libwireplumber-module-default-nodes-api", "module",
+                               NULL, "default-nodes-api", NULL,
+                               (GAsyncReadyCallback)astal_wp_wp_plugin_loaded, self);
+    if (subsystems & ASTAL_WP_SUBSYSTEM_MIXER)
+        wp_core_load_component(priv->core, "libwireplumber-module-mixer-api", "module", NULL,
+                               "mixer-api", NULL, (GAsyncReadyCallback)astal_wp_wp_plugin_loaded,
+                               self);
+}
+
+static void astal_wp_wp_constructed(GObject *object) {
+    AstalWpWp *self = ASTAL_WP_WP(object);
+    AstalWpWpPrivate *priv = astal_wp_wp_get_instance_private(self);
+
+    if (self->subsystems & (ASTAL_WP_SUBSYSTEM_AUDIO_ENDPOINTS | ASTAL_WP_SUBSYSTEM_AUDIO_STREAMS))
+        self->audio = astal_wp_audio_new(self);
+    if (self->subsystems & ASTAL_WP_SUBSYSTEM_VIDEO) self->video = astal_wp_video_new(self);
 
-    priv->pending_plugins = 2;
-    wp_core_load_component(priv->core, "libwireplumber-module-default-nodes-api", "module", NULL,
-                           "default-nodes-api", NULL,
-                           (GAsyncReadyCallback)astal_wp_wp_plugin_loaded, self);
-    wp_core_load_component(priv->core, "libwireplumber-module-mixer-api", "module", NULL,
-                           "mixer-api", NULL, (GAsyncReadyCallback)astal_wp_wp_plugin_loaded, self);
+    // proxies and the core pick up the thread-default context when they are created
+    g_main_context_push_thread_default(priv->context);
+
+    switch (self->backend) {
+        case ASTAL_WP_BACKEND_PIPEWIRE:
+            astal_wp_wp_connect_pipewire(self);
+            break;
+        case ASTAL_WP_BACKEND_DBUS:
+            astal_wp_endpoint_init_remote(self->default_speaker, self, TRUE);
+            astal_wp_endpoint_init_remote(self->default_microphone, self, TRUE);
+            priv->mirror = astal_wp_mirror_new(self);
+            break;
+        case ASTAL_WP_BACKEND_THREADED:
+            astal_wp_endpoint_init_remote(self->default_speaker, self, TRUE);
+            astal_wp_endpoint_init_remote(self->default_microphone, self, TRUE);
+            priv->worker = astal_wp_worker_new(self);
+            break;
+        case ASTAL_WP_BACKEND_REPLAY: {
+            if (self->journal == NULL) {
+                g_critical("no journal to replay");
+                break;
+            }
+
+            // the types of the params are registered by wp_init
+            astal_wp_wp_init_wireplumber();
+
+            // the recorded initial state is announced as one batch which ends with ready
+            priv->hold_batch = TRUE;
+
+            GError *error = NULL;
+            priv->replay = astal_wp_replay_new(self, self->journal, self->replay_speed, &error);
+            if (error != NULL) {
+                g_critical("could not replay journal: %s", error->message);
+                g_error_free(error);
+            }
+            break;
+        }
+    }
+
+    g_main_context_pop_thread_default(priv->context);
 }
 
 static void astal_wp_wp_class_init(AstalWpWpClass *class) {
     GObjectClass *object_class = G_OBJECT_CLASS(class);
     object_class->finalize = astal_wp_wp_finalize;
     object_class->dispose = astal_wp_wp_dispose;
+    object_class->constructed = astal_wp_wp_constructed;
     object_class->get_property = astal_wp_wp_get_property;
     object_class->set_property = astal_wp_wp_set_property;
 
@@ -454,6 +2719,129 @@ static void astal_wp_wp_class_init(AstalWpWpClass *class) {
         g_param_spec_enum("scale", "scale", "scale", ASTAL_WP_TYPE_SCALE, ASTAL_WP_SCALE_CUBIC,
                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
 
+    /**
+     * AstalWpWp:profiler-enabled
+     *
+     * Whether the PipeWire profiler is bound and driver statistics are collected.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_PROFILER_ENABLED] =
+        g_param_spec_boolean("profiler-enabled", "profiler-enabled", "profiler-enabled", FALSE,
+                             G_PARAM_READWRITE);
+
+    /**
+     * AstalWpWp:shared-state
+     *
+     * Whether the endpoint state is published in a shared memory table for other processes.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_SHARED_STATE] = g_param_spec_boolean(
+        "shared-state", "shared-state", "shared-state", FALSE, G_PARAM_READWRITE);
+
+    /**
+     * AstalWpWp:journal: (nullable)
+     *
+     * The journal replayed by ASTAL_WP_BACKEND_REPLAY.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_JOURNAL] = g_param_spec_string(
+        "journal", "journal", "journal", NULL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    /**
+     * AstalWpWp:replay-speed
+     *
+     * The factor the timing of a replayed journal is scaled by, 0 replays as fast as possible.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_REPLAY_SPEED] =
+        g_param_spec_double("replay-speed", "replay-speed", "replay-speed", 0, G_MAXDOUBLE, 1,
+                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+    /**
+     * AstalWpWp:lazy-streams
+     *
+     * Whether the AstalWpEndpoint of an audio or video stream is only created once it is
+     * requested. Until then only the node is kept and no signals are emitted for it. Streams are
+     * created right away while anyone is connected to endpoint-added or endpoint-removed of this
+     * object, or to the stream and recorder signals of AstalWpAudio or AstalWpVideo, or to the
+     * notify signal of the endpoints, streams or recorders properties. Handlers connected while
+     * streams are pending are picked up at the next change of the graph. Getting the endpoint
+     * list, an endpoint by id, a client or the streams and recorders creates the pending streams.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_LAZY_STREAMS] =
+        g_param_spec_boolean("lazy-streams", "lazy-streams", "lazy-streams", FALSE,
+                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    /**
+     * AstalWpWp:subsystems: (type AstalWpSubsystems)
+     *
+     * The parts of the graph this instance tracks. Only the objects of the selected subsystems
+     * are requested from PipeWire, the mixer and default nodes plugins are only loaded when
+     * selected and AstalWpWp:audio and AstalWpWp:video are NULL unless audio or video is
+     * selected. Instances mirroring another process only use it for the latter.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_SUBSYSTEMS] =
+        g_param_spec_flags("subsystems", "subsystems", "subsystems", ASTAL_WP_TYPE_SUBSYSTEMS,
+                           ASTAL_WP_SUBSYSTEM_ALL, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    /**
+     * AstalWpWp:remote: (nullable)
+     *
+     * The name or socket path of the PipeWire remote to connect to, NULL for the default remote.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_REMOTE] =
+        g_param_spec_string("remote", "remote", "remote", NULL,
+                            G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    /**
+     * AstalWpWp:main-context: (nullable)
+     *
+     * The main context every source of this instance is attached to, NULL for the global default
+     * context.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_MAIN_CONTEXT] =
+        g_param_spec_boxed("main-context", "main-context", "main-context", G_TYPE_MAIN_CONTEXT,
+                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    /**
+     * AstalWpWp:optimistic
+     *
+     * Whether setters apply their change locally before PipeWire confirms it, see
+     * astal_wp_wp_set_optimistic.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_OPTIMISTIC] = g_param_spec_boolean(
+        "optimistic", "optimistic", "optimistic", FALSE, G_PARAM_READWRITE);
+    /**
+     * AstalWpWp:stall-threshold
+     *
+     * The time in milliseconds after which a synchronous call into PipeWire or WirePlumber is
+     * logged as a warning and kept, see astal_wp_wp_get_stalls. 0 disables the watchdog.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_STALL_THRESHOLD] =
+        g_param_spec_uint("stall-threshold", "stall-threshold", "stall-threshold", 0, G_MAXUINT,
+                          ASTAL_WP_WATCHDOG_THRESHOLD_MS, G_PARAM_READWRITE);
+
+    /**
+     * AstalWpWp:backend: (type AstalWpBackend)
+     *
+     * How this instance obtains its state, see AstalWpBackend.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_BACKEND] =
+        g_param_spec_enum("backend", "backend", "backend", ASTAL_WP_TYPE_BACKEND,
+                          ASTAL_WP_BACKEND_PIPEWIRE, G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    /**
+     * AstalWpWp:force-quantum
+     *
+     * The quantum forced through clock.force-quantum in the settings metadata, or 0.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_FORCE_QUANTUM] = g_param_spec_uint(
+        "force-quantum", "force-quantum", "force-quantum", 0, G_MAXUINT, 0, G_PARAM_READWRITE);
+    /**
+     * AstalWpWp:force-rate
+     *
+     * The sample rate forced through clock.force-rate in the settings metadata, or 0.
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_FORCE_RATE] = g_param_spec_uint(
+        "force-rate", "force-rate", "force-rate", 0, G_MAXUINT, 0, G_PARAM_READWRITE);
+    /**
+     * AstalWpWp:allowed-rates
+     *
+     * The value of clock.allowed-rates in the settings metadata, e.g. "[ 44100 48000 ]".
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_ALLOWED_RATES] = g_param_spec_string(
+        "allowed-rates", "allowed-rates", "allowed-rates", NULL, G_PARAM_READWRITE);
+
     /**
      * AstalWpWp:endpoints: (type GList(AstalWpEndpoint)) (transfer container)
      *
@@ -468,6 +2856,13 @@ static void astal_wp_wp_class_init(AstalWpWpClass *class) {
      */
     astal_wp_wp_properties[ASTAL_WP_WP_PROP_DEVICES] =
         g_param_spec_pointer("devices", "devices", "devices", G_PARAM_READABLE);
+    /**
+     * AstalWpWp:clients: (type GList(AstalWpClient)) (transfer container)
+     *
+     * A list of AstalWpClient objects
+     */
+    astal_wp_wp_properties[ASTAL_WP_WP_PROP_CLIENTS] =
+        g_param_spec_pointer("clients", "clients", "clients", G_PARAM_READABLE);
     /**
      * AstalWpWp:default-speaker:
      *
@@ -500,4 +2895,70 @@ static void astal_wp_wp_class_init(AstalWpWpClass *class) {
     astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_DEVICE_REMOVED] =
         g_signal_new("device-removed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
                      NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_DEVICE);
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_CLIENT_ADDED] =
+        g_signal_new("client-added", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_CLIENT);
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_CLIENT_REMOVED] =
+        g_signal_new("client-removed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL,
+                     NULL, NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_CLIENT);
+    /**
+     * AstalWpWp::driver-stats:
+     * @stats: the statistics of the driver
+     *
+     * Emitted at most every 250ms per driver while the profiler is enabled. The dsp load is the
+     * peak of the interval.
+     */
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_DRIVER_STATS] =
+        g_signal_new("driver-stats", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 1,
+                     ASTAL_WP_TYPE_DRIVER_STATS | G_SIGNAL_TYPE_STATIC_SCOPE);
+    /**
+     * AstalWpWp::ready:
+     *
+     * Emitted once every object that existed when connecting to PipeWire has been added.
+     */
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_READY] =
+        g_signal_new("ready", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL,
+                     G_TYPE_NONE, 0);
+    /**
+     * AstalWpWp::batch-begin:
+     *
+     * Emitted before the first object of a batch is added or removed. Objects added or removed
+     * within one main loop iteration, and every object that exists when connecting, form one
+     * batch. The endpoint-added and similar signals are still emitted per object, while the
+     * notifies of the collection properties of this object, AstalWpAudio and AstalWpVideo, like
+     * endpoints or speakers, are held back until the batch ends. Every other property is notified
+     * right away. Every batch-begin is followed by exactly one batch-end.
+     */
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_BATCH_BEGIN] =
+        g_signal_new("batch-begin", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 0);
+    /**
+     * AstalWpWp::batch-end:
+     *
+     * Emitted after the held back notifies of a batch, see batch-begin.
+     */
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_BATCH_END] =
+        g_signal_new("batch-end", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 0);
+    /**
+     * AstalWpWp::replay-finished:
+     *
+     * Emitted once every event of the journal has been replayed, see ASTAL_WP_BACKEND_REPLAY.
+     */
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_REPLAY_FINISHED] =
+        g_signal_new("replay-finished", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL,
+                     NULL, NULL, G_TYPE_NONE, 0);
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_LINK_ADDED] =
+        g_signal_new("link-added", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_LINK);
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_LINK_REMOVED] =
+        g_signal_new("link-removed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_LINK);
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_PORT_ADDED] =
+        g_signal_new("port-added", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_PORT);
+    astal_wp_wp_signals[ASTAL_WP_WP_SIGNAL_PORT_REMOVED] =
+        g_signal_new("port-removed", G_TYPE_FROM_CLASS(class), G_SIGNAL_RUN_FIRST, 0, NULL, NULL,
+                     NULL, G_TYPE_NONE, 1, ASTAL_WP_TYPE_PORT);
 }
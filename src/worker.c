@@ -0,0 +1,327 @@
+#include "device-private.h"
+#include "endpoint-private.h"
+#include "journal-private.h"
+#include "service-private.h"
+#include "worker-private.h"
+#include "wp-private.h"
+#include "wp.h"
+
+// Runs an AstalWpWp connected to PipeWire on a thread of its own and mirrors it into the
+// AstalWpWp of the consumer. Changes are collected on the worker thread once per iteration of its
+// context and handed over in batches of journal records, which the consumer applies through the
+// astal_wp_wp_mirror_* functions like a replay does. Setters travel the other way as the methods
+// of the D-Bus service, pushed onto a lock-free stack which the worker drains in order.
+
+typedef struct _AstalWpWorkerCommand AstalWpWorkerCommand;
+
+struct _AstalWpWorkerCommand {
+    AstalWpWorkerCommand *next;
+    gchar *method;
+    GVariant *args;
+};
+
+typedef struct {
+    AstalWpJournalRecordType type;
+    GVariant *value;
+} AstalWpWorkerEvent;
+
+struct _AstalWpWorker {
+    // the instance of the consumer
+    AstalWpWp *wp;
+
+    GThread *thread;
+    GMainContext *context;
+    gint quit;
+
+    // only touched by the worker thread
+    AstalWpWp *core;
+    GPtrArray *events;
+    // id -> object changed since the last flush
+    GHashTable *dirty_endpoints;
+    GHashTable *dirty_devices;
+    gboolean dirty_defaults;
+    guint flush_id;
+
+    // commands pushed by any thread, newest first
+    AstalWpWorkerCommand *commands;
+
+    // batches waiting for the consumer
+    GMutex lock;
+    GPtrArray *batches;
+    guint deliver_id;
+};
+
+static void astal_wp_worker_event_free(AstalWpWorkerEvent *event) {
+    g_variant_unref(event->value);
+    g_free(event);
+}
+
+static void astal_wp_worker_command_free(AstalWpWorkerCommand *command) {
+    g_free(command->method);
+    g_variant_unref(command->args);
+    g_free(command);
+}
+
+static GPtrArray *astal_wp_worker_batch_new(void) {
+    return g_ptr_array_new_with_free_func((GDestroyNotify)astal_wp_worker_event_free);
+}
+
+// consumer thread
+
+static gboolean astal_wp_worker_deliver(AstalWpWorker *self) {
+    g_mutex_lock(&self->lock);
+    GPtrArray *batches = self->batches;
+    self->batches = g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+    self->deliver_id = 0;
+    g_mutex_unlock(&self->lock);
+
+    for (guint i = 0; i < batches->len; i++) {
+        GPtrArray *batch = g_ptr_array_index(batches, i);
+        for (guint j = 0; j < batch->len; j++) {
+            AstalWpWorkerEvent *event = g_ptr_array_index(batch, j);
+            astal_wp_journal_apply(self->wp, event->type, event->value);
+        }
+    }
+
+    g_ptr_array_unref(batches);
+    return G_SOURCE_REMOVE;
+}
+
+// worker thread
+
+static void astal_wp_worker_record(AstalWpWorker *self, AstalWpJournalRecordType type,
+                                   GVariant *value) {
+    AstalWpWorkerEvent *event = g_new0(AstalWpWorkerEvent, 1);
+    event->type = type;
+    event->value = g_variant_ref_sink(value);
+    g_ptr_array_add(self->events, event);
+}
+
+static gboolean astal_wp_worker_flush(AstalWpWorker *self) {
+    GHashTableIter iter;
+    gpointer key, value;
+    self->flush_id = 0;
+
+    g_hash_table_iter_init(&iter, self->dirty_endpoints);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        astal_wp_worker_record(self, ASTAL_WP_JOURNAL_ENDPOINT_CHANGED,
+                               g_variant_new("(u@a{sv})", GPOINTER_TO_UINT(key),
+                                             astal_wp_endpoint_serialize(value)));
+    }
+    g_hash_table_remove_all(self->dirty_endpoints);
+
+    g_hash_table_iter_init(&iter, self->dirty_devices);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        astal_wp_worker_record(self, ASTAL_WP_JOURNAL_DEVICE_CHANGED,
+                               g_variant_new("(u@a{sv})", GPOINTER_TO_UINT(key),
+                                             astal_wp_device_serialize(value)));
+    }
+    g_hash_table_remove_all(self->dirty_devices);
+
+    if (self->dirty_defaults) {
+        astal_wp_worker_record(self, ASTAL_WP_JOURNAL_DEFAULTS,
+                               astal_wp_journal_defaults(self->core));
+        self->dirty_defaults = FALSE;
+    }
+
+    if (self->events->len == 0) return G_SOURCE_REMOVE;
+
+    g_mutex_lock(&self->lock);
+    g_ptr_array_add(self->batches, self->events);
+    if (self->deliver_id == 0)
+        self->deliver_id = astal_wp_wp_idle_add(self->wp, G_PRIORITY_DEFAULT,
+                                                (GSourceFunc)astal_wp_worker_deliver, self);
+    g_mutex_unlock(&self->lock);
+
+    self->events = astal_wp_worker_batch_new();
+    return G_SOURCE_REMOVE;
+}
+
+static void astal_wp_worker_queue(AstalWpWorker *self) {
+    if (self->flush_id == 0)
+        self->flush_id = astal_wp_wp_idle_add(self->core, G_PRIORITY_DEFAULT_IDLE,
+                                              (GSourceFunc)astal_wp_worker_flush, self);
+}
+
+static void astal_wp_worker_endpoint_notify(AstalWpEndpoint *endpoint, GParamSpec *pspec,
+                                            AstalWpWorker *self) {
+    g_hash_table_insert(self->dirty_endpoints,
+                        GUINT_TO_POINTER(astal_wp_endpoint_get_id(endpoint)), endpoint);
+    astal_wp_worker_queue(self);
+}
+
+static void astal_wp_worker_device_notify(AstalWpDevice *device, GParamSpec *pspec,
+                                          AstalWpWorker *self) {
+    g_hash_table_insert(self->dirty_devices, GUINT_TO_POINTER(astal_wp_device_get_id(device)),
+                        device);
+    astal_wp_worker_queue(self);
+}
+
+static void astal_wp_worker_endpoint_added(AstalWpWorker *self, AstalWpEndpoint *endpoint) {
+    g_signal_connect(endpoint, "notify", G_CALLBACK(astal_wp_worker_endpoint_notify), self);
+    astal_wp_worker_record(self, ASTAL_WP_JOURNAL_ENDPOINT_ADDED,
+                           astal_wp_endpoint_serialize(endpoint));
+    astal_wp_worker_queue(self);
+}
+
+static void astal_wp_worker_endpoint_removed(AstalWpWorker *self, AstalWpEndpoint *endpoint) {
+    guint id = astal_wp_endpoint_get_id(endpoint);
+    g_signal_handlers_disconnect_by_data(endpoint, self);
+    g_hash_table_remove(self->dirty_endpoints, GUINT_TO_POINTER(id));
+    astal_wp_worker_record(self, ASTAL_WP_JOURNAL_ENDPOINT_REMOVED, g_variant_new_uint32(id));
+    astal_wp_worker_queue(self);
+}
+
+static void astal_wp_worker_device_added(AstalWpWorker *self, AstalWpDevice *device) {
+    g_signal_connect(device, "notify", G_CALLBACK(astal_wp_worker_device_notify), self);
+    astal_wp_worker_record(self, ASTAL_WP_JOURNAL_DEVICE_ADDED, astal_wp_device_serialize(device));
+    astal_wp_worker_queue(self);
+}
+
+static void astal_wp_worker_device_removed(AstalWpWorker *self, AstalWpDevice *device) {
+    guint id = astal_wp_device_get_id(device);
+    g_signal_handlers_disconnect_by_data(device, self);
+    g_hash_table_remove(self->dirty_devices, GUINT_TO_POINTER(id));
+    astal_wp_worker_record(self, ASTAL_WP_JOURNAL_DEVICE_REMOVED, g_variant_new_uint32(id));
+    astal_wp_worker_queue(self);
+}
+
+static void astal_wp_worker_default_changed(AstalWpWorker *self) {
+    self->dirty_defaults = TRUE;
+    astal_wp_worker_queue(self);
+}
+
+static gboolean astal_wp_worker_run_commands(AstalWpWorker *self) {
+    AstalWpWorkerCommand *list = __atomic_exchange_n(&self->commands, NULL, __ATOMIC_ACQUIRE);
+
+    // the stack is newest first, commands are run in the order they were pushed
+    AstalWpWorkerCommand *ordered = NULL;
+    while (list != NULL) {
+        AstalWpWorkerCommand *next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    while (ordered != NULL) {
+        AstalWpWorkerCommand *next = ordered->next;
+
+        GError *error = NULL;
+        if (!astal_wp_service_run_command(self->core, ordered->method, ordered->args, &error)) {
+            g_warning("could not run %s: %s", ordered->method, error->message);
+            g_error_free(error);
+        }
+
+        astal_wp_worker_command_free(ordered);
+        ordered = next;
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer astal_wp_worker_main(AstalWpWorker *self) {
+    g_main_context_push_thread_default(self->context);
+
+    self->core = g_object_new(ASTAL_WP_TYPE_WP, "backend", ASTAL_WP_BACKEND_PIPEWIRE, "remote",
+                              astal_wp_wp_get_remote(self->wp), "main-context", self->context,
+                              "subsystems", astal_wp_wp_get_subsystems(self->wp), NULL);
+    self->events = astal_wp_worker_batch_new();
+    self->dirty_endpoints = g_hash_table_new(g_direct_hash, g_direct_equal);
+    self->dirty_devices = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    // objects only show up once the object manager is installed, which happens in a later
+    // iteration, so the added signals deliver the initial state
+    g_signal_connect_swapped(self->core, "endpoint-added",
+                             G_CALLBACK(astal_wp_worker_endpoint_added), self);
+    g_signal_connect_swapped(self->core, "endpoint-removed",
+                             G_CALLBACK(astal_wp_worker_endpoint_removed), self);
+    g_signal_connect_swapped(self->core, "device-added", G_CALLBACK(astal_wp_worker_device_added),
+                             self);
+    g_signal_connect_swapped(self->core, "device-removed",
+                             G_CALLBACK(astal_wp_worker_device_removed), self);
+    g_signal_connect_swapped(astal_wp_wp_get_default_speaker(self->core), "notify::id",
+                             G_CALLBACK(astal_wp_worker_default_changed), self);
+    g_signal_connect_swapped(astal_wp_wp_get_default_microphone(self->core), "notify::id",
+                             G_CALLBACK(astal_wp_worker_default_changed), self);
+
+    while (!g_atomic_int_get(&self->quit)) g_main_context_iteration(self->context, TRUE);
+
+    astal_wp_wp_clear_source(self->core, &self->flush_id);
+    g_signal_handlers_disconnect_by_data(self->core, self);
+    g_signal_handlers_disconnect_by_data(astal_wp_wp_get_default_speaker(self->core), self);
+    g_signal_handlers_disconnect_by_data(astal_wp_wp_get_default_microphone(self->core), self);
+
+    GList *list = astal_wp_wp_peek_endpoints(self->core);
+    for (GList *l = list; l != NULL; l = l->next)
+        g_signal_handlers_disconnect_by_data(l->data, self);
+    g_list_free(list);
+
+    list = astal_wp_wp_get_devices(self->core);
+    for (GList *l = list; l != NULL; l = l->next)
+        g_signal_handlers_disconnect_by_data(l->data, self);
+    g_list_free(list);
+
+    g_clear_object(&self->core);
+    g_ptr_array_unref(self->events);
+    g_hash_table_destroy(self->dirty_endpoints);
+    g_hash_table_destroy(self->dirty_devices);
+
+    g_main_context_pop_thread_default(self->context);
+    return NULL;
+}
+
+// any thread
+
+void astal_wp_worker_call(AstalWpWorker *self, const gchar *method, GVariant *args) {
+    AstalWpWorkerCommand *command = g_new0(AstalWpWorkerCommand, 1);
+    command->method = g_strdup(method);
+    command->args = g_variant_ref_sink(args);
+
+    AstalWpWorkerCommand *head = __atomic_load_n(&self->commands, __ATOMIC_RELAXED);
+    do {
+        command->next = head;
+    } while (!__atomic_compare_exchange_n(&self->commands, &head, command, TRUE,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    // only the push onto an empty stack has to wake the worker, the others are drained with it
+    if (head == NULL) {
+        GSource *source = g_idle_source_new();
+        g_source_set_priority(source, G_PRIORITY_DEFAULT);
+        g_source_set_callback(source, (GSourceFunc)astal_wp_worker_run_commands, self, NULL);
+        g_source_attach(source, self->context);
+        g_source_unref(source);
+    }
+}
+
+AstalWpWorker *astal_wp_worker_new(AstalWpWp *wp) {
+    AstalWpWorker *self = g_new0(AstalWpWorker, 1);
+    self->wp = wp;
+    self->context = g_main_context_new();
+    self->batches = g_ptr_array_new_with_free_func((GDestroyNotify)g_ptr_array_unref);
+    g_mutex_init(&self->lock);
+
+    self->thread = g_thread_new("astal-wp", (GThreadFunc)astal_wp_worker_main, self);
+    return self;
+}
+
+void astal_wp_worker_free(AstalWpWorker *self) {
+    if (self == NULL) return;
+
+    g_atomic_int_set(&self->quit, TRUE);
+    g_main_context_wakeup(self->context);
+    g_thread_join(self->thread);
+
+    // the worker is gone, nothing is pushed anymore
+    AstalWpWorkerCommand *list = __atomic_exchange_n(&self->commands, NULL, __ATOMIC_ACQUIRE);
+    while (list != NULL) {
+        AstalWpWorkerCommand *next = list->next;
+        astal_wp_worker_command_free(list);
+        list = next;
+    }
+
+    astal_wp_wp_clear_source(self->wp, &self->deliver_id);
+    g_ptr_array_unref(self->batches);
+    g_mutex_clear(&self->lock);
+    g_main_context_unref(self->context);
+    g_free(self);
+}